@@ -2112,12 +2112,60 @@ struct PerformanceData {
   int64_t graphicsMemory;
 };
 
+/**
+ * The statistics of the process-wide File intern cache.
+ */
+class PAG_API FileCacheStats {
+ public:
+  /**
+   * The number of loads that returned an interned File without decoding.
+   */
+  size_t hitCount = 0;
+  /**
+   * The number of loads that had to decode the file data.
+   */
+  size_t missCount = 0;
+  /**
+   * The number of Files currently interned.
+   */
+  size_t fileCount = 0;
+  /**
+   * The total size in bytes of the encoded data of the interned Files.
+   */
+  size_t totalBytes = 0;
+};
+
 class PAG_API File {
  public:
   /**
    * The maximum tag level current SDK supports.
    */
   static uint16_t MaxSupportedTagLevel();
+
+  /**
+   * Returns the maximum size in bytes of the encoded data that the process-wide intern cache can
+   * hold. Loading the same data (or the same unmodified file path) again returns the interned File
+   * directly instead of decoding it. The least recently loaded Files are dropped once the limit is
+   * exceeded. The default value is 0, which means the intern cache is disabled.
+   */
+  static size_t MaxCacheSize();
+
+  /**
+   * Sets the maximum size in bytes of the encoded data that the intern cache can hold. Set it to 0
+   * to disable the intern cache.
+   */
+  static void SetMaxCacheSize(size_t maxSize);
+
+  /**
+   * Returns the statistics of the intern cache.
+   */
+  static FileCacheStats CacheStats();
+
+  /**
+   * Drops all the Files in the intern cache. The Files that are still in use are not affected.
+   */
+  static void PurgeCache();
+
   /**
    *  Load a pag file from byte data, return null if the bytes is empty or it's not a valid pag
    * file.
@@ -2126,9 +2174,10 @@ class PAG_API File {
                                     const std::string& filePath = "");
   /**
    *  Load a pag file from path, return null if the file does not exist or the data is not a pag
-   * file.
+   * file. Files loaded in different decoding modes are cached separately.
    */
-  static std::shared_ptr<File> Load(const std::string& filePath);
+  static std::shared_ptr<File> Load(const std::string& filePath,
+                                    DecodingMode mode = DecodingMode::Copy);
 
   ~File();
 
@@ -2209,6 +2258,9 @@ class PAG_API File {
   std::vector<pag::ImageBytes*> images;
   std::vector<Composition*> compositions;
 
+  Cache* cache = nullptr;
+  std::mutex locker = {};
+
  private:
   PreComposeLayer* rootLayer = nullptr;
   Composition* mainComposition = nullptr;
@@ -2221,6 +2273,9 @@ class PAG_API File {
   // Just references, no need to delete them.
   std::vector<std::vector<ImageLayer*>> imageLayers = {};
 
+  // The file data kept in DecodingMode::Reference, the images and sequences refer to it.
+  std::unique_ptr<ByteData> fileData = nullptr;
+
   File(std::vector<Composition*> compositionList, std::vector<pag::ImageBytes*> imageList);
   void updateEditables(Composition* composition);
 
@@ -2285,5 +2340,12 @@ class PAG_API Codec {
    */
   static std::shared_ptr<PerformanceData> ReadPerformanceData(const void* bytes,
                                                               uint32_t byteLength);
+
+ private:
+  static std::shared_ptr<File> DecodeFile(const void* bytes, uint32_t byteLength,
+                                          const std::string& path,
+                                          std::unique_ptr<ByteData> fileData);
+
+  friend class FileDecoder;
 };
 }  // namespace pag
@@ -30,6 +30,7 @@ class Context;
 class Surface;
 class Device;
 class Image;
+class ReadbackBuffer;
 }  // namespace tgfx
 
 namespace pag {
@@ -502,6 +503,10 @@ class PAG_API PAGLayer : public Content {
   friend class FileReporter;
 
   friend class PAGImageLayer;
+
+  friend class DamageTracker;
+
+  friend class ContentPrefetcher;
 };
 
 class SolidLayer;
@@ -964,6 +969,10 @@ class PAG_API PAGComposition : public PAGLayer {
   friend class PAGImageLayer;
 
   friend class FileReporter;
+
+  friend class DamageTracker;
+
+  friend class ContentPrefetcher;
 };
 
 class PAG_API PAGFile : public PAGComposition {
@@ -980,9 +989,11 @@ class PAG_API PAGFile : public PAGComposition {
                                        const std::string& filePath = "");
   /**
    *  Load a pag file from path, return null if the file does not exist or the data is not a pag
-   * file.
+   * file. Passing DecodingMode::Reference keeps the data read from the path, the images and bitmap
+   * sequences of the file refer to it instead of being copied.
    */
-  static std::shared_ptr<PAGFile> Load(const std::string& filePath);
+  static std::shared_ptr<PAGFile> Load(const std::string& filePath,
+                                       DecodingMode mode = DecodingMode::Copy);
 
   PAGFile(std::shared_ptr<File> file, PreComposeLayer* layer);
 
@@ -1059,6 +1070,24 @@ class PAG_API PAGFile : public PAGComposition {
    */
   std::shared_ptr<PAGFile> copyOriginal();
 
+  /**
+   * Returns the maximum memory (in bytes) that the per-frame caches of this file's contents can
+   * use before the least recently used frames are evicted. The budget is shared by all PAGFiles
+   * loaded from the same file data. The default value is 0, which means unlimited.
+   */
+  size_t maxFrameCacheMemory() const;
+
+  /**
+   * Set the maximum memory (in bytes) that the per-frame caches of this file's contents can use.
+   * The frames exceeding the new limit are evicted immediately. Set it to 0 to disable the limit.
+   */
+  void setMaxFrameCacheMemory(size_t maxMemory);
+
+  /**
+   * Returns the memory (in bytes) currently used by the per-frame caches of this file's contents.
+   */
+  size_t frameCacheMemoryUsage() const;
+
   bool isPAGFile() const override;
 
  protected:
@@ -1173,6 +1202,12 @@ class PAG_API PAGSurface {
    */
   static std::shared_ptr<PAGSurface> MakeOffscreen(int width, int height);
 
+  /**
+   * Finishes the pending readings scheduled by readPixelsAsync() and invokes their callbacks before
+   * the PAGSurface is destroyed.
+   */
+  ~PAGSurface();
+
   /**
    * Returns the width in pixels of the surface.
    */
@@ -1205,22 +1240,50 @@ class PAG_API PAGSurface {
    */
   bool readPixels(ColorType colorType, AlphaType alphaType, void* dstPixels, size_t dstRowBytes);
 
+  /**
+   * Schedules copying pixels from current PAGSurface to dstPixels with specified color type, alpha
+   * type and row bytes, and returns immediately without waiting for the GPU to finish rendering.
+   * The pixels are copied into a GPU buffer first and transferred to dstPixels during a later call
+   * to readPixelsAsync() or finishReadPixels(), then the callback is invoked with the result. It
+   * allows the GPU to copy the pixels of the current frame while the next frame is being prepared.
+   * The dstPixels must stay valid until the callback is invoked. If the GPU does not support
+   * asynchronous reading, the pixels are copied synchronously and the callback is invoked before
+   * this method returns. The pending readings are also finished when the PAGSurface is destroyed.
+   * Returns false if the reading can not be scheduled, in which case the callback will never be
+   * invoked.
+   */
+  bool readPixelsAsync(ColorType colorType, AlphaType alphaType, void* dstPixels,
+                       size_t dstRowBytes, std::function<void(bool success)> callback);
+
+  /**
+   * Waits for all pending readings scheduled by readPixelsAsync() to finish and invokes their
+   * callbacks.
+   */
+  void finishReadPixels();
+
  private:
+  struct PendingReadback;
+
   uint32_t contentVersion = 0;
   PAGPlayer* pagPlayer = nullptr;
   std::shared_ptr<std::mutex> rootLocker = nullptr;
   std::shared_ptr<Drawable> drawable = nullptr;
   std::shared_ptr<tgfx::Device> device = nullptr;
   std::shared_ptr<tgfx::Surface> surface = nullptr;
+  std::vector<std::shared_ptr<PendingReadback>> pendingReadbacks = {};
+  std::vector<std::shared_ptr<tgfx::ReadbackBuffer>> idleReadbackBuffers = {};
 
   explicit PAGSurface(std::shared_ptr<Drawable> drawable);
 
   bool draw(RenderCache* cache, std::shared_ptr<Graphic> graphic, BackendSemaphore* signalSemaphore,
-            bool autoClear = true);
+            bool autoClear = true, const tgfx::Rect* dirtyRect = nullptr,
+            bool showDirtyRect = false);
   bool hitTest(RenderCache* cache, std::shared_ptr<Graphic> graphic, float x, float y);
   tgfx::Context* lockContext();
   void unlockContext();
   bool wait(const BackendSemaphore& waitSemaphore);
+  void finishReadbacks(bool waitAll, std::vector<std::function<void()>>* callbacks);
+  void releaseReadbacks(std::vector<std::function<void()>>* callbacks);
 
   friend class PAGPlayer;
 
@@ -1229,6 +1292,10 @@ class PAG_API PAGSurface {
 
 class FileReporter;
 
+class DamageTracker;
+
+class ContentPrefetcher;
+
 class PAG_API PAGPlayer {
  public:
   PAGPlayer();
@@ -1278,6 +1345,60 @@ class PAG_API PAGPlayer {
    */
   void setCacheEnabled(bool value);
 
+  /**
+   * If set to true, PAGPlayer shares the internal graphics caches of static content with other
+   * PAGPlayers that also enable it and render onto PAGSurfaces of the same GPU context. It saves
+   * both graphics memory and rasterization time when multiple PAGPlayers render the same PAGFile
+   * at the same time. The default value is false.
+   */
+  bool sharedCacheEnabled();
+
+  /**
+   * Set the value of sharedCacheEnabled property.
+   */
+  void setSharedCacheEnabled(bool value);
+
+  /**
+   * If set to true, PAGPlayer draws the text whose scale keeps changing from signed distance
+   * fields, which are generated once and serve all scales, instead of rasterizing the glyphs again
+   * as the scale changes. The text goes back to glyphs rasterized at its exact size once the scale
+   * stops changing. The edges of the distance field glyphs are slightly softer. The default value
+   * is false.
+   */
+  bool distanceFieldTextEnabled();
+
+  /**
+   * Set the value of distanceFieldTextEnabled property.
+   */
+  void setDistanceFieldTextEnabled(bool value);
+
+  /**
+   * If set to true, the Fast Blur effects and the Drop Shadow styles whose blurriness is large
+   * enough render part of their blur passes into downscaled buffers. It is much faster for large
+   * blurs, but the result is slightly different from the full-resolution one. Smaller blurs are not
+   * affected. The default value is false.
+   */
+  bool blurDownscaleEnabled();
+
+  /**
+   * Set the value of blurDownscaleEnabled property.
+   */
+  void setBlurDownscaleEnabled(bool value);
+
+  /**
+   * If set to true, PAGPlayer fills simple convex paths by triangulating them on the GPU instead of
+   * rasterizing them on the CPU and uploading the masks, which is faster for content with many
+   * paths, especially on software GPU backends. The antialiased edges are slightly different from
+   * the rasterized ones. Convex paths are always triangulated on render targets with MSAA. The
+   * default value is false.
+   */
+  bool pathTriangulationEnabled();
+
+  /**
+   * Set the value of pathTriangulationEnabled property.
+   */
+  void setPathTriangulationEnabled(bool value);
+
   /**
    * This value defines the scale factor for internal graphics caches, ranges from 0.0 to 1.0. The
    * scale factors less than 1.0 may result in blurred output, but it can reduce the usage of
@@ -1290,6 +1411,19 @@ class PAG_API PAGPlayer {
    */
   void setCacheScale(float value);
 
+  /**
+   * The maximum graphics memory in bytes for internal graphics caches. Once the limit is reached,
+   * the caches unused by the current frame are purged first, the ones taking the most memory but
+   * costing the least time to redraw go first, and then no more caches are created. The default
+   * value is 300MB.
+   */
+  size_t maxCacheMemory();
+
+  /**
+   * Set the value of maxCacheMemory property.
+   */
+  void setMaxCacheMemory(size_t bytes);
+
   /**
    * The maximum frame rate for rendering, ranges from 1 to 60. If set to a value less than the
    * actual frame rate from composition, it drops frames but increases performance. Otherwise, it
@@ -1363,6 +1497,44 @@ class PAG_API PAGPlayer {
    */
   void setAutoClear(bool value);
 
+  /**
+   * If true, PAGPlayer only redraws the regions of PAGSurface whose layers changed since the last
+   * flush, and leaves the rest of the previous content untouched. The default value is false.
+   */
+  bool partialRedrawEnabled();
+
+  /**
+   * Sets the partialRedrawEnabled property. Only enable it if the PAGSurface keeps its content
+   * after presenting, such as the offscreen surfaces and the surfaces made from a texture.
+   * Otherwise the unchanged regions may show stale content.
+   */
+  void setPartialRedrawEnabled(bool value);
+
+  /**
+   * If true, the regions redrawn by each flush are tinted with translucent red when
+   * partialRedrawEnabled is true. It is used for debugging only. The default value is false.
+   */
+  bool showDirtyRegions();
+
+  /**
+   * Sets the showDirtyRegions property.
+   */
+  void setShowDirtyRegions(bool value);
+
+  /**
+   * The number of upcoming frames whose contents are recorded on a worker thread while the current
+   * frame is being submitted to the GPU. It assumes the frames are played in order, and cuts the
+   * time of flush() for the upcoming frames on multi-core devices at the cost of extra CPU and
+   * memory usage. The value ranges from 0 to 4, and 0 disables the pipelining. The default value
+   * is 0.
+   */
+  int pipelineDepth();
+
+  /**
+   * Sets the pipelineDepth property.
+   */
+  void setPipelineDepth(int depth);
+
   /**
    * Inserts a GPU semaphore that the current GPU-backed API must wait on before executing any more
    * commands on the GPU for this player. It is usually called before PAGPlayer.flush(). PAG will
@@ -1446,6 +1618,11 @@ class PAG_API PAGPlayer {
    */
   int64_t graphicsMemory();
 
+  /**
+   * The number of GPU draw calls issued by the last flush.
+   */
+  int64_t drawCallCount();
+
  protected:
   std::shared_ptr<std::mutex> rootLocker = nullptr;
   std::shared_ptr<PAGStage> stage = nullptr;
@@ -1462,12 +1639,182 @@ class PAG_API PAGPlayer {
   float _maxFrameRate = 60;
   int _scaleMode = PAGScaleMode::LetterBox;
   bool _autoClear = true;
+  DamageTracker* damageTracker = nullptr;
+  bool _showDirtyRegions = false;
+  ContentPrefetcher* contentPrefetcher = nullptr;
 
   void updateStageSize();
   void setSurfaceInternal(std::shared_ptr<PAGSurface> newSurface);
   int64_t getTimeStampInternal();
 
   friend class PAGSurface;
+
+  friend class PAGDecoder;
+};
+
+/**
+ * PAGDecoder provides a convenient way to export the frames of a PAGComposition into raw pixel
+ * buffers, such as feeding them to a video encoder. Frames whose content is identical to the
+ * previously decoded frame are detected by the static time ranges of the layers, and neither
+ * rendered nor read back again. If no hardware video decoder is available, the video sequences are
+ * split into segments at keyframes and decoded in parallel by up to 4 software decoders.
+ */
+class PAG_API PAGDecoder {
+ public:
+  /**
+   * Creates a PAGDecoder with a PAGComposition, the output size and the frame rate. The content is
+   * scaled to fit the output size with PAGScaleMode::LetterBox. If the frameRate is not positive
+   * or greater than the frame rate of the composition, the frame rate of the composition is used.
+   * Note: the composition must not be added to any other PAGPlayer while it is being decoded.
+   * Returns nullptr if the composition is nullptr or the output size is not valid.
+   */
+  static std::shared_ptr<PAGDecoder> MakeFrom(std::shared_ptr<PAGComposition> composition,
+                                              int width, int height, float frameRate = 0);
+
+  ~PAGDecoder();
+
+  /**
+   * Returns the width of decoded frames.
+   */
+  int width() const {
+    return _width;
+  }
+
+  /**
+   * Returns the height of decoded frames.
+   */
+  int height() const {
+    return _height;
+  }
+
+  /**
+   * Returns the number of frames in the PAGDecoder. Note that the value may change if the
+   * composition was modified.
+   */
+  int numFrames();
+
+  /**
+   * Returns the frame rate of decoded frames.
+   */
+  float frameRate() const {
+    return _frameRate;
+  }
+
+  /**
+   * Returns true if the content of the frame at the specified index is different from the frame
+   * decoded by the last successful readFrame() call. Always returns true if no frame has been
+   * decoded yet.
+   */
+  bool checkFrameChanged(int index);
+
+  /**
+   * Copies the pixels of the frame at the specified index to dstPixels with specified color type,
+   * alpha type and row bytes. If the content of the frame is identical to the previously decoded
+   * frame, the rendering is skipped. The reading is also skipped if the same dstPixels, row bytes,
+   * color type and alpha type are passed in again, in which case the caller must keep the content
+   * of dstPixels unchanged between the two calls. Returns true if dstPixels holds the frame.
+   */
+  bool readFrame(int index, void* dstPixels, size_t dstRowBytes,
+                 ColorType colorType = ColorType::RGBA_8888,
+                 AlphaType alphaType = AlphaType::Premultiplied);
+
+ private:
+  std::mutex locker = {};
+  int _width = 0;
+  int _height = 0;
+  float _frameRate = 30.0f;
+  std::shared_ptr<PAGComposition> composition = nullptr;
+  std::shared_ptr<PAGSurface> pagSurface = nullptr;
+  PAGPlayer* pagPlayer = nullptr;
+  bool hasLastFrame = false;
+  uint32_t lastContentVersion = 0;
+  void* lastPixels = nullptr;
+  size_t lastRowBytes = 0;
+  ColorType lastColorType = ColorType::Unknown;
+  AlphaType lastAlphaType = AlphaType::Unknown;
+
+  PAGDecoder(std::shared_ptr<PAGComposition> composition, int width, int height, float frameRate);
+
+  int getNumFrames();
+  bool seekTo(int index);
+  void setVideoSegmentDecoders(int count);
+  void clearLastPixels();
+
+  friend class PAGParallelDecoder;
+};
+
+/**
+ * PAGParallelDecoder renders all frames of a PAGFile in parallel for offline exporting. The frame
+ * range is split into chunks of consecutive frames, which are distributed among several shards.
+ * Each shard renders on its own thread with a PAGDecoder, which holds an independent offscreen GPU
+ * context and a copy of the PAGFile created by PAGFile::copyOriginal(). The copies share the
+ * immutable File data and its frame caches, but any modifications to the original PAGFile, such as
+ * replaced texts and images, are not taken into account.
+ */
+class PAG_API PAGParallelDecoder {
+ public:
+  /**
+   * Creates a PAGParallelDecoder with a PAGFile, the output size and the frame rate. The frame rate
+   * follows the same rules as PAGDecoder::MakeFrom(). If numShards is not positive, the number of
+   * CPU cores is used. Returns nullptr if the pagFile is nullptr or the output size is not valid.
+   */
+  static std::shared_ptr<PAGParallelDecoder> MakeFrom(std::shared_ptr<PAGFile> pagFile, int width,
+                                                      int height, float frameRate = 0,
+                                                      int numShards = 0);
+
+  /**
+   * Returns the width of decoded frames.
+   */
+  int width() const {
+    return _width;
+  }
+
+  /**
+   * Returns the height of decoded frames.
+   */
+  int height() const {
+    return _height;
+  }
+
+  /**
+   * Returns the number of frames in the PAGParallelDecoder.
+   */
+  int numFrames() const {
+    return _numFrames;
+  }
+
+  /**
+   * Returns the frame rate of decoded frames.
+   */
+  float frameRate() const {
+    return _frameRate;
+  }
+
+  /**
+   * Returns the number of shards rendering in parallel.
+   */
+  int numShards() const {
+    return static_cast<int>(decoders.size());
+  }
+
+  /**
+   * Renders all frames in parallel and invokes the callback on the calling thread with the pixels
+   * of each frame in the order of frame index. The pixels are only valid during the callback.
+   * Rendering stops if the callback returns false. Returns true if all frames are rendered and
+   * delivered to the callback. Only one readFrames() call can run at a time.
+   */
+  bool readFrames(
+      const std::function<bool(int index, const void* pixels, size_t rowBytes)>& callback,
+      ColorType colorType = ColorType::RGBA_8888, AlphaType alphaType = AlphaType::Premultiplied);
+
+ private:
+  int _width = 0;
+  int _height = 0;
+  int _numFrames = 0;
+  float _frameRate = 30.0f;
+  std::vector<std::shared_ptr<PAGDecoder>> decoders = {};
+
+  PAGParallelDecoder() = default;
 };
 
 /**
@@ -1492,6 +1839,51 @@ class PAG_API PAGVideoDecoder {
    * decoding video sequences from a pag file, if hardware decoders are not available.
    */
   static void RegisterSoftwareDecoderFactory(SoftwareDecoderFactory* decoderFactory);
+
+  /**
+   * Sets the number of CPU cores each built-in software decoder uses to decode a frame, which is
+   * clamped to [1, 4]. The default value is 1. More cores reduce the decoding time of each frame,
+   * but compete with the other decoders running at the same time.
+   */
+  static void SetSoftwareDecoderCores(int count);
+
+  /**
+   * Sets the maximum number of idle built-in software decoders kept for reusing, which saves the
+   * initialization of decoders for videos of the same size. The default value is 2, 0 disables it.
+   */
+  static void SetMaxIdleSoftwareDecoderCount(int count);
+};
+
+/**
+ * PAGExecutor defines the interface to run the asynchronous works of PAG, such as decoding images,
+ * bitmap sequences and video sequences. Hosts can implement it to run those works on their own
+ * thread pools. If no executor is registered, PAG uses a built-in thread pool.
+ */
+class PAG_API PAGExecutor {
+ public:
+  /**
+   * Registers an executor to run all the asynchronous works of PAG from now on. Pass nullptr to
+   * restore the built-in thread pool. The threads of the built-in thread pool are not created
+   * until the first work is submitted to it, so registering an executor before loading any PAG
+   * file keeps PAG from creating any threads.
+   */
+  static void Register(std::shared_ptr<PAGExecutor> executor);
+
+  /**
+   * Sets the maximum number of threads of the built-in thread pool. The default value is the
+   * number of CPU cores, but no more than 16. It only takes effect if called before any PAG file
+   * is rendered.
+   */
+  static void SetMaxThreads(int count);
+
+  virtual ~PAGExecutor() = default;
+
+  /**
+   * Runs the work asynchronously. Implementations must invoke the work exactly once and must not
+   * invoke it synchronously inside this method. highPriority is true if the result of the work is
+   * needed by the frame about to be rendered, and false if it is a prediction for future frames.
+   */
+  virtual void execute(std::function<void()> work, bool highPriority) = 0;
 };
 
 class PAG_API PAG {
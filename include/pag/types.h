@@ -1571,4 +1571,24 @@ class PAG_API BlendMode {
   static const Enum Add = 16;
 };
 
+/**
+ * Defines how the encoded payloads (image bytes, bitmap sequences and audio) of a file are stored
+ * once the file is decoded.
+ */
+enum class DecodingMode {
+  /**
+   * The payloads are copied out of the file data while decoding, the file data can be released
+   * once the File is loaded.
+   */
+  Copy,
+  /**
+   * The File keeps the whole file data, and its payloads refer to it instead of being copied one
+   * by one, which shortens the loading of files with large images or bitmap sequences at the cost
+   * of keeping the parts of the file data that are no longer needed. Only the copies are skipped,
+   * the compositions and the headers of the payloads, such as the sizes of the images, are still
+   * decoded while loading. Video frames are always copied.
+   */
+  Reference
+};
+
 }  // namespace pag
@@ -117,18 +117,26 @@ int main() {
 
     printf("---currentFrame:%d, flushStatus:%d \n", currentFrame, status);
 
+    // The pixels are fetched while the next frame is being rendered, and written to the bmp file
+    // in the callback.
     auto data = new uint8_t[bytesLength];
-    pagSurface->readPixels(pag::ColorType::BGRA_8888, pag::AlphaType::Premultiplied, data,
-                           pagFile->width() * 4);
-
     std::string imageName = std::to_string(currentFrame);
-
-    BmpWrite(data, pagFile->width(), pagFile->height(), imageName.c_str());
-
-    delete[] data;
+    auto width = pagFile->width();
+    auto height = pagFile->height();
+    auto onPixelsRead = [=](bool success) {
+      if (success) {
+        BmpWrite(data, width, height, imageName.c_str());
+      }
+      delete[] data;
+    };
+    if (!pagSurface->readPixelsAsync(pag::ColorType::BGRA_8888, pag::AlphaType::Premultiplied,
+                                     data, width * 4, onPixelsRead)) {
+      delete[] data;
+    }
 
     currentFrame++;
   }
+  pagSurface->finishReadPixels();
 
   delete pagPlayer;
 
@@ -17,8 +17,11 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "pag/file.h"
+#include <sys/stat.h>
 #include <algorithm>
+#include <list>
 #include <unordered_map>
+#include "codec/FileDecoder.h"
 
 namespace pag {
 
@@ -54,32 +57,217 @@ static std::shared_ptr<File> FindFileByPath(const std::string& filePath) {
   return nullptr;
 }
 
-std::shared_ptr<File> File::Load(const std::string& filePath) {
-  auto byteData = ByteData::FromPath(filePath);
-  if (byteData == nullptr) {
+struct InternedFile {
+  std::shared_ptr<File> file = nullptr;
+  size_t size = 0;
+  std::string pathKey = "";
+  std::list<std::string>::iterator position;
+};
+
+struct FileStamp {
+  int64_t modifyTime = 0;
+  int64_t size = 0;
+  std::string key = "";
+};
+
+// The intern cache keeps strong references to the recently loaded Files. The Files are keyed by
+// the path, the decoding mode and the content hash of their data, the path is part of the key
+// because File::path is visible to users. Loading from a path also records the modification time
+// of the file, so that a unmodified file can be found without reading it again.
+static std::mutex cacheLocker = {};
+static size_t maxCacheSize = 0;
+static FileCacheStats cacheStats = {};
+static std::list<std::string> internedKeys = {};
+static std::unordered_map<std::string, InternedFile> internedFiles = {};
+static std::unordered_map<std::string, FileStamp> fileStamps = {};
+
+// Files decoded in different modes keep different data, so the mode is part of every cache key.
+static std::string MakePathKey(const std::string& filePath, DecodingMode mode) {
+  if (filePath.empty() || mode == DecodingMode::Copy) {
+    return filePath;
+  }
+  return filePath + ":reference";
+}
+
+static std::string MakeContentKey(const void* bytes, size_t length, const std::string& pathKey) {
+  // 64-bit FNV-1a.
+  uint64_t hash = 14695981039346656037ULL;
+  auto data = static_cast<const uint8_t*>(bytes);
+  for (size_t i = 0; i < length; i++) {
+    hash ^= data[i];
+    hash *= 1099511628211ULL;
+  }
+  return std::to_string(hash) + ":" + std::to_string(length) + ":" + pathKey;
+}
+
+static bool GetFileStamp(const std::string& filePath, FileStamp* stamp) {
+  struct stat fileInfo = {};
+  if (filePath.empty() || stat(filePath.c_str(), &fileInfo) != 0) {
+    return false;
+  }
+  stamp->modifyTime = static_cast<int64_t>(fileInfo.st_mtime);
+  stamp->size = static_cast<int64_t>(fileInfo.st_size);
+  return true;
+}
+
+static void RemoveInternedFile(std::unordered_map<std::string, InternedFile>::iterator result) {
+  auto stamp = fileStamps.find(result->second.pathKey);
+  if (stamp != fileStamps.end() && stamp->second.key == result->first) {
+    fileStamps.erase(stamp);
+  }
+  cacheStats.totalBytes -= result->second.size;
+  internedKeys.erase(result->second.position);
+  internedFiles.erase(result);
+}
+
+static std::shared_ptr<File> FindInternedFile(const std::string& key) {
+  auto result = internedFiles.find(key);
+  if (result == internedFiles.end()) {
     return nullptr;
   }
-  return pag::File::Load(byteData->data(), byteData->length(), filePath);
+  auto& interned = result->second;
+  internedKeys.splice(internedKeys.begin(), internedKeys, interned.position);
+  cacheStats.hitCount++;
+  return interned.file;
 }
 
-uint16_t File::MaxSupportedTagLevel() {
-  return Codec::MaxSupportedTagLevel();
+static void InternFile(const std::string& key, const std::string& pathKey,
+                       std::shared_ptr<File> file, size_t size) {
+  if (size > maxCacheSize || internedFiles.count(key) > 0) {
+    return;
+  }
+  while (!internedKeys.empty() && cacheStats.totalBytes + size > maxCacheSize) {
+    RemoveInternedFile(internedFiles.find(internedKeys.back()));
+  }
+  internedKeys.push_front(key);
+  internedFiles[key] = {std::move(file), size, pathKey, internedKeys.begin()};
+  cacheStats.totalBytes += size;
 }
 
-std::shared_ptr<File> File::Load(const void* bytes, size_t length, const std::string& filePath) {
-  auto file = FindFileByPath(filePath);
-  if (file != nullptr) {
-    return file;
+static void PurgeInternedFiles() {
+  internedKeys.clear();
+  internedFiles.clear();
+  fileStamps.clear();
+  cacheStats.totalBytes = 0;
+}
+
+size_t File::MaxCacheSize() {
+  std::lock_guard<std::mutex> autoLock(cacheLocker);
+  return maxCacheSize;
+}
+
+void File::SetMaxCacheSize(size_t maxSize) {
+  std::lock_guard<std::mutex> autoLock(cacheLocker);
+  maxCacheSize = maxSize;
+  while (!internedKeys.empty() && cacheStats.totalBytes > maxCacheSize) {
+    RemoveInternedFile(internedFiles.find(internedKeys.back()));
+  }
+  if (maxCacheSize == 0) {
+    fileStamps.clear();
+  }
+}
+
+FileCacheStats File::CacheStats() {
+  std::lock_guard<std::mutex> autoLock(cacheLocker);
+  auto stats = cacheStats;
+  stats.fileCount = internedFiles.size();
+  return stats;
+}
+
+void File::PurgeCache() {
+  std::lock_guard<std::mutex> autoLock(cacheLocker);
+  PurgeInternedFiles();
+}
+
+static std::shared_ptr<File> FindFileByStamp(const std::string& pathKey, const FileStamp& stamp) {
+  std::lock_guard<std::mutex> autoLock(cacheLocker);
+  auto result = fileStamps.find(pathKey);
+  if (result == fileStamps.end()) {
+    return nullptr;
+  }
+  auto& cached = result->second;
+  if (cached.modifyTime != stamp.modifyTime || cached.size != stamp.size) {
+    fileStamps.erase(result);
+    return nullptr;
   }
-  file = Codec::Decode(bytes, static_cast<uint32_t>(length), filePath);
-  if (file != nullptr) {
+  return FindInternedFile(cached.key);
+}
+
+// The byteData holds the bytes if they are read from the path, the File adopts it in the reference
+// mode. Loading from the bytes of the caller always copies the payloads.
+static std::shared_ptr<File> LoadFile(const void* bytes, size_t length, const std::string& filePath,
+                                      std::unique_ptr<ByteData> byteData, std::string* contentKey,
+                                      DecodingMode mode = DecodingMode::Copy) {
+  auto pathKey = MakePathKey(filePath, mode);
+  bool cacheEnabled = File::MaxCacheSize() > 0;
+  if (cacheEnabled) {
+    *contentKey = MakeContentKey(bytes, length, pathKey);
+    std::lock_guard<std::mutex> autoLock(cacheLocker);
+    auto file = FindInternedFile(*contentKey);
+    if (file != nullptr) {
+      return file;
+    }
+    cacheStats.missCount++;
+  }
+  auto file = FindFileByPath(pathKey);
+  if (file == nullptr) {
+    if (mode == DecodingMode::Reference) {
+      file = FileDecoder::Decode(std::move(byteData), filePath);
+    } else {
+      file = Codec::Decode(bytes, static_cast<uint32_t>(length), filePath);
+    }
+    if (file == nullptr) {
+      return nullptr;
+    }
     std::lock_guard<std::mutex> autoLock(globalLocker);
     std::weak_ptr<File> weak = file;
-    weakFileMap.insert(std::make_pair(filePath, std::move(weak)));
+    weakFileMap.insert(std::make_pair(pathKey, std::move(weak)));
+  }
+  if (cacheEnabled) {
+    std::lock_guard<std::mutex> autoLock(cacheLocker);
+    if (maxCacheSize > 0) {
+      InternFile(*contentKey, pathKey, file, length);
+    }
   }
   return file;
 }
 
+std::shared_ptr<File> File::Load(const std::string& filePath, DecodingMode mode) {
+  auto pathKey = MakePathKey(filePath, mode);
+  FileStamp stamp = {};
+  bool hasStamp = MaxCacheSize() > 0 && GetFileStamp(filePath, &stamp);
+  if (hasStamp) {
+    auto file = FindFileByStamp(pathKey, stamp);
+    if (file != nullptr) {
+      return file;
+    }
+  }
+  auto byteData = ByteData::FromPath(filePath);
+  if (byteData == nullptr) {
+    return nullptr;
+  }
+  auto bytes = byteData->data();
+  auto length = byteData->length();
+  // In the reference mode the File adopts the data read from the path, no extra copy is needed.
+  auto file = LoadFile(bytes, length, filePath, std::move(byteData), &stamp.key, mode);
+  if (file != nullptr && hasStamp && !stamp.key.empty()) {
+    std::lock_guard<std::mutex> autoLock(cacheLocker);
+    if (maxCacheSize > 0) {
+      fileStamps[pathKey] = stamp;
+    }
+  }
+  return file;
+}
+
+uint16_t File::MaxSupportedTagLevel() {
+  return Codec::MaxSupportedTagLevel();
+}
+
+std::shared_ptr<File> File::Load(const void* bytes, size_t length, const std::string& filePath) {
+  std::string contentKey = "";
+  return LoadFile(bytes, length, filePath, nullptr, &contentKey);
+}
+
 File::File(std::vector<Composition*> compositionList, std::vector<pag::ImageBytes*> imageList)
     : images(std::move(imageList)), compositions(std::move(compositionList)) {
   mainComposition = compositions.back();
@@ -109,6 +297,8 @@ File::~File() {
     delete imageBytes;
   }
   delete rootLayer;
+  // The caches of layers may refer to the file cache, so it must be deleted after them.
+  delete cache;
 }
 
 void File::updateEditables(Composition* composition) {
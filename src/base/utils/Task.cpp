@@ -19,7 +19,7 @@
 #ifndef PAG_BUILD_FOR_WEB
 
 #include "Task.h"
-#include <algorithm>
+#include "pag/pag.h"
 
 #ifdef __APPLE__
 
@@ -44,6 +44,12 @@ int GetCPUCores() {
   return cpuCores;
 }
 
+static int MaxThreads = 0;
+static std::mutex ExecutorLocker = {};
+static std::shared_ptr<PAGExecutor> HostExecutor = nullptr;
+// The index of the TaskQueue owned by current thread, -1 if current thread is not a worker.
+static thread_local int CurrentQueueIndex = -1;
+
 std::shared_ptr<Task> Task::Make(std::unique_ptr<Executor> executor) {
   return std::shared_ptr<Task>(new Task(std::move(executor)));
 }
@@ -56,12 +62,13 @@ Task::~Task() {
   cancel();
 }
 
-void Task::run() {
+void Task::run(TaskPriority taskPriority) {
   std::lock_guard<std::mutex> autoLock(locker);
   if (running) {
     return;
   }
   running = true;
+  priority = taskPriority;
   taskGroup->pushTask(this);
 }
 
@@ -98,27 +105,83 @@ void Task::execute() {
   condition.notify_all();
 }
 
+void TaskQueue::push(Task* task) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto& list = tasks[static_cast<int>(task->priority)];
+  task->position = list.insert(list.end(), task);
+  task->queue = this;
+  task->queued = true;
+}
+
+Task* TaskQueue::pop(TaskPriority priority) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto& list = tasks[static_cast<int>(priority)];
+  if (list.empty()) {
+    return nullptr;
+  }
+  auto task = list.front();
+  list.pop_front();
+  task->queued = false;
+  return task;
+}
+
+bool TaskQueue::remove(Task* task) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (!task->queued) {
+    return false;
+  }
+  tasks[static_cast<int>(task->priority)].erase(task->position);
+  task->queued = false;
+  return true;
+}
+
+void PAGExecutor::Register(std::shared_ptr<PAGExecutor> executor) {
+  TaskGroup::SetExecutor(std::move(executor));
+}
+
+void PAGExecutor::SetMaxThreads(int count) {
+  TaskGroup::SetMaxThreads(count);
+}
+
+void TaskGroup::SetMaxThreads(int count) {
+  MaxThreads = count;
+}
+
+void TaskGroup::SetExecutor(std::shared_ptr<PAGExecutor> executor) {
+  std::lock_guard<std::mutex> autoLock(ExecutorLocker);
+  HostExecutor = std::move(executor);
+}
+
 TaskGroup* TaskGroup::GetInstance() {
   static TaskGroup taskGroup = {};
   return &taskGroup;
 }
 
-void TaskGroup::RunLoop(TaskGroup* taskGroup) {
+void TaskGroup::RunLoop(TaskGroup* taskGroup, size_t index) {
+  CurrentQueueIndex = static_cast<int>(index);
   while (true) {
-    auto task = taskGroup->popTask();
-    if (!task) {
+    auto task = taskGroup->popTask(index);
+    if (task) {
+      task->execute();
+      continue;
+    }
+    if (!taskGroup->waitForTasks()) {
       break;
     }
-    task->execute();
   }
 }
 
 TaskGroup::TaskGroup() {
   static const int CPUCores = GetCPUCores();
-  auto maxThreads = CPUCores > 16 ? 16 : CPUCores;
-  activeThreads = maxThreads;
+  auto maxThreads = MaxThreads > 0 ? MaxThreads : (CPUCores > 16 ? 16 : CPUCores);
   for (int i = 0; i < maxThreads; i++) {
-    threads.emplace_back(&TaskGroup::RunLoop, this);
+    queues.push_back(new TaskQueue());
+  }
+}
+
+void TaskGroup::startThreads() {
+  for (size_t i = 0; i < queues.size(); i++) {
+    threads.emplace_back(&TaskGroup::RunLoop, this, i);
   }
 }
 
@@ -129,43 +192,92 @@ TaskGroup::~TaskGroup() {
       thread.join();
     }
   }
+  for (auto queue : queues) {
+    delete queue;
+  }
+}
+
+std::shared_ptr<PAGExecutor> TaskGroup::GetExecutor() {
+  std::lock_guard<std::mutex> autoLock(ExecutorLocker);
+  return HostExecutor;
+}
+
+void TaskGroup::runOneTask() {
+  auto task = popTask(nextQueue.fetch_add(1) % queues.size());
+  if (task != nullptr) {
+    task->execute();
+  }
 }
 
 void TaskGroup::pushTask(Task* task) {
-  std::lock_guard<std::mutex> autoLock(locker);
-  tasks.push_back(task);
-  condition.notify_one();
+  size_t index;
+  if (CurrentQueueIndex >= 0) {
+    index = static_cast<size_t>(CurrentQueueIndex);
+  } else {
+    index = nextQueue.fetch_add(1) % queues.size();
+  }
+  queues[index]->push(task);
+  pendingTasks++;
+  auto hostExecutor = GetExecutor();
+  if (hostExecutor != nullptr) {
+    // Each work runs one pending task rather than this specific one, so the task can still be
+    // cancelled in O(1) by removing it from the queue, and the work never touches a released task.
+    hostExecutor->execute([this]() { runOneTask(); }, task->priority == TaskPriority::High);
+    return;
+  }
+  std::call_once(threadsFlag, &TaskGroup::startThreads, this);
+  if (idleThreads > 0) {
+    // Acquires the locker to make sure the idle thread is either waiting or going to see the
+    // pending task, otherwise the notification may be lost.
+    std::lock_guard<std::mutex> autoLock(locker);
+    condition.notify_one();
+  }
 }
 
-Task* TaskGroup::popTask() {
-  std::unique_lock<std::mutex> autoLock(locker);
-  activeThreads--;
-  while (true) {
-    if (tasks.empty()) {
-      condition.wait(autoLock);
-      if (exited) {
-        return nullptr;
-      }
-    } else {
-      auto task = tasks.front();
-      tasks.pop_front();
-      activeThreads++;
-      // LOGI("TaskGroup.activeThreads : %d", activeThreads);
+Task* TaskGroup::popTask(size_t index) {
+  if (pendingTasks <= 0) {
+    return nullptr;
+  }
+  for (auto priority : {TaskPriority::High, TaskPriority::Low}) {
+    auto task = queues[index]->pop(priority);
+    if (task == nullptr) {
+      task = stealTask(index, priority);
+    }
+    if (task != nullptr) {
+      pendingTasks--;
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+Task* TaskGroup::stealTask(size_t index, TaskPriority priority) {
+  auto count = queues.size();
+  for (size_t i = 1; i < count; i++) {
+    auto task = queues[(index + i) % count]->pop(priority);
+    if (task != nullptr) {
       return task;
     }
   }
+  return nullptr;
 }
 
 bool TaskGroup::removeTask(Task* task) {
-  std::lock_guard<std::mutex> autoLock(locker);
-  auto position = std::find(tasks.begin(), tasks.end(), task);
-  if (position == tasks.end()) {
+  if (task->queue == nullptr || !task->queue->remove(task)) {
     return false;
   }
-  tasks.erase(position);
+  pendingTasks--;
   return true;
 }
 
+bool TaskGroup::waitForTasks() {
+  std::unique_lock<std::mutex> autoLock(locker);
+  idleThreads++;
+  condition.wait(autoLock, [this] { return exited || pendingTasks > 0; });
+  idleThreads--;
+  return !exited;
+}
+
 void TaskGroup::exit() {
   std::lock_guard<std::mutex> autoLock(locker);
   exited = true;
@@ -173,4 +285,16 @@ void TaskGroup::exit() {
 }
 }  // namespace pag
 
+#else
+
+#include "pag/pag.h"
+
+namespace pag {
+void PAGExecutor::Register(std::shared_ptr<PAGExecutor>) {
+}
+
+void PAGExecutor::SetMaxThreads(int) {
+}
+}  // namespace pag
+
 #endif
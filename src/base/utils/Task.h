@@ -20,13 +20,24 @@
 
 #ifndef PAG_BUILD_FOR_WEB
 
+#include <atomic>
 #include <condition_variable>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
 
 namespace pag {
+class PAGExecutor;
+
+/**
+ * Defines the scheduling priority of a task. High priority tasks are always picked up before any
+ * low priority ones, e.g. decoding the frame that is about to be drawn should use High, while
+ * predicting the content of future frames should use Low.
+ */
+enum class TaskPriority { High = 0, Low = 1 };
+
 class Executor {
  public:
   virtual ~Executor() = default;
@@ -38,13 +49,14 @@ class Executor {
 };
 
 class TaskGroup;
+class TaskQueue;
 
 class Task {
  public:
   static std::shared_ptr<Task> Make(std::unique_ptr<Executor> executor);
   ~Task();
 
-  void run();
+  void run(TaskPriority priority = TaskPriority::High);
   bool isRunning();
   Executor* wait();
   void cancel();
@@ -55,32 +67,79 @@ class Task {
   bool running = false;
   TaskGroup* taskGroup = nullptr;
   std::unique_ptr<Executor> executor = nullptr;
+  // The fields below are owned by the TaskQueue the task is pushed to, and guarded by its locker.
+  TaskQueue* queue = nullptr;
+  bool queued = false;
+  TaskPriority priority = TaskPriority::High;
+  std::list<Task*>::iterator position = {};
 
   explicit Task(std::unique_ptr<Executor> executor);
   void execute();
 
   friend class TaskGroup;
+  friend class TaskQueue;
+};
+
+/**
+ * A per-worker queue of pending tasks. The owner thread and other threads stealing work from it
+ * both pop tasks from the front, which keeps the submission order within the same priority.
+ */
+class TaskQueue {
+ public:
+  void push(Task* task);
+  Task* pop(TaskPriority priority);
+  bool remove(Task* task);
+
+ private:
+  std::mutex locker = {};
+  std::list<Task*> tasks[2] = {};
 };
 
+/**
+ * TaskGroup is a work-stealing thread pool. Every worker thread owns a TaskQueue, tasks are
+ * distributed among the queues and idle workers steal tasks from the others, so that submitting
+ * and popping tasks do not contend on a single global lock. If a PAGExecutor is registered, the
+ * worker threads are replaced by the works posted to the executor, each of which runs one pending
+ * task.
+ */
 class TaskGroup {
  public:
+  /**
+   * Sets the maximum number of worker threads, the default value is the number of CPU cores but
+   * no more than 16. It only takes effect if called before the first task is created.
+   */
+  static void SetMaxThreads(int count);
+
+  /**
+   * Sets the executor to run tasks, nullptr means using the worker threads of the TaskGroup.
+   */
+  static void SetExecutor(std::shared_ptr<PAGExecutor> executor);
+
   ~TaskGroup();
 
  private:
   std::mutex locker = {};
+  std::once_flag threadsFlag = {};
   std::condition_variable condition = {};
-  int activeThreads = 0;
+  std::atomic_int pendingTasks = {0};
+  std::atomic_int idleThreads = {0};
+  std::atomic_uint nextQueue = {0};
   bool exited = false;
-  std::list<Task*> tasks = {};
+  std::vector<TaskQueue*> queues = {};
   std::vector<std::thread> threads = {};
 
   static TaskGroup* GetInstance();
-  static void RunLoop(TaskGroup* taskGroup);
+  static std::shared_ptr<PAGExecutor> GetExecutor();
+  static void RunLoop(TaskGroup* taskGroup, size_t index);
 
   TaskGroup();
+  void startThreads();
+  void runOneTask();
   void pushTask(Task* task);
-  Task* popTask();
+  Task* popTask(size_t index);
+  Task* stealTask(size_t index, TaskPriority priority);
   bool removeTask(Task* task);
+  bool waitForTasks();
   void exit();
 
   friend class Task;
@@ -91,6 +150,8 @@ class TaskGroup {
 #include <memory>
 
 namespace pag {
+enum class TaskPriority { High = 0, Low = 1 };
+
 class Executor {
  public:
   virtual ~Executor() = default;
@@ -107,7 +168,7 @@ class Task {
     return std::shared_ptr<Task>(new Task(std::move(executor)));
   }
 
-  void run() {
+  void run(TaskPriority = TaskPriority::High) {
   }
 
   bool isRunning() const {
@@ -195,7 +195,14 @@ DecodeStream ReadBodyBytes(DecodeStream* stream) {
 
 std::shared_ptr<File> Codec::Decode(const void* bytes, uint32_t byteLength,
                                     const std::string& filePath) {
+  return DecodeFile(bytes, byteLength, filePath, nullptr);
+}
+
+std::shared_ptr<File> Codec::DecodeFile(const void* bytes, uint32_t byteLength,
+                                        const std::string& filePath,
+                                        std::unique_ptr<ByteData> fileData) {
   CodecContext context = {};
+  context.fileData = fileData.get();
   DecodeStream stream(&context, reinterpret_cast<const uint8_t*>(bytes), byteLength);
   auto bodyBytes = ReadBodyBytes(&stream);
   if (context.hasException()) {
@@ -228,6 +235,7 @@ std::shared_ptr<File> Codec::Decode(const void* bytes, uint32_t byteLength,
   file->timeStretchMode = context.timeStretchMode;
   file->fileAttributes = context.fileAttributes;
   file->path = filePath;
+  file->fileData = std::move(fileData);
   return file;
 }
 
@@ -47,5 +47,7 @@ class CodecContext : public StreamContext {
   TimeRange* scaledTimeRange = nullptr;
   FileAttributes fileAttributes = {};
   uint16_t tagLevel = 0;
+  // The file data kept in DecodingMode::Reference, payloads refer to it instead of being copied.
+  ByteData* fileData = nullptr;
 };
 }  // namespace pag
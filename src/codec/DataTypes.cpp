@@ -310,6 +310,20 @@ GradientColorHandle ReadGradientColor(DecodeStream* stream) {
   return GradientColorHandle(value);
 }
 
+std::unique_ptr<ByteData> ReadPayload(DecodeStream* stream) {
+  auto context = static_cast<CodecContext*>(stream->context);
+  if (context->fileData == nullptr) {
+    return stream->readByteData();
+  }
+  auto length = stream->readEncodedUint32();
+  auto bytes = stream->readBytes(length);
+  if (length == 0 || context->hasException()) {
+    return nullptr;
+  }
+  // The stream reads from the retained file data, which lives as long as the decoded File.
+  return ByteData::MakeWithoutCopy(const_cast<uint8_t*>(bytes.data()), length);
+}
+
 void WriteRatio(EncodeStream* stream, const Ratio& ratio) {
   stream->writeEncodedInt32(ratio.numerator);
   stream->writeEncodedUint32(ratio.denominator);
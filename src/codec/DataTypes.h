@@ -45,6 +45,7 @@ TextDocumentHandle ReadTextDocument(DecodeStream* stream);
 TextDocumentHandle ReadTextDocumentV2(DecodeStream* stream);
 TextDocumentHandle ReadTextDocumentV3(DecodeStream* stream);
 GradientColorHandle ReadGradientColor(DecodeStream* stream);
+std::unique_ptr<ByteData> ReadPayload(DecodeStream* stream);
 
 void WriteRatio(EncodeStream* stream, const Ratio& ratio);
 void WriteTime(EncodeStream* stream, Frame time);
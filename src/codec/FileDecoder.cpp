@@ -16,25 +16,16 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
-#include "VideoDecodingTask.h"
+#include "FileDecoder.h"
 
 namespace pag {
-std::shared_ptr<Task> VideoDecodingTask::MakeAndRun(VideoReader* reader, int64_t targetTime) {
-  if (reader == nullptr) {
+std::shared_ptr<File> FileDecoder::Decode(std::unique_ptr<ByteData> fileData,
+                                          const std::string& filePath) {
+  if (fileData == nullptr) {
     return nullptr;
   }
-  auto task =
-      Task::Make(std::unique_ptr<VideoDecodingTask>(new VideoDecodingTask(reader, targetTime)));
-  task->run();
-  return task;
+  auto bytes = fileData->data();
+  auto byteLength = static_cast<uint32_t>(fileData->length());
+  return Codec::DecodeFile(bytes, byteLength, filePath, std::move(fileData));
 }
-
-VideoDecodingTask::VideoDecodingTask(VideoReader* reader, int64_t targetTime)
-    : reader(reader), targetTime(targetTime) {
-}
-
-void VideoDecodingTask::execute() {
-  reader->readSample(targetTime);
-}
-
-}  // namespace pag
\ No newline at end of file
+}  // namespace pag
@@ -0,0 +1,34 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "pag/file.h"
+
+namespace pag {
+class FileDecoder {
+ public:
+  /**
+   * Decode a pag file from the specified byte data in DecodingMode::Reference. The returned File
+   * takes ownership of the byte data, and the payloads of its images and sequences refer to it
+   * instead of being copied. Returns null if the data is empty or it's not a valid pag file.
+   */
+  static std::shared_ptr<File> Decode(std::unique_ptr<ByteData> fileData,
+                                      const std::string& filePath);
+};
+}  // namespace pag
@@ -20,7 +20,7 @@
 
 namespace pag {
 void ReadAudioBytes(DecodeStream* stream, Composition* composition) {
-  composition->audioBytes = stream->readByteData().release();
+  composition->audioBytes = ReadPayload(stream).release();
   composition->audioStartTime = ReadTime(stream);
 }
 
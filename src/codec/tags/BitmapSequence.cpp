@@ -38,7 +38,7 @@ BitmapSequence* ReadBitmapSequence(DecodeStream* stream) {
       bitmapFrame->bitmaps.push_back(bitmap);
       bitmap->x = stream->readEncodedInt32();
       bitmap->y = stream->readEncodedInt32();
-      bitmap->fileBytes = stream->readByteData().release();
+      bitmap->fileBytes = ReadPayload(stream).release();
     }
   }
   return sequence;
@@ -24,7 +24,7 @@ namespace pag {
 ImageBytes* ReadImageBytes(DecodeStream* stream) {
   auto imageBytes = new ImageBytes();
   imageBytes->id = stream->readEncodedUint32();
-  imageBytes->fileBytes = stream->readByteData().release();
+  imageBytes->fileBytes = ReadPayload(stream).release();
   if (imageBytes->fileBytes == nullptr || imageBytes->fileBytes->length() == 0) {
     return imageBytes;
   }
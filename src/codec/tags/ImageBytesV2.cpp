@@ -24,7 +24,7 @@ namespace pag {
 ImageBytes* ReadImageBytesV2(DecodeStream* stream) {
   auto imageBytes = new ImageBytes();
   imageBytes->id = stream->readEncodedUint32();
-  imageBytes->fileBytes = stream->readByteData().release();
+  imageBytes->fileBytes = ReadPayload(stream).release();
   imageBytes->scaleFactor = stream->readFloat();
   int width;
   int height;
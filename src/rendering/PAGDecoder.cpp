@@ -0,0 +1,135 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <thread>
+#include "base/utils/TimeUtil.h"
+#include "pag/pag.h"
+#include "rendering/caches/RenderCache.h"
+#include "rendering/layers/PAGStage.h"
+#include "rendering/utils/LockGuard.h"
+
+namespace pag {
+// More decoders hardly speed up the rendering thread, which has to draw the frames one by one.
+#define MAX_VIDEO_SEGMENT_DECODERS 4
+
+std::shared_ptr<PAGDecoder> PAGDecoder::MakeFrom(std::shared_ptr<PAGComposition> composition,
+                                                 int width, int height, float frameRate) {
+  if (composition == nullptr || width <= 0 || height <= 0) {
+    return nullptr;
+  }
+  auto decoder =
+      std::shared_ptr<PAGDecoder>(new PAGDecoder(std::move(composition), width, height, frameRate));
+  if (decoder->pagSurface == nullptr) {
+    return nullptr;
+  }
+  return decoder;
+}
+
+PAGDecoder::PAGDecoder(std::shared_ptr<PAGComposition> pagComposition, int width, int height,
+                       float frameRate)
+    : _width(width), _height(height), composition(std::move(pagComposition)) {
+  auto compositionFrameRate = composition->frameRate();
+  _frameRate = frameRate > 0 && frameRate < compositionFrameRate ? frameRate : compositionFrameRate;
+  pagSurface = PAGSurface::MakeOffscreen(width, height);
+  pagPlayer = new PAGPlayer();
+  pagPlayer->setMaxFrameRate(_frameRate);
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(composition);
+  // Frames are usually read in order, which decoding video segments in parallel relies on.
+  auto cpuCores = static_cast<int>(std::thread::hardware_concurrency());
+  setVideoSegmentDecoders(std::min(cpuCores, MAX_VIDEO_SEGMENT_DECODERS));
+}
+
+PAGDecoder::~PAGDecoder() {
+  delete pagPlayer;
+}
+
+int PAGDecoder::numFrames() {
+  std::lock_guard<std::mutex> autoLock(locker);
+  return getNumFrames();
+}
+
+int PAGDecoder::getNumFrames() {
+  auto compositionFrameRate = composition->frameRate();
+  auto totalFrames = TimeToFrame(composition->duration(), compositionFrameRate);
+  if (_frameRate >= compositionFrameRate) {
+    return static_cast<int>(totalFrames);
+  }
+  // Keeps consistent with the frame dropping in PAGPlayer::setProgress().
+  return static_cast<int>(ceilf(totalFrames * _frameRate / compositionFrameRate));
+}
+
+void PAGDecoder::setVideoSegmentDecoders(int count) {
+  pagPlayer->renderCache->setVideoSegmentDecoders(count);
+}
+
+bool PAGDecoder::seekTo(int index) {
+  pagPlayer->setProgress(FrameToProgress(index, getNumFrames()));
+  // The content version only increases if some layer moves to a frame that falls outside of its
+  // current static time range, or the composition is modified.
+  LockGuard autoLock(pagPlayer->rootLocker);
+  return !hasLastFrame || pagPlayer->stage->getContentVersion() != lastContentVersion;
+}
+
+void PAGDecoder::clearLastPixels() {
+  std::lock_guard<std::mutex> autoLock(locker);
+  lastPixels = nullptr;
+}
+
+bool PAGDecoder::checkFrameChanged(int index) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (index < 0 || index >= getNumFrames()) {
+    return false;
+  }
+  return seekTo(index);
+}
+
+bool PAGDecoder::readFrame(int index, void* dstPixels, size_t dstRowBytes, ColorType colorType,
+                           AlphaType alphaType) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (dstPixels == nullptr || index < 0 || index >= getNumFrames()) {
+    return false;
+  }
+  if (!seekTo(index)) {
+    if (dstPixels == lastPixels && dstRowBytes == lastRowBytes && colorType == lastColorType &&
+        alphaType == lastAlphaType) {
+      return true;
+    }
+  } else {
+    // flush() returns false if nothing has changed since the last flush, which happens when the
+    // surface already holds the content of this frame.
+    pagPlayer->flush();
+    hasLastFrame = false;
+  }
+  lastPixels = nullptr;
+  if (!pagSurface->readPixels(colorType, alphaType, dstPixels, dstRowBytes)) {
+    return false;
+  }
+  {
+    LockGuard playerLock(pagPlayer->rootLocker);
+    lastContentVersion = pagPlayer->stage->getContentVersion();
+  }
+  hasLastFrame = true;
+  lastPixels = dstPixels;
+  lastRowBytes = dstRowBytes;
+  lastColorType = colorType;
+  lastAlphaType = alphaType;
+  return true;
+}
+}  // namespace pag
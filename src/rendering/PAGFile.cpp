@@ -19,8 +19,10 @@
 #include "base/utils/TimeUtil.h"
 #include "pag/file.h"
 #include "pag/pag.h"
+#include "rendering/caches/FrameCacheBudget.h"
 #include "rendering/editing/PAGImageHolder.h"
 #include "rendering/utils/LockGuard.h"
+#include "rendering/utils/MemoryCalculator.h"
 #include "rendering/utils/ScopedLock.h"
 
 namespace pag {
@@ -34,8 +36,8 @@ std::shared_ptr<PAGFile> PAGFile::Load(const void* bytes, size_t length,
   return MakeFrom(file);
 }
 
-std::shared_ptr<PAGFile> PAGFile::Load(const std::string& filePath) {
-  auto file = File::Load(filePath);
+std::shared_ptr<PAGFile> PAGFile::Load(const std::string& filePath, DecodingMode mode) {
+  auto file = File::Load(filePath, mode);
   return MakeFrom(file);
 }
 
@@ -43,6 +45,8 @@ std::shared_ptr<PAGFile> PAGFile::MakeFrom(std::shared_ptr<File> file) {
   if (file == nullptr) {
     return nullptr;
   }
+  // Creates the budget before any layer cache of the file, so that all of them are accounted.
+  FrameCacheBudget::Get(file.get());
   auto pagLayer = BuildPAGLayer(file, file->getRootLayer());
   auto locker = std::make_shared<std::mutex>();
   pagLayer->updateRootLocker(locker);
@@ -213,6 +217,18 @@ std::shared_ptr<PAGFile> PAGFile::copyOriginal() {
   return MakeFrom(file);
 }
 
+size_t PAGFile::maxFrameCacheMemory() const {
+  return FrameCacheBudget::Get(file.get())->maxMemory();
+}
+
+void PAGFile::setMaxFrameCacheMemory(size_t maxMemory) {
+  FrameCacheBudget::Get(file.get())->setMaxMemory(maxMemory);
+}
+
+size_t PAGFile::frameCacheMemoryUsage() const {
+  return MemoryCalculator::GetFrameCacheMemoryUsage(file.get());
+}
+
 bool PAGFile::isPAGFile() const {
   return true;
 }
@@ -0,0 +1,184 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <thread>
+#include "pag/pag.h"
+
+namespace pag {
+/**
+ * The limits of frames rendered as one chunk. Consecutive frames are rendered by the same shard, so
+ * that the static frames can be skipped and video sequences can be decoded sequentially.
+ */
+static constexpr int MaxFramesPerChunk = 30;
+static constexpr size_t MaxBytesPerChunk = 64 * 1024 * 1024;
+
+/**
+ * The number of chunks each shard can render ahead of the chunk being delivered, which limits the
+ * memory used by the rendered pixels.
+ */
+static constexpr int MaxChunksPerShard = 2;
+
+std::shared_ptr<PAGParallelDecoder> PAGParallelDecoder::MakeFrom(std::shared_ptr<PAGFile> pagFile,
+                                                                 int width, int height,
+                                                                 float frameRate, int numShards) {
+  if (pagFile == nullptr || width <= 0 || height <= 0) {
+    return nullptr;
+  }
+  if (numShards <= 0) {
+    numShards = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  }
+  auto decoder = std::shared_ptr<PAGParallelDecoder>(new PAGParallelDecoder());
+  decoder->_width = width;
+  decoder->_height = height;
+  for (int i = 0; i < numShards; i++) {
+    auto shardDecoder = PAGDecoder::MakeFrom(pagFile->copyOriginal(), width, height, frameRate);
+    if (shardDecoder == nullptr) {
+      break;
+    }
+    if (decoder->decoders.empty()) {
+      decoder->_numFrames = shardDecoder->numFrames();
+      decoder->_frameRate = shardDecoder->frameRate();
+    }
+    decoder->decoders.push_back(shardDecoder);
+    if (static_cast<int>(decoder->decoders.size()) >= decoder->_numFrames) {
+      break;
+    }
+  }
+  if (decoder->decoders.empty()) {
+    return nullptr;
+  }
+  // Each shard jumps to a far chunk after finishing one, the video segments decoded ahead of the
+  // chunk would be wasted. The shards already keep the CPU cores busy anyway.
+  for (auto& shardDecoder : decoder->decoders) {
+    shardDecoder->setVideoSegmentDecoders(0);
+  }
+  return decoder;
+}
+
+namespace {
+struct Chunk {
+  int startIndex = 0;
+  int frameCount = 0;
+  std::vector<uint8_t> pixels = {};
+  bool finished = false;
+  bool success = false;
+};
+
+struct ShardContext {
+  std::mutex locker = {};
+  std::condition_variable condition = {};
+  std::vector<Chunk> chunks = {};
+  int deliveringChunk = 0;
+  int chunksInFlight = 0;
+  bool aborted = false;
+};
+}  // namespace
+
+static bool RenderChunk(PAGDecoder* decoder, Chunk* chunk, size_t rowBytes, ColorType colorType,
+                        AlphaType alphaType) {
+  auto frameBytes = rowBytes * static_cast<size_t>(decoder->height());
+  chunk->pixels.resize(frameBytes * chunk->frameCount);
+  for (int i = 0; i < chunk->frameCount; i++) {
+    auto index = chunk->startIndex + i;
+    auto pixels = chunk->pixels.data() + frameBytes * i;
+    if (i > 0 && !decoder->checkFrameChanged(index)) {
+      // The frame is identical to the previous one, skips both the rendering and the reading.
+      memcpy(pixels, pixels - frameBytes, frameBytes);
+      continue;
+    }
+    if (!decoder->readFrame(index, pixels, rowBytes, colorType, alphaType)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PAGParallelDecoder::readFrames(
+    const std::function<bool(int index, const void* pixels, size_t rowBytes)>& callback,
+    ColorType colorType, AlphaType alphaType) {
+  if (callback == nullptr || _numFrames <= 0) {
+    return false;
+  }
+  auto bytesPerPixel = colorType == ColorType::ALPHA_8 ? 1 : 4;
+  auto rowBytes = static_cast<size_t>(_width) * bytesPerPixel;
+  auto frameBytes = rowBytes * static_cast<size_t>(_height);
+  auto framesPerChunk =
+      std::clamp(static_cast<int>(MaxBytesPerChunk / frameBytes), 1, MaxFramesPerChunk);
+  ShardContext context = {};
+  for (int startIndex = 0; startIndex < _numFrames; startIndex += framesPerChunk) {
+    Chunk chunk = {};
+    chunk.startIndex = startIndex;
+    chunk.frameCount = std::min(framesPerChunk, _numFrames - startIndex);
+    context.chunks.push_back(std::move(chunk));
+  }
+  auto numChunks = static_cast<int>(context.chunks.size());
+  auto shardCount = std::min(static_cast<int>(decoders.size()), numChunks);
+  auto maxChunksInFlight = shardCount * MaxChunksPerShard;
+  std::vector<std::thread> threads = {};
+  for (int shard = 0; shard < shardCount; shard++) {
+    auto decoder = decoders[shard].get();
+    threads.emplace_back([=, &context]() {
+      // Each shard takes every shardCount-th chunk.
+      for (int index = shard; index < numChunks; index += shardCount) {
+        auto& chunk = context.chunks[index];
+        {
+          std::unique_lock<std::mutex> autoLock(context.locker);
+          context.condition.wait(autoLock, [&]() {
+            return context.aborted || index < context.deliveringChunk + maxChunksInFlight;
+          });
+          if (context.aborted) {
+            return;
+          }
+        }
+        // The buffer of a delivered chunk has been freed, and this chunk may be allocated at the
+        // same address, which must not be taken as holding the last frame already.
+        decoder->clearLastPixels();
+        auto success = RenderChunk(decoder, &chunk, rowBytes, colorType, alphaType);
+        std::lock_guard<std::mutex> autoLock(context.locker);
+        chunk.finished = true;
+        chunk.success = success;
+        context.condition.notify_all();
+      }
+    });
+  }
+  auto result = true;
+  for (int index = 0; index < numChunks && result; index++) {
+    auto& chunk = context.chunks[index];
+    {
+      std::unique_lock<std::mutex> autoLock(context.locker);
+      context.condition.wait(autoLock, [&]() { return chunk.finished; });
+    }
+    result = chunk.success;
+    for (int i = 0; i < chunk.frameCount && result; i++) {
+      result = callback(chunk.startIndex + i, chunk.pixels.data() + frameBytes * i, rowBytes);
+    }
+    std::lock_guard<std::mutex> autoLock(context.locker);
+    chunk.pixels = {};
+    context.deliveringChunk = index + 1;
+    context.aborted = !result;
+    context.condition.notify_all();
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return result;
+}
+}  // namespace pag
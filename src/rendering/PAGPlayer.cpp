@@ -21,9 +21,11 @@
 #include "pag/file.h"
 #include "pag/pag.h"
 #include "rendering/FileReporter.h"
+#include "rendering/caches/ContentPrefetcher.h"
 #include "rendering/caches/RenderCache.h"
 #include "rendering/layers/PAGStage.h"
 #include "rendering/utils/ApplyScaleMode.h"
+#include "rendering/utils/DamageTracker.h"
 #include "rendering/utils/LockGuard.h"
 #include "rendering/utils/ScopedLock.h"
 
@@ -39,6 +41,8 @@ PAGPlayer::~PAGPlayer() {
   setSurface(nullptr);
   stage->removeAllLayers();
   delete reporter;
+  delete damageTracker;
+  delete contentPrefetcher;
 }
 
 std::shared_ptr<PAGComposition> PAGPlayer::getComposition() {
@@ -122,6 +126,46 @@ void PAGPlayer::setCacheEnabled(bool value) {
   renderCache->setSnapshotEnabled(value);
 }
 
+bool PAGPlayer::sharedCacheEnabled() {
+  LockGuard autoLock(rootLocker);
+  return renderCache->sharedCacheEnabled();
+}
+
+void PAGPlayer::setSharedCacheEnabled(bool value) {
+  LockGuard autoLock(rootLocker);
+  renderCache->setSharedCacheEnabled(value);
+}
+
+bool PAGPlayer::distanceFieldTextEnabled() {
+  LockGuard autoLock(rootLocker);
+  return renderCache->distanceFieldTextEnabled();
+}
+
+void PAGPlayer::setDistanceFieldTextEnabled(bool value) {
+  LockGuard autoLock(rootLocker);
+  renderCache->setDistanceFieldTextEnabled(value);
+}
+
+bool PAGPlayer::blurDownscaleEnabled() {
+  LockGuard autoLock(rootLocker);
+  return renderCache->blurDownscaleEnabled();
+}
+
+void PAGPlayer::setBlurDownscaleEnabled(bool value) {
+  LockGuard autoLock(rootLocker);
+  renderCache->setBlurDownscaleEnabled(value);
+}
+
+bool PAGPlayer::pathTriangulationEnabled() {
+  LockGuard autoLock(rootLocker);
+  return renderCache->pathTriangulationEnabled();
+}
+
+void PAGPlayer::setPathTriangulationEnabled(bool value) {
+  LockGuard autoLock(rootLocker);
+  renderCache->setPathTriangulationEnabled(value);
+}
+
 float PAGPlayer::cacheScale() {
   LockGuard autoLock(rootLocker);
   return stage->cacheScale();
@@ -132,6 +176,16 @@ void PAGPlayer::setCacheScale(float value) {
   stage->setCacheScale(value);
 }
 
+size_t PAGPlayer::maxCacheMemory() {
+  LockGuard autoLock(rootLocker);
+  return renderCache->maxMemory();
+}
+
+void PAGPlayer::setMaxCacheMemory(size_t bytes) {
+  LockGuard autoLock(rootLocker);
+  renderCache->setMaxMemory(bytes);
+}
+
 float PAGPlayer::maxFrameRate() {
   LockGuard autoLock(rootLocker);
   return _maxFrameRate;
@@ -236,6 +290,61 @@ void PAGPlayer::setAutoClear(bool value) {
   stage->notifyModified(true);
 }
 
+bool PAGPlayer::partialRedrawEnabled() {
+  LockGuard autoLock(rootLocker);
+  return damageTracker != nullptr;
+}
+
+void PAGPlayer::setPartialRedrawEnabled(bool value) {
+  LockGuard autoLock(rootLocker);
+  if (value == (damageTracker != nullptr)) {
+    return;
+  }
+  if (value) {
+    damageTracker = new DamageTracker();
+  } else {
+    delete damageTracker;
+    damageTracker = nullptr;
+  }
+}
+
+bool PAGPlayer::showDirtyRegions() {
+  LockGuard autoLock(rootLocker);
+  return _showDirtyRegions;
+}
+
+void PAGPlayer::setShowDirtyRegions(bool value) {
+  LockGuard autoLock(rootLocker);
+  if (_showDirtyRegions == value) {
+    return;
+  }
+  _showDirtyRegions = value;
+  // Redraws the whole surface to wipe out the tinted regions.
+  if (damageTracker) {
+    damageTracker->reset();
+  }
+  stage->notifyModified(true);
+}
+
+int PAGPlayer::pipelineDepth() {
+  LockGuard autoLock(rootLocker);
+  return contentPrefetcher ? contentPrefetcher->depth() : 0;
+}
+
+void PAGPlayer::setPipelineDepth(int depth) {
+  LockGuard autoLock(rootLocker);
+  depth = std::clamp(depth, 0, ContentPrefetcher::MaxDepth);
+  if (depth == 0) {
+    delete contentPrefetcher;
+    contentPrefetcher = nullptr;
+    return;
+  }
+  if (contentPrefetcher == nullptr) {
+    contentPrefetcher = new ContentPrefetcher();
+  }
+  contentPrefetcher->setDepth(depth);
+}
+
 bool PAGPlayer::wait(const BackendSemaphore& waitSemaphore) {
   LockGuard autoLock(rootLocker);
   if (pagSurface == nullptr) {
@@ -269,14 +378,30 @@ bool PAGPlayer::flushInternal(BackendSemaphore* signalSemaphore) {
     Recorder recorder = {};
     stage->draw(&recorder);
     lastGraphic = recorder.makeGraphic();
+    if (contentPrefetcher) {
+      // Records the contents of the upcoming frames on a worker thread while the current frame is
+      // being submitted to the GPU.
+      contentPrefetcher->prefetch(stage.get());
+    }
   }
   auto presentingStart = GetTimer();
   if (lastGraphic) {
     lastGraphic->prepare(renderCache);
   }
-  if (!pagSurface->draw(renderCache, lastGraphic, signalSemaphore, _autoClear)) {
+  auto dirtyRect = tgfx::Rect::MakeEmpty();
+  auto hasDirtyRect = damageTracker != nullptr && damageTracker->update(stage.get(), &dirtyRect);
+  if (!pagSurface->draw(renderCache, lastGraphic, signalSemaphore, _autoClear,
+                        hasDirtyRect ? &dirtyRect : nullptr, _showDirtyRegions)) {
+    if (damageTracker && (!hasDirtyRect || !dirtyRect.isEmpty())) {
+      // The recorded layer states no longer match the content of the surface.
+      damageTracker->reset();
+    }
     return false;
   }
+  if (hasDirtyRect && _showDirtyRegions) {
+    // The tinted region must be repaired in the next flush.
+    damageTracker->invalidate(dirtyRect);
+  }
   auto finishTime = GetTimer();
   renderCache->renderingTime = presentingStart - renderingStart;
   renderCache->presentingTime = finishTime - presentingStart;
@@ -382,6 +507,11 @@ int64_t PAGPlayer::graphicsMemory() {
   return renderCache->memoryUsage();
 }
 
+int64_t PAGPlayer::drawCallCount() {
+  LockGuard autoLock(rootLocker);
+  return renderCache->drawCallCount;
+}
+
 void PAGPlayer::updateStageSize() {
   if (pagSurface == nullptr) {
     return;
@@ -19,6 +19,7 @@
 #include "base/utils/GetTimer.h"
 #include "base/utils/TGFXCast.h"
 #include "gpu/Canvas.h"
+#include "gpu/ReadbackBuffer.h"
 #include "gpu/opengl/GLDevice.h"
 #include "pag/file.h"
 #include "pag/pag.h"
@@ -28,6 +29,18 @@
 #include "rendering/utils/LockGuard.h"
 
 namespace pag {
+/**
+ * The maximum number of asynchronous pixel readings in flight. Two buffers are enough for the GPU
+ * to copy the pixels of one frame while the next frame is being rendered.
+ */
+static constexpr size_t MaxPendingReadbacks = 2;
+
+struct PAGSurface::PendingReadback {
+  std::shared_ptr<tgfx::ReadbackBuffer> buffer = nullptr;
+  tgfx::ImageInfo dstInfo = {};
+  void* dstPixels = nullptr;
+  std::function<void(bool)> callback = nullptr;
+};
 
 std::shared_ptr<PAGSurface> PAGSurface::MakeFrom(std::shared_ptr<Drawable> drawable) {
   if (drawable == nullptr) {
@@ -80,6 +93,19 @@ PAGSurface::PAGSurface(std::shared_ptr<Drawable> drawable) : drawable(std::move(
   rootLocker = std::make_shared<std::mutex>();
 }
 
+PAGSurface::~PAGSurface() {
+  // The readback buffers must be mapped while the GPU context is still alive, otherwise the
+  // callbacks of the pending readings would never be invoked.
+  std::vector<std::function<void()>> callbacks = {};
+  {
+    LockGuard autoLock(rootLocker);
+    releaseReadbacks(&callbacks);
+  }
+  for (auto& callback : callbacks) {
+    callback();
+  }
+}
+
 int PAGSurface::width() {
   LockGuard autoLock(rootLocker);
   return drawable->width();
@@ -91,26 +117,40 @@ int PAGSurface::height() {
 }
 
 void PAGSurface::updateSize() {
-  LockGuard autoLock(rootLocker);
-  surface = nullptr;
-  device = nullptr;
-  drawable->updateSize();
+  std::vector<std::function<void()>> callbacks = {};
+  {
+    LockGuard autoLock(rootLocker);
+    releaseReadbacks(&callbacks);
+    surface = nullptr;
+    device = nullptr;
+    drawable->updateSize();
+  }
+  for (auto& callback : callbacks) {
+    callback();
+  }
 }
 
 void PAGSurface::freeCache() {
-  LockGuard autoLock(rootLocker);
-  if (pagPlayer) {
-    pagPlayer->renderCache->releaseAll();
-  }
-  surface = nullptr;
-  if (device) {
-    auto context = device->lockContext();
-    if (context) {
-      context->purgeResourcesNotUsedIn(0);
-      device->unlock();
+  std::vector<std::function<void()>> callbacks = {};
+  {
+    LockGuard autoLock(rootLocker);
+    releaseReadbacks(&callbacks);
+    if (pagPlayer) {
+      pagPlayer->renderCache->releaseAll();
+    }
+    surface = nullptr;
+    if (device) {
+      auto context = device->lockContext();
+      if (context) {
+        context->purgeResourcesNotUsedIn(0);
+        device->unlock();
+      }
     }
+    device = nullptr;
+  }
+  for (auto& callback : callbacks) {
+    callback();
   }
-  device = nullptr;
 }
 
 bool PAGSurface::clearAll() {
@@ -153,8 +193,137 @@ bool PAGSurface::readPixels(ColorType colorType, AlphaType alphaType, void* dstP
   return result;
 }
 
+bool PAGSurface::readPixelsAsync(ColorType colorType, AlphaType alphaType, void* dstPixels,
+                                 size_t dstRowBytes, std::function<void(bool success)> callback) {
+  if (dstPixels == nullptr || callback == nullptr) {
+    return false;
+  }
+  // The callbacks are invoked after unlocking, so that they can access the PAGSurface safely.
+  std::vector<std::function<void()>> callbacks = {};
+  auto scheduled = false;
+  {
+    LockGuard autoLock(rootLocker);
+    auto context = lockContext();
+    if (context != nullptr) {
+      if (surface != nullptr) {
+        scheduled = true;
+        auto info = tgfx::ImageInfo::Make(surface->width(), surface->height(), ToTGFX(colorType),
+                                          ToTGFX(alphaType), dstRowBytes);
+        // Delivers the readings which are already finished and makes room for the new one.
+        finishReadbacks(false, &callbacks);
+        std::shared_ptr<tgfx::ReadbackBuffer> buffer = nullptr;
+        if (!idleReadbackBuffers.empty()) {
+          buffer = idleReadbackBuffers.back();
+          idleReadbackBuffers.pop_back();
+        }
+        if (buffer == nullptr || buffer->width() != surface->width() ||
+            buffer->height() != surface->height()) {
+          buffer = tgfx::ReadbackBuffer::Make(context, surface->width(), surface->height());
+        }
+        if (buffer != nullptr && surface->readPixels(buffer.get())) {
+          auto readback = std::make_shared<PendingReadback>();
+          readback->buffer = buffer;
+          readback->dstInfo = info;
+          readback->dstPixels = dstPixels;
+          readback->callback = std::move(callback);
+          pendingReadbacks.push_back(readback);
+        } else {
+          // Falls back to the synchronous reading. The pending readings are delivered first to
+          // keep the callbacks in order.
+          finishReadbacks(true, &callbacks);
+          auto success = surface->readPixels(info, dstPixels);
+          callbacks.push_back([callback, success]() { callback(success); });
+        }
+      }
+      unlockContext();
+    }
+  }
+  for (auto& finishedCallback : callbacks) {
+    finishedCallback();
+  }
+  return scheduled;
+}
+
+void PAGSurface::finishReadPixels() {
+  std::vector<std::function<void()>> callbacks = {};
+  {
+    LockGuard autoLock(rootLocker);
+    auto context = lockContext();
+    if (context != nullptr) {
+      finishReadbacks(true, &callbacks);
+      unlockContext();
+    }
+  }
+  for (auto& callback : callbacks) {
+    callback();
+  }
+}
+
+void PAGSurface::finishReadbacks(bool waitAll, std::vector<std::function<void()>>* callbacks) {
+  while (!pendingReadbacks.empty()) {
+    auto readback = pendingReadbacks.front();
+    if (!waitAll && pendingReadbacks.size() < MaxPendingReadbacks &&
+        !readback->buffer->isReady()) {
+      break;
+    }
+    pendingReadbacks.erase(pendingReadbacks.begin());
+    auto success = readback->buffer->readPixels(readback->dstInfo, readback->dstPixels);
+    idleReadbackBuffers.push_back(readback->buffer);
+    auto callback = readback->callback;
+    callbacks->push_back([callback, success]() { callback(success); });
+  }
+}
+
+void PAGSurface::releaseReadbacks(std::vector<std::function<void()>>* callbacks) {
+  auto context = lockContext();
+  if (context != nullptr) {
+    finishReadbacks(true, callbacks);
+    idleReadbackBuffers = {};
+    unlockContext();
+  }
+  // The GPU context is gone, there is no way to fetch the pending pixels.
+  for (auto& readback : pendingReadbacks) {
+    auto callback = readback->callback;
+    callbacks->push_back([callback]() { callback(false); });
+  }
+  pendingReadbacks = {};
+  idleReadbackBuffers = {};
+}
+
+static void DrawDirtyRect(tgfx::Canvas* canvas, RenderCache* cache, Graphic* graphic,
+                          const tgfx::Rect& dirtyRect, bool autoClear, bool showDirtyRect) {
+  auto surface = canvas->getSurface();
+  auto rect = dirtyRect;
+  if (!rect.intersect(tgfx::Rect::MakeWH(static_cast<float>(surface->width()),
+                                         static_cast<float>(surface->height())))) {
+    cache->drawnPixels = 0;
+    return;
+  }
+  cache->drawnPixels = static_cast<int64_t>(rect.width() * rect.height());
+  tgfx::Path clip = {};
+  clip.addRect(rect);
+  canvas->save();
+  // The dirty rect is aligned to pixels, so the clip turns into a scissor test.
+  canvas->clipPath(clip);
+  tgfx::Paint paint = {};
+  if (autoClear) {
+    canvas->setBlendMode(tgfx::BlendMode::Clear);
+    canvas->drawPath(clip, paint);
+    canvas->setBlendMode(tgfx::BlendMode::SrcOver);
+  }
+  if (graphic) {
+    graphic->draw(canvas, cache);
+  }
+  if (showDirtyRect) {
+    paint.setColor(tgfx::Color::FromRGBA(255, 0, 0, 64));
+    canvas->drawPath(clip, paint);
+  }
+  canvas->restore();
+}
+
 bool PAGSurface::draw(RenderCache* cache, std::shared_ptr<Graphic> graphic,
-                      BackendSemaphore* signalSemaphore, bool autoClear) {
+                      BackendSemaphore* signalSemaphore, bool autoClear,
+                      const tgfx::Rect* dirtyRect, bool showDirtyRect) {
   if (device == nullptr) {
     device = drawable->getDevice();
   }
@@ -166,6 +335,10 @@ bool PAGSurface::draw(RenderCache* cache, std::shared_ptr<Graphic> graphic,
     unlockContext();
     return false;
   }
+  // The previous content is lost if the surface is newly created or cleared.
+  if (surface == nullptr || contentVersion == 0) {
+    dirtyRect = nullptr;
+  }
   if (surface == nullptr) {
     surface = drawable->createSurface(context);
   }
@@ -176,11 +349,16 @@ bool PAGSurface::draw(RenderCache* cache, std::shared_ptr<Graphic> graphic,
   contentVersion = cache->getContentVersion();
   cache->attachToContext(context);
   auto canvas = surface->getCanvas();
-  if (autoClear) {
-    canvas->clear();
-  }
-  if (graphic) {
-    graphic->draw(canvas, cache);
+  if (dirtyRect) {
+    DrawDirtyRect(canvas, cache, graphic.get(), *dirtyRect, autoClear, showDirtyRect);
+  } else {
+    if (autoClear) {
+      canvas->clear();
+    }
+    if (graphic) {
+      graphic->draw(canvas, cache);
+    }
+    cache->drawnPixels = static_cast<int64_t>(surface->width()) * surface->height();
   }
   if (signalSemaphore == nullptr) {
     surface->flush();
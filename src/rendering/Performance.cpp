@@ -24,13 +24,13 @@ std::string Performance::getPerformanceString() const {
   char buffer[300];
   sprintf(buffer,
           "%6.1fms[Render] %6.1fms[Image] %6.1fms[Video]"
-          " %6.1fms[Texture] %6.1fms[Program] %6.1fms[Present] ",
+          " %6.1fms[Texture] %6.1fms[Program] %6.1fms[Present] %4d[DrawCall] ",
           static_cast<double>(renderingTime) / 1000.0,
           static_cast<double>(imageDecodingTime) / 1000.0,
           static_cast<double>(softwareDecodingTime + hardwareDecodingTime) / 1000.0,
           static_cast<double>(textureUploadingTime) / 1000.0,
           static_cast<double>(programCompilingTime) / 1000.0,
-          static_cast<double>(presentingTime) / 1000.0);
+          static_cast<double>(presentingTime) / 1000.0, static_cast<int>(drawCallCount));
   return buffer;
 }
 
@@ -52,5 +52,16 @@ void Performance::resetPerformance() {
   hardwareDecodingInitialTime = 0;
   softwareDecodingInitialTime = 0;
   totalTime = 0;
+  drawCallCount = 0;
+  triangulatedPathCount = 0;
+  rasterizedPathCount = 0;
+  pathMaskCacheHits = 0;
+  pathMaskCacheMisses = 0;
+  uploadedTextureBytes = 0;
+  drawnPixels = 0;
+  videoBufferedFrames = 0;
+  videoBufferUnderruns = 0;
+  videoPrefetchedFrames = 0;
+  videoPrefetchingTime = 0;
 }
 }  // namespace pag
\ No newline at end of file
@@ -39,6 +39,29 @@ class Performance {
   int64_t hardwareDecodingInitialTime = 0;
   int64_t softwareDecodingInitialTime = 0;
   int64_t totalTime = 0;
+  // The number of GPU draw calls issued for the frame.
+  int64_t drawCallCount = 0;
+  // The number of paths filled by triangulating them on the GPU for the frame.
+  int64_t triangulatedPathCount = 0;
+  // The number of paths filled by rasterizing them into masks on the CPU for the frame.
+  int64_t rasterizedPathCount = 0;
+  // The number of path masks served from or missed in the path mask cache of the GPU context for
+  // the frame.
+  int64_t pathMaskCacheHits = 0;
+  int64_t pathMaskCacheMisses = 0;
+  // The number of pixel bytes uploaded from the CPU into textures for the frame, the time spent on
+  // them is counted in textureUploadingTime.
+  int64_t uploadedTextureBytes = 0;
+  // The number of surface pixels redrawn for the frame.
+  int64_t drawnPixels = 0;
+  // The number of decoded video frames waiting in the lookahead buffers after drawing the frame.
+  int64_t videoBufferedFrames = 0;
+  // The number of video frames missed in the lookahead buffers and decoded while drawing.
+  int64_t videoBufferUnderruns = 0;
+  // The number of video frames decoded ahead in the background and the time spent on them, which
+  // give the decoding throughput.
+  int64_t videoPrefetchedFrames = 0;
+  int64_t videoPrefetchingTime = 0;
 
   /**
    * Returns the formatted  string which contains the performance data.
@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "CacheReclaimer.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace pag {
+// Every thread publishes the phase in which it entered through its own slot. Deleters retired in
+// the current phase are moved to the pending list when the phase flips, and released once no slot
+// is in the previous phase.
+#define IDLE_PHASE -1
+
+struct ReaderSlot {
+  std::atomic_int phase = {IDLE_PHASE};
+  // Only accessed by the owner thread.
+  int depth = 0;
+};
+
+static std::atomic_int currentPhase = {0};
+static std::atomic_bool hasRetired = {false};
+static std::mutex retireLocker = {};
+static std::vector<ReaderSlot*> readerSlots = {};
+static std::vector<std::function<void()>> retiredDeleters = {};
+static std::vector<std::function<void()>> pendingDeleters = {};
+
+class ThreadReaderSlot {
+ public:
+  ThreadReaderSlot() {
+    std::lock_guard<std::mutex> autoLock(retireLocker);
+    readerSlots.push_back(&slot);
+  }
+
+  ~ThreadReaderSlot() {
+    std::lock_guard<std::mutex> autoLock(retireLocker);
+    auto result = std::find(readerSlots.begin(), readerSlots.end(), &slot);
+    if (result != readerSlots.end()) {
+      readerSlots.erase(result);
+    }
+  }
+
+  ReaderSlot slot = {};
+};
+
+static ReaderSlot* CurrentSlot() {
+  static thread_local ThreadReaderSlot threadSlot = {};
+  return &threadSlot.slot;
+}
+
+static void Collect() {
+  std::vector<std::function<void()>> deleters = {};
+  {
+    std::lock_guard<std::mutex> autoLock(retireLocker);
+    auto phase = currentPhase.load();
+    for (auto slot : readerSlots) {
+      if (slot->phase == 1 - phase) {
+        return;
+      }
+    }
+    // All the readers entered before the last flip have left.
+    deleters.swap(pendingDeleters);
+    if (!retiredDeleters.empty()) {
+      pendingDeleters.swap(retiredDeleters);
+      currentPhase = 1 - phase;
+    }
+    hasRetired = !pendingDeleters.empty();
+  }
+  for (auto& deleter : deleters) {
+    deleter();
+  }
+}
+
+void CacheReclaimer::Enter() {
+  auto slot = CurrentSlot();
+  if (slot->depth++ == 0) {
+    slot->phase = currentPhase.load();
+  }
+}
+
+void CacheReclaimer::Leave() {
+  auto slot = CurrentSlot();
+  if (--slot->depth > 0) {
+    return;
+  }
+  slot->phase = IDLE_PHASE;
+  if (hasRetired) {
+    Collect();
+  }
+}
+
+void CacheReclaimer::Retire(std::function<void()> deleter) {
+  {
+    std::lock_guard<std::mutex> autoLock(retireLocker);
+    retiredDeleters.push_back(std::move(deleter));
+    hasRetired = true;
+  }
+  Collect();
+}
+}  // namespace pag
@@ -0,0 +1,51 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <functional>
+
+namespace pag {
+/**
+ * CacheReclaimer defers the deletion of evicted cache entries until no reader can still hold a
+ * reference to them. The caches of a File are shared by all the PAGLayers created from it, which
+ * may render on different threads, so an entry evicted by one thread may be in use on another.
+ * Every access to the caches must happen between a pair of Enter() and Leave() calls, which is done
+ * by LockGuard. Retired entries are released after all the readers entered before the retirement
+ * have left.
+ */
+class CacheReclaimer {
+ public:
+  /**
+   * Marks the beginning of a read section on the calling thread. The sections can be nested, only
+   * the outermost one is published to other threads, which only writes to a slot owned by the
+   * calling thread.
+   */
+  static void Enter();
+
+  /**
+   * Marks the end of a read section on the calling thread.
+   */
+  static void Leave();
+
+  /**
+   * Schedules the deleter to be called once it is safe to release the retired entry.
+   */
+  static void Retire(std::function<void()> deleter);
+};
+}  // namespace pag
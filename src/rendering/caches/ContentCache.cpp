@@ -20,6 +20,9 @@
 #include "rendering/graphics/Picture.h"
 
 namespace pag {
+// Graphics do not report their memory usage, each content is estimated with a fixed size.
+#define ESTIMATED_CONTENT_MEMORY 2048
+
 ContentCache::ContentCache(Layer* layer)
     : FrameCache<Content>(layer->startTime, layer->duration), layer(layer) {
 }
@@ -98,4 +101,8 @@ Content* ContentCache::createCache(Frame layerFrame) {
   }
   return content;
 }
-}  // namespace pag
\ No newline at end of file
+
+size_t ContentCache::memoryUsage(const Content*) const {
+  return ESTIMATED_CONTENT_MEMORY;
+}
+}  // namespace pag
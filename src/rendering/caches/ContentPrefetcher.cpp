@@ -0,0 +1,94 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ContentPrefetcher.h"
+#include "rendering/caches/CacheReclaimer.h"
+#include "rendering/caches/LayerCache.h"
+#include "rendering/layers/PAGStage.h"
+
+namespace pag {
+class PrefetchTask : public Executor {
+ public:
+  PrefetchTask(ContentPrefetcher* prefetcher, std::vector<ContentPrefetcher::PrefetchItem> items)
+      : prefetcher(prefetcher), items(std::move(items)) {
+  }
+
+ private:
+  // The prefetcher cancels the task before it is destroyed.
+  ContentPrefetcher* prefetcher = nullptr;
+  std::vector<ContentPrefetcher::PrefetchItem> items = {};
+
+  void execute() override {
+    CacheReclaimer::Enter();
+    for (auto& item : items) {
+      if (!item.layerCache->contentVisible(item.contentFrame)) {
+        continue;
+      }
+      item.layerCache->getMasks(item.contentFrame);
+      item.layerCache->getContent(item.contentFrame);
+      prefetcher->_prefetchedFrames++;
+    }
+    CacheReclaimer::Leave();
+  }
+};
+
+void ContentPrefetcher::CollectItems(PAGComposition* composition, int depth,
+                                     std::vector<PrefetchItem>* items) {
+  for (auto& pagLayer : composition->layers) {
+    if (pagLayer->_excludedFromTimeline) {
+      continue;
+    }
+    // The replaced contents are not created by the LayerCache.
+    if (!pagLayer->contentModified()) {
+      auto duration = pagLayer->layer->duration;
+      for (int i = 1; i <= depth; i++) {
+        // Assumes the content frame advances by one with the root composition, which holds for the
+        // layers sharing the frame rate of their parents.
+        auto contentFrame = pagLayer->contentFrame + i;
+        if (contentFrame >= 0 && contentFrame < duration) {
+          items->push_back({pagLayer, pagLayer->layerCache, contentFrame});
+        }
+      }
+    }
+    if (pagLayer->layerType() == LayerType::PreCompose) {
+      CollectItems(static_cast<PAGComposition*>(pagLayer.get()), depth, items);
+    }
+  }
+}
+
+ContentPrefetcher::~ContentPrefetcher() {
+  if (task) {
+    task->cancel();
+  }
+}
+
+void ContentPrefetcher::prefetch(PAGStage* stage) {
+  if (task && task->isRunning()) {
+    return;
+  }
+  std::vector<PrefetchItem> items = {};
+  CollectItems(stage, _depth, &items);
+  if (items.empty()) {
+    task = nullptr;
+    return;
+  }
+  task = Task::Make(std::make_unique<PrefetchTask>(this, std::move(items)));
+  // The contents are only needed by the upcoming frames.
+  task->run(TaskPriority::Low);
+}
+}  // namespace pag
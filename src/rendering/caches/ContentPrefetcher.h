@@ -0,0 +1,81 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include "base/utils/Task.h"
+#include "pag/pag.h"
+
+namespace pag {
+class PAGStage;
+class LayerCache;
+
+/**
+ * ContentPrefetcher records the contents of the upcoming frames on a worker thread. The contents,
+ * transforms and masks of the layers are created by their LayerCaches, which are shared by the File
+ * and guarded by locks, so they can be created ahead of time while the current frame is being
+ * submitted to the GPU on the rendering thread. Assembling the Graphic of the upcoming frame then
+ * only needs to pick up the cached contents.
+ */
+class ContentPrefetcher {
+ public:
+  static constexpr int MaxDepth = 4;
+
+  ~ContentPrefetcher();
+
+  int depth() const {
+    return _depth;
+  }
+
+  void setDepth(int value) {
+    _depth = value;
+  }
+
+  /**
+   * Collects the layers of the stage and records their contents for the next depth() frames on a
+   * worker thread. It must be called with the stage locked, and returns immediately. The request is
+   * ignored if the previous one is still running.
+   */
+  void prefetch(PAGStage* stage);
+
+  /**
+   * Returns the number of layer frames recorded on worker threads so far.
+   */
+  int64_t prefetchedFrames() const {
+    return _prefetchedFrames;
+  }
+
+ private:
+  struct PrefetchItem {
+    // Keeps the layer alive, which owns the LayerCache directly or through its file.
+    std::shared_ptr<PAGLayer> pagLayer = nullptr;
+    LayerCache* layerCache = nullptr;
+    Frame contentFrame = 0;
+  };
+
+  int _depth = 1;
+  std::atomic<int64_t> _prefetchedFrames = {0};
+  std::shared_ptr<Task> task = nullptr;
+
+  static void CollectItems(PAGComposition* composition, int depth,
+                           std::vector<PrefetchItem>* items);
+
+  friend class PrefetchTask;
+};
+}  // namespace pag
@@ -20,10 +20,12 @@
 
 #include <unordered_map>
 #include "pag/file.h"
+#include "rendering/caches/CacheReclaimer.h"
+#include "rendering/caches/FrameCacheBudget.h"
 
 namespace pag {
 template <typename T>
-class FrameCache : public Cache {
+class FrameCache : public Cache, public BudgetedCache {
  public:
   explicit FrameCache(Frame startTime, Frame duration) : startTime(startTime), duration(duration) {
     if (duration <= 0) {
@@ -35,6 +37,9 @@ class FrameCache : public Cache {
   }
 
   ~FrameCache() override {
+    if (budget) {
+      budget->remove(this);
+    }
     for (auto& item : frames) {
       delete item.second;
     }
@@ -48,12 +53,35 @@ class FrameCache : public Cache {
     if (contentFrame < 0) {
       contentFrame = 0;
     }
-    std::lock_guard<std::mutex> autoLock(locker);
-    auto cache = frames[contentFrame];
-    if (cache == nullptr) {
-      cache = createCache(contentFrame + startTime);
-      frames[contentFrame] = cache;
+    T* cache = nullptr;
+    size_t memory = 0;
+    bool created = false;
+    FrameCacheBudget* currentBudget = nullptr;
+    // Creating an entry may render the caches of nested compositions, their evictions are deferred
+    // until this thread has released the locks of all the caches still creating their entries.
+    FrameCacheBudget::BeginCreation();
+    {
+      std::lock_guard<std::mutex> autoLock(locker);
+      currentBudget = budget;
+      auto result = frames.find(contentFrame);
+      if (result != frames.end()) {
+        cache = result->second;
+      } else {
+        cache = createCache(contentFrame + startTime);
+        frames[contentFrame] = cache;
+        created = true;
+        memory = currentBudget ? memoryUsage(cache) : 0;
+      }
     }
+    if (currentBudget != nullptr) {
+      if (!created) {
+        currentBudget->touch(this, contentFrame);
+      } else {
+        currentBudget->insert(this, contentFrame, memory);
+        currentBudget->evict(true);
+      }
+    }
+    FrameCacheBudget::EndCreation();
     return cache;
   }
 
@@ -61,6 +89,21 @@ class FrameCache : public Cache {
     return &staticTimeRanges;
   }
 
+  /**
+   * Sets the budget to account the memory usage of this cache to, the existing entries are
+   * accounted immediately.
+   */
+  void setBudget(FrameCacheBudget* value) {
+    std::lock_guard<std::mutex> autoLock(locker);
+    if (budget != nullptr || value == nullptr) {
+      return;
+    }
+    budget = value;
+    for (auto& item : frames) {
+      budget->insert(this, item.first, memoryUsage(item.second));
+    }
+  }
+
  protected:
   Frame startTime = 0;
   Frame duration = 1;
@@ -68,8 +111,31 @@ class FrameCache : public Cache {
 
   virtual T* createCache(Frame layerFrame) = 0;
 
+  /**
+   * Returns the estimated memory usage of the specified cache in bytes.
+   */
+  virtual size_t memoryUsage(const T*) const {
+    return sizeof(T);
+  }
+
+  void evict(Frame frame) override {
+    T* cache = nullptr;
+    {
+      std::lock_guard<std::mutex> autoLock(locker);
+      auto result = frames.find(frame);
+      if (result == frames.end()) {
+        return;
+      }
+      cache = result->second;
+      frames.erase(result);
+    }
+    // Other threads rendering the same file may still be using it.
+    CacheReclaimer::Retire([cache]() { delete cache; });
+  }
+
  private:
   std::mutex locker = {};
   std::unordered_map<Frame, T*> frames;
+  FrameCacheBudget* budget = nullptr;
 };
 }  // namespace pag
@@ -0,0 +1,194 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FrameCacheBudget.h"
+#include <algorithm>
+#include <vector>
+#include "rendering/caches/LayerCache.h"
+
+namespace pag {
+// Layers only know their containing compositions, this map finds the budget of a layer by them.
+static std::mutex budgetLocker = {};
+static std::unordered_map<Composition*, FrameCacheBudget*> compositionBudgets = {};
+// The depth of the nested cache creations on the current thread, and the budgets whose evictions
+// are deferred until the outermost creation ends.
+static thread_local int CreationDepth = 0;
+static thread_local std::vector<FrameCacheBudget*> DeferredBudgets = {};
+
+FrameCacheBudget* FrameCacheBudget::Get(File* file) {
+  if (file == nullptr) {
+    return nullptr;
+  }
+  FrameCacheBudget* budget = nullptr;
+  {
+    std::lock_guard<std::mutex> autoLock(file->locker);
+    if (file->cache != nullptr) {
+      return static_cast<FrameCacheBudget*>(file->cache);
+    }
+    budget = new FrameCacheBudget(file);
+    file->cache = budget;
+  }
+  // The layer caches created from now on find the budget by their compositions, the ones created
+  // earlier are attached here.
+  budget->attachLayerCaches();
+  return budget;
+}
+
+FrameCacheBudget* FrameCacheBudget::Find(Layer* layer) {
+  Composition* composition = layer->containingComposition;
+  if (composition == nullptr && layer->type() == LayerType::PreCompose) {
+    // The root layer of a file has no containing composition.
+    composition = static_cast<PreComposeLayer*>(layer)->composition;
+  }
+  std::lock_guard<std::mutex> autoLock(budgetLocker);
+  auto result = compositionBudgets.find(composition);
+  return result != compositionBudgets.end() ? result->second : nullptr;
+}
+
+FrameCacheBudget::FrameCacheBudget(File* file) : file(file) {
+  std::lock_guard<std::mutex> autoLock(budgetLocker);
+  for (auto composition : file->compositions) {
+    compositionBudgets[composition] = this;
+  }
+}
+
+FrameCacheBudget::~FrameCacheBudget() {
+  std::lock_guard<std::mutex> autoLock(budgetLocker);
+  for (auto composition : file->compositions) {
+    auto result = compositionBudgets.find(composition);
+    if (result != compositionBudgets.end() && result->second == this) {
+      compositionBudgets.erase(result);
+    }
+  }
+}
+
+static void AttachLayerCache(Layer* layer, FrameCacheBudget* budget) {
+  std::lock_guard<std::mutex> autoLock(layer->locker);
+  if (layer->cache != nullptr) {
+    static_cast<LayerCache*>(layer->cache)->setBudget(budget);
+  }
+}
+
+void FrameCacheBudget::attachLayerCaches() {
+  AttachLayerCache(file->getRootLayer(), this);
+  for (auto composition : file->compositions) {
+    if (composition->type() != CompositionType::Vector) {
+      continue;
+    }
+    for (auto layer : static_cast<VectorComposition*>(composition)->layers) {
+      AttachLayerCache(layer, this);
+    }
+  }
+}
+
+size_t FrameCacheBudget::maxMemory() {
+  return _maxMemory;
+}
+
+void FrameCacheBudget::setMaxMemory(size_t value) {
+  _maxMemory = value;
+  evict(false);
+}
+
+size_t FrameCacheBudget::memoryUsage() {
+  std::lock_guard<std::mutex> autoLock(locker);
+  return _memoryUsage;
+}
+
+void FrameCacheBudget::insert(BudgetedCache* cache, Frame frame, size_t memory) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto& framePositions = positions[cache];
+  if (framePositions.count(frame) > 0) {
+    return;
+  }
+  entries.push_front({cache, frame, memory});
+  framePositions[frame] = entries.begin();
+  _memoryUsage += memory;
+}
+
+void FrameCacheBudget::touch(BudgetedCache* cache, Frame frame) {
+  if (_maxMemory == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto cacheResult = positions.find(cache);
+  if (cacheResult == positions.end()) {
+    return;
+  }
+  auto frameResult = cacheResult->second.find(frame);
+  if (frameResult != cacheResult->second.end()) {
+    entries.splice(entries.begin(), entries, frameResult->second);
+  }
+}
+
+void FrameCacheBudget::remove(BudgetedCache* cache) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto result = positions.find(cache);
+  if (result == positions.end()) {
+    return;
+  }
+  for (auto& item : result->second) {
+    _memoryUsage -= item.second->memory;
+    entries.erase(item.second);
+  }
+  positions.erase(result);
+}
+
+void FrameCacheBudget::evict(bool keepLatest) {
+  if (CreationDepth > 0) {
+    if (std::find(DeferredBudgets.begin(), DeferredBudgets.end(), this) == DeferredBudgets.end()) {
+      DeferredBudgets.push_back(this);
+    }
+    return;
+  }
+  std::vector<Entry> victims = {};
+  {
+    std::lock_guard<std::mutex> autoLock(locker);
+    auto limit = _maxMemory.load();
+    size_t keepCount = keepLatest ? 1 : 0;
+    while (limit > 0 && _memoryUsage > limit && entries.size() > keepCount) {
+      auto& entry = entries.back();
+      _memoryUsage -= entry.memory;
+      positions[entry.cache].erase(entry.frame);
+      victims.push_back(entry);
+      entries.pop_back();
+    }
+  }
+  // The caches lock themselves while evicting, which must not happen under the budget lock. They
+  // are only released along with the file, so they outlive the eviction.
+  for (auto& entry : victims) {
+    entry.cache->evict(entry.frame);
+  }
+}
+
+void FrameCacheBudget::BeginCreation() {
+  CreationDepth++;
+}
+
+void FrameCacheBudget::EndCreation() {
+  CreationDepth--;
+  if (CreationDepth > 0 || DeferredBudgets.empty()) {
+    return;
+  }
+  std::vector<FrameCacheBudget*> budgets = {};
+  std::swap(budgets, DeferredBudgets);
+  for (auto budget : budgets) {
+    budget->evict(true);
+  }
+}
+}  // namespace pag
@@ -0,0 +1,137 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include "pag/file.h"
+
+namespace pag {
+/**
+ * The base class of the caches whose entries are accounted to a FrameCacheBudget.
+ */
+class BudgetedCache {
+ public:
+  virtual ~BudgetedCache() = default;
+
+ protected:
+  /**
+   * Removes the entry of the specified frame. Called by the budget without holding its lock.
+   */
+  virtual void evict(Frame frame) = 0;
+
+  friend class FrameCacheBudget;
+};
+
+/**
+ * FrameCacheBudget tracks the memory used by all the per-frame caches (TransformCache, MaskCache
+ * and ContentCache) of a File. The entries of all the caches are kept in one LRU list, and once the
+ * usage exceeds the limit, the least recently used entries of the whole file are evicted.
+ */
+class FrameCacheBudget : public Cache {
+ public:
+  /**
+   * Returns the FrameCacheBudget of the specified file, creates a new one if there is none. The
+   * layer caches created before the budget are attached to it as well.
+   */
+  static FrameCacheBudget* Get(File* file);
+
+  /**
+   * Returns the FrameCacheBudget of the file containing the specified layer, returns nullptr if
+   * the budget of the file has not been created yet.
+   */
+  static FrameCacheBudget* Find(Layer* layer);
+
+  ~FrameCacheBudget() override;
+
+  /**
+   * Returns the maximum memory in bytes for the per-frame caches, 0 means unlimited. The default
+   * value is 0.
+   */
+  size_t maxMemory();
+
+  /**
+   * Sets the maximum memory in bytes for the per-frame caches, evicts the least recently used
+   * entries immediately if the current usage exceeds the new limit.
+   */
+  void setMaxMemory(size_t value);
+
+  /**
+   * Returns the memory in bytes currently used by the per-frame caches.
+   */
+  size_t memoryUsage();
+
+  /**
+   * Accounts a newly created entry of the cache as the most recently used one.
+   */
+  void insert(BudgetedCache* cache, Frame frame, size_t memory);
+
+  /**
+   * Marks the entry of the cache as the most recently used one. The order is only tracked while
+   * there is a limit, the entries hit without a limit keep their insertion order.
+   */
+  void touch(BudgetedCache* cache, Frame frame);
+
+  /**
+   * Removes all the entries of the cache from the budget, called before the cache is released.
+   */
+  void remove(BudgetedCache* cache);
+
+  /**
+   * Evicts the least recently used entries until the usage fits the limit. The most recently used
+   * entry is kept if keepLatest is true, which is the one just requested by the caller. If the
+   * current thread is creating a cache entry, the eviction is deferred until EndCreation() returns
+   * to the outermost level, since the caches creating their entries are locked by this thread.
+   */
+  void evict(bool keepLatest);
+
+  /**
+   * Marks the start of creating a cache entry on the current thread. Creating the content of a
+   * composition renders the caches of its layers, which may nest any number of levels.
+   */
+  static void BeginCreation();
+
+  /**
+   * Marks the end of creating a cache entry on the current thread. It must be called after the
+   * cache has released its lock, the deferred evictions are run once the outermost creation ends.
+   */
+  static void EndCreation();
+
+ private:
+  struct Entry {
+    BudgetedCache* cache = nullptr;
+    Frame frame = 0;
+    size_t memory = 0;
+  };
+
+  File* file = nullptr;
+  std::mutex locker = {};
+  std::atomic_size_t _maxMemory = {0};
+  size_t _memoryUsage = 0;
+  // The most recently used entries are at the front.
+  std::list<Entry> entries = {};
+  std::unordered_map<BudgetedCache*, std::unordered_map<Frame, std::list<Entry>::iterator>>
+      positions = {};
+
+  explicit FrameCacheBudget(File* file);
+  void attachLayerCaches();
+};
+}  // namespace pag
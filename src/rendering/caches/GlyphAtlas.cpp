@@ -0,0 +1,579 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GlyphAtlas.h"
+#include <cmath>
+#include "base/utils/Log.h"
+#include "core/Mask.h"
+#include "gpu/Caps.h"
+#include "gpu/Canvas.h"
+#include "gpu/opengl/GLTexture.h"
+
+namespace pag {
+static constexpr int PageSize = 1024;
+static constexpr size_t MaxMaskPages = 8;
+static constexpr size_t MaxColorPages = 4;
+static constexpr size_t MaxDistanceFieldPages = 4;
+// The gap in pixels kept between glyphs, so that bilinear sampling never reaches the neighbours.
+static constexpr int Padding = 3;
+static constexpr float BucketsPerOctave = 4.0f;
+static constexpr float MinBucketFontSize = 1.0f;
+// The font size distance fields are generated at. It keeps the corners of most glyphs up to about
+// four times larger on screen, and a cell of a Latin or CJK glyph stays around 60px wide, so one
+// page holds a few hundred glyphs. Distance field text only lasts while the scale is animating, it
+// goes back to glyphs rasterized at the exact size once the scale settles.
+static constexpr float DistanceFieldFontSize = 48.0f;
+// The number of curve segments used to flatten quads and cubics before measuring distances.
+static constexpr int QuadSegments = 8;
+static constexpr int CubicSegments = 12;
+
+constexpr float GlyphAtlas::DistanceFieldRange;
+
+SkylinePacker::SkylinePacker(int width, int height) : width(width), height(height) {
+  reset();
+}
+
+bool SkylinePacker::addRect(int rectWidth, int rectHeight, tgfx::Point* location) {
+  if (rectWidth > width || rectHeight > height) {
+    return false;
+  }
+  auto bestIndex = skyline.size();
+  int bestWidth = width + 1;
+  int bestX = 0;
+  int bestY = height + 1;
+  for (size_t i = 0; i < skyline.size(); i++) {
+    int y = 0;
+    if (!rectFits(i, rectWidth, rectHeight, &y)) {
+      continue;
+    }
+    // Prefers the lowest position, and the narrowest segment to break ties.
+    if (y < bestY || (y == bestY && skyline[i].width < bestWidth)) {
+      bestIndex = i;
+      bestWidth = skyline[i].width;
+      bestX = skyline[i].x;
+      bestY = y;
+    }
+  }
+  if (bestIndex == skyline.size()) {
+    return false;
+  }
+  addSkylineLevel(bestIndex, bestX, bestY, rectWidth, rectHeight);
+  location->set(static_cast<float>(bestX), static_cast<float>(bestY));
+  return true;
+}
+
+void SkylinePacker::reset() {
+  skyline.clear();
+  skyline.push_back({0, 0, width});
+}
+
+bool SkylinePacker::rectFits(size_t index, int rectWidth, int rectHeight, int* y) const {
+  if (skyline[index].x + rectWidth > width) {
+    return false;
+  }
+  auto widthLeft = rectWidth;
+  auto top = skyline[index].y;
+  while (widthLeft > 0 && index < skyline.size()) {
+    top = std::max(top, skyline[index].y);
+    if (top + rectHeight > height) {
+      return false;
+    }
+    widthLeft -= skyline[index].width;
+    index++;
+  }
+  *y = top;
+  return true;
+}
+
+void SkylinePacker::addSkylineLevel(size_t index, int x, int y, int rectWidth, int rectHeight) {
+  skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(index),
+                 {x, y + rectHeight, rectWidth});
+  // Shrinks or removes the segments covered by the new one.
+  for (auto i = index + 1; i < skyline.size(); i++) {
+    auto& previous = skyline[i - 1];
+    auto& current = skyline[i];
+    auto right = previous.x + previous.width;
+    if (current.x >= right) {
+      break;
+    }
+    auto shrink = right - current.x;
+    current.x += shrink;
+    current.width -= shrink;
+    if (current.width > 0) {
+      break;
+    }
+    skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+    i--;
+  }
+  // Merges the neighbouring segments at the same height.
+  for (size_t i = 0; i + 1 < skyline.size();) {
+    if (skyline[i].y == skyline[i + 1].y) {
+      skyline[i].width += skyline[i + 1].width;
+      skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+    } else {
+      i++;
+    }
+  }
+}
+
+GlyphPage::GlyphPage(std::shared_ptr<tgfx::Surface> surface, GlyphPageType type)
+    : surface(std::move(surface)), _type(type),
+      packer(this->surface->width(), this->surface->height()) {
+}
+
+static float BucketIndex(float fontSize) {
+  fontSize = std::max(fontSize, MinBucketFontSize);
+  // The small bias keeps the exact bucket sizes from being rounded up to the next bucket.
+  return ceilf(log2f(fontSize) * BucketsPerOctave - 0.001f);
+}
+
+float GlyphAtlas::BucketFontSize(float fontSize) {
+  return powf(2.0f, BucketIndex(fontSize) / BucketsPerOctave);
+}
+
+static void ComputeGlyphKey(tgfx::BytesKey* glyphKey, const GlyphHandle& glyph,
+                            GlyphPageType type, float rasterFontSize) {
+  auto font = glyph->getFont();
+  glyphKey->write(font.getTypeface()->uniqueID());
+  glyphKey->write(static_cast<uint32_t>(glyph->getGlyphID()));
+  glyphKey->write(static_cast<uint32_t>(glyph->getStyle()));
+  glyphKey->write(static_cast<uint32_t>(font.isFauxBold()) |
+                  (static_cast<uint32_t>(font.isFauxItalic()) << 1) |
+                  (static_cast<uint32_t>(type) << 2));
+  glyphKey->write(rasterFontSize);
+  if (glyph->getStyle() == TextStyle::Stroke) {
+    // The stroke width scales with the font size, so only their ratio matters.
+    glyphKey->write(glyph->getStrokeWidth() / font.getSize());
+  }
+}
+
+struct PendingGlyph {
+  GlyphHandle glyph = nullptr;
+  float rasterScale = 1.0f;
+  tgfx::Point position = tgfx::Point::Zero();
+};
+
+static std::shared_ptr<tgfx::TextBlob> MakeTextBlob(const PendingGlyph& item) {
+  auto glyphID = item.glyph->getGlyphID();
+  return tgfx::TextBlob::MakeFrom(&glyphID, &item.position, 1, item.glyph->getFont());
+}
+
+static void DrawMaskGlyphs(tgfx::Context* context, tgfx::Canvas* canvas,
+                           const std::vector<PendingGlyph>& glyphs, const tgfx::Rect& bounds) {
+  auto mask = tgfx::Mask::Make(static_cast<int>(bounds.width()), static_cast<int>(bounds.height()));
+  if (mask == nullptr) {
+    LOGE("GlyphAtlas: create mask failed.");
+    return;
+  }
+  for (auto& item : glyphs) {
+    auto matrix = tgfx::Matrix::MakeScale(item.rasterScale);
+    matrix.postTranslate(-bounds.x(), -bounds.y());
+    mask->setMatrix(matrix);
+    auto blob = MakeTextBlob(item);
+    if (item.glyph->getStyle() == TextStyle::Stroke) {
+      mask->strokeText(blob.get(), tgfx::Stroke(item.glyph->getStrokeWidth()));
+    } else {
+      mask->fillText(blob.get());
+    }
+  }
+  auto texture = mask->makeTexture(context);
+  if (texture == nullptr) {
+    return;
+  }
+  // Empty pixels of the mask leave the glyphs already in the page untouched.
+  canvas->drawTexture(texture.get(), tgfx::Matrix::MakeTrans(bounds.x(), bounds.y()));
+}
+
+static void DrawColorGlyphs(tgfx::Canvas* canvas, const std::vector<PendingGlyph>& glyphs) {
+  tgfx::Paint paint = {};
+  auto totalMatrix = canvas->getMatrix();
+  for (auto& item : glyphs) {
+    auto glyphID = item.glyph->getGlyphID();
+    canvas->setMatrix(totalMatrix);
+    canvas->concat(tgfx::Matrix::MakeScale(item.rasterScale));
+    canvas->drawGlyphs(&glyphID, &item.position, 1, item.glyph->getFont(), paint);
+  }
+  canvas->setMatrix(totalMatrix);
+}
+
+struct Edge {
+  tgfx::Point start = tgfx::Point::Zero();
+  tgfx::Point end = tgfx::Point::Zero();
+};
+
+static void FlattenPath(const tgfx::Path& path, std::vector<Edge>* edges) {
+  auto startPoint = tgfx::Point::Zero();
+  auto lastPoint = tgfx::Point::Zero();
+  auto addEdge = [&](const tgfx::Point& point) {
+    edges->push_back({lastPoint, point});
+    lastPoint = point;
+  };
+  // Contours are closed implicitly when they are filled.
+  auto closeContour = [&]() {
+    if (lastPoint != startPoint) {
+      addEdge(startPoint);
+    }
+  };
+  path.decompose([&](tgfx::PathVerb verb, const tgfx::Point points[4], void*) {
+    switch (verb) {
+      case tgfx::PathVerb::Move:
+        closeContour();
+        startPoint = lastPoint = points[0];
+        break;
+      case tgfx::PathVerb::Line:
+        addEdge(points[1]);
+        break;
+      case tgfx::PathVerb::Quad:
+        for (int i = 1; i <= QuadSegments; i++) {
+          auto t = static_cast<float>(i) / QuadSegments;
+          auto u = 1 - t;
+          addEdge({u * u * points[0].x + 2 * u * t * points[1].x + t * t * points[2].x,
+                   u * u * points[0].y + 2 * u * t * points[1].y + t * t * points[2].y});
+        }
+        break;
+      case tgfx::PathVerb::Cubic:
+        for (int i = 1; i <= CubicSegments; i++) {
+          auto t = static_cast<float>(i) / CubicSegments;
+          auto u = 1 - t;
+          auto a = u * u * u;
+          auto b = 3 * u * u * t;
+          auto c = 3 * u * t * t;
+          auto d = t * t * t;
+          addEdge({a * points[0].x + b * points[1].x + c * points[2].x + d * points[3].x,
+                   a * points[0].y + b * points[1].y + c * points[2].y + d * points[3].y});
+        }
+        break;
+      case tgfx::PathVerb::Close:
+        closeContour();
+        break;
+    }
+  });
+  closeContour();
+}
+
+static float DistanceToEdge(float x, float y, const Edge& edge) {
+  auto dx = edge.end.x - edge.start.x;
+  auto dy = edge.end.y - edge.start.y;
+  auto lengthSquared = dx * dx + dy * dy;
+  auto t = 0.0f;
+  if (lengthSquared > 0) {
+    t = ((x - edge.start.x) * dx + (y - edge.start.y) * dy) / lengthSquared;
+    t = std::min(std::max(t, 0.0f), 1.0f);
+  }
+  auto px = edge.start.x + t * dx - x;
+  auto py = edge.start.y + t * dy - y;
+  return sqrtf(px * px + py * py);
+}
+
+/**
+ * Writes the signed distance field of the path into the pixels. Each pixel stores 0.5 plus the
+ * distance from its center to the outline divided by DistanceFieldRange, positive inside. Every
+ * edge only measures the pixels within half of the range around its bounds, so the cost grows with
+ * the outline length instead of the cell area, and each glyph is generated once for all scales.
+ */
+static void DrawDistanceField(const tgfx::Path& path, uint8_t* pixels, int width, int height,
+                              size_t rowBytes) {
+  std::vector<Edge> edges = {};
+  FlattenPath(path, &edges);
+  auto maxDistance = GlyphAtlas::DistanceFieldRange * 0.5f;
+  std::vector<float> distances(static_cast<size_t>(width * height), maxDistance);
+  // Only the pixels within maxDistance of an edge need to be measured against it.
+  for (auto& edge : edges) {
+    auto left = std::max(static_cast<int>(std::min(edge.start.x, edge.end.x) - maxDistance), 0);
+    auto top = std::max(static_cast<int>(std::min(edge.start.y, edge.end.y) - maxDistance), 0);
+    auto right = std::min(static_cast<int>(std::max(edge.start.x, edge.end.x) + maxDistance) + 1,
+                          width);
+    auto bottom = std::min(static_cast<int>(std::max(edge.start.y, edge.end.y) + maxDistance) + 1,
+                           height);
+    for (int y = top; y < bottom; y++) {
+      auto row = distances.data() + y * width;
+      for (int x = left; x < right; x++) {
+        auto distance = DistanceToEdge(static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f,
+                                       edge);
+        row[x] = std::min(row[x], distance);
+      }
+    }
+  }
+  // The sign comes from the winding numbers of the pixel centers, counted along each row.
+  auto evenOdd = path.getFillType() == tgfx::PathFillType::EvenOdd;
+  std::vector<std::pair<float, int>> crossings = {};
+  for (int y = 0; y < height; y++) {
+    auto centerY = static_cast<float>(y) + 0.5f;
+    crossings.clear();
+    for (auto& edge : edges) {
+      auto minY = std::min(edge.start.y, edge.end.y);
+      auto maxY = std::max(edge.start.y, edge.end.y);
+      if (centerY < minY || centerY >= maxY) {
+        continue;
+      }
+      auto t = (centerY - edge.start.y) / (edge.end.y - edge.start.y);
+      auto x = edge.start.x + t * (edge.end.x - edge.start.x);
+      crossings.emplace_back(x, edge.end.y > edge.start.y ? 1 : -1);
+    }
+    std::sort(crossings.begin(), crossings.end());
+    size_t crossingIndex = 0;
+    int winding = 0;
+    auto row = pixels + static_cast<size_t>(y) * rowBytes;
+    for (int x = 0; x < width; x++) {
+      auto centerX = static_cast<float>(x) + 0.5f;
+      while (crossingIndex < crossings.size() && crossings[crossingIndex].first < centerX) {
+        winding += crossings[crossingIndex].second;
+        crossingIndex++;
+      }
+      auto inside = evenOdd ? (winding & 1) != 0 : winding != 0;
+      auto distance = distances[static_cast<size_t>(y * width + x)];
+      auto value = 0.5f + (inside ? distance : -distance) / GlyphAtlas::DistanceFieldRange;
+      row[x] = static_cast<uint8_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+    }
+  }
+}
+
+static void DrawDistanceFieldGlyphs(tgfx::Context* context, tgfx::Canvas* canvas,
+                                    const std::vector<PendingGlyph>& glyphs,
+                                    const tgfx::Rect& bounds) {
+  auto width = static_cast<int>(bounds.width());
+  auto height = static_cast<int>(bounds.height());
+  auto rowBytes = static_cast<size_t>(width);
+  std::vector<uint8_t> pixels(rowBytes * static_cast<size_t>(height), 0);
+  for (auto& item : glyphs) {
+    auto blob = MakeTextBlob(item);
+    tgfx::Path path = {};
+    if (item.glyph->getStyle() == TextStyle::Stroke) {
+      auto stroke = tgfx::Stroke(item.glyph->getStrokeWidth());
+      blob->getPath(&path, &stroke);
+    } else {
+      blob->getPath(&path);
+    }
+    auto matrix = tgfx::Matrix::MakeScale(item.rasterScale);
+    matrix.postTranslate(-bounds.x(), -bounds.y());
+    path.transform(matrix);
+    // The fields of neighbouring glyphs never overlap, so each glyph only writes into its cell.
+    auto cell = path.getBounds();
+    auto maxDistance = GlyphAtlas::DistanceFieldRange * 0.5f;
+    cell.outset(maxDistance, maxDistance);
+    cell.roundOut();
+    if (!cell.intersect(tgfx::Rect::MakeWH(static_cast<float>(width),
+                                           static_cast<float>(height)))) {
+      continue;
+    }
+    auto left = static_cast<int>(cell.left);
+    auto top = static_cast<int>(cell.top);
+    path.transform(tgfx::Matrix::MakeTrans(-cell.left, -cell.top));
+    DrawDistanceField(path, pixels.data() + static_cast<size_t>(top) * rowBytes + left,
+                      static_cast<int>(cell.width()), static_cast<int>(cell.height()), rowBytes);
+  }
+  auto texture = tgfx::Texture::MakeAlpha(context, width, height, pixels.data(), rowBytes);
+  if (texture == nullptr) {
+    LOGE("GlyphAtlas: create distance field texture failed.");
+    return;
+  }
+  canvas->drawTexture(texture.get(), tgfx::Matrix::MakeTrans(bounds.x(), bounds.y()));
+}
+
+bool GlyphAtlas::locateGlyphs(tgfx::Context* context, const std::vector<GlyphHandle>& glyphs,
+                              float scale, bool bucketed, std::vector<GlyphLocation>* locations) {
+  return findOrAddGlyphs(context, glyphs, scale, bucketed, false, locations);
+}
+
+bool GlyphAtlas::locateDistanceFieldGlyphs(tgfx::Context* context,
+                                           const std::vector<GlyphHandle>& glyphs,
+                                           std::vector<GlyphLocation>* locations) {
+  return findOrAddGlyphs(context, glyphs, 1.0f, false, true, locations);
+}
+
+bool GlyphAtlas::findOrAddGlyphs(tgfx::Context* context, const std::vector<GlyphHandle>& glyphs,
+                                 float scale, bool bucketed, bool distanceField,
+                                 std::vector<GlyphLocation>* locations) {
+  // Pages used by the glyphs located in this call must not be evicted until the call returns.
+  auto lockedSince = ++useCounter;
+  locations->clear();
+  locations->reserve(glyphs.size());
+  std::unordered_map<GlyphPage*, std::vector<PendingGlyph>> pendingGlyphs = {};
+  std::unordered_map<GlyphPage*, tgfx::Rect> dirtyBounds = {};
+  bool success = true;
+  for (auto& glyph : glyphs) {
+    auto font = glyph->getFont();
+    auto type = GlyphPageType::DistanceField;
+    auto rasterFontSize = DistanceFieldFontSize;
+    // Distance fields extend beyond the outlines of glyphs by half of their range.
+    int margin = static_cast<int>(ceilf(DistanceFieldRange * 0.5f));
+    if (!distanceField) {
+      type = font.getTypeface()->hasColor() ? GlyphPageType::Color : GlyphPageType::Mask;
+      rasterFontSize = font.getSize() * scale;
+      if (bucketed) {
+        rasterFontSize = BucketFontSize(rasterFontSize);
+      }
+      margin = 0;
+    }
+    auto rasterScale = rasterFontSize / font.getSize();
+    tgfx::BytesKey glyphKey = {};
+    ComputeGlyphKey(&glyphKey, glyph, type, rasterFontSize);
+    auto result = glyphLocations.find(glyphKey);
+    if (result != glyphLocations.end()) {
+      touchPage(result->second.page);
+      locations->push_back(result->second);
+      continue;
+    }
+    float strokeWidth = 0;
+    if (glyph->getStyle() == TextStyle::Stroke) {
+      strokeWidth = glyph->getStrokeWidth();
+    }
+    auto glyphBounds = glyph->getBounds();
+    glyphBounds.outset(strokeWidth, strokeWidth);
+    auto width = glyphBounds.width() * rasterScale;
+    auto height = glyphBounds.height() * rasterScale;
+    auto cellWidth = static_cast<int>(ceilf(width)) + margin * 2 + Padding;
+    auto cellHeight = static_cast<int>(ceilf(height)) + margin * 2 + Padding;
+    tgfx::Point point = {};
+    auto page = addRect(context, type, cellWidth, cellHeight, lockedSince, &point);
+    if (page == nullptr) {
+      success = false;
+      break;
+    }
+    auto offset = static_cast<float>(Padding + margin);
+    GlyphLocation location = {};
+    location.page = page;
+    location.location = tgfx::Rect::MakeXYWH(point.x + offset, point.y + offset, width, height);
+    glyphLocations[glyphKey] = location;
+    page->glyphKeys.push_back(glyphKey);
+    locations->push_back(location);
+    PendingGlyph pendingGlyph = {};
+    pendingGlyph.glyph = glyph;
+    pendingGlyph.rasterScale = rasterScale;
+    pendingGlyph.position.set(location.location.x() / rasterScale - glyphBounds.x(),
+                              location.location.y() / rasterScale - glyphBounds.y());
+    pendingGlyphs[page].push_back(pendingGlyph);
+    auto cell = tgfx::Rect::MakeXYWH(point.x, point.y, static_cast<float>(cellWidth),
+                                     static_cast<float>(cellHeight));
+    auto bounds = dirtyBounds.find(page);
+    if (bounds == dirtyBounds.end()) {
+      dirtyBounds[page] = cell;
+    } else {
+      bounds->second.join(cell);
+    }
+  }
+  // The new glyphs are registered already, they must be drawn even if the call failed.
+  for (auto& item : pendingGlyphs) {
+    auto page = item.first;
+    auto canvas = page->surface->getCanvas();
+    switch (page->_type) {
+      case GlyphPageType::Mask:
+        DrawMaskGlyphs(context, canvas, item.second, dirtyBounds[page]);
+        break;
+      case GlyphPageType::Color:
+        DrawColorGlyphs(canvas, item.second);
+        break;
+      case GlyphPageType::DistanceField:
+        DrawDistanceFieldGlyphs(context, canvas, item.second, dirtyBounds[page]);
+        break;
+    }
+  }
+  return success;
+}
+
+void GlyphAtlas::touchPage(GlyphPage* page) {
+  page->lastUsed = ++useCounter;
+}
+
+size_t GlyphAtlas::memoryUsage() const {
+  size_t usage = 0;
+  for (auto& page : pages) {
+    auto texture = page->getTexture();
+    auto bytesPerPixel = texture->getSampler()->format == tgfx::PixelFormat::ALPHA_8 ? 1 : 4;
+    usage += static_cast<size_t>(texture->width() * texture->height() * bytesPerPixel);
+  }
+  return usage;
+}
+
+static size_t MaxPageCount(GlyphPageType type) {
+  switch (type) {
+    case GlyphPageType::Mask:
+      return MaxMaskPages;
+    case GlyphPageType::Color:
+      return MaxColorPages;
+    case GlyphPageType::DistanceField:
+      return MaxDistanceFieldPages;
+  }
+}
+
+GlyphPage* GlyphAtlas::addRect(tgfx::Context* context, GlyphPageType type, int width, int height,
+                               int64_t lockedSince, tgfx::Point* location) {
+  size_t pageCount = 0;
+  GlyphPage* oldestPage = nullptr;
+  for (auto& page : pages) {
+    if (page->_type != type) {
+      continue;
+    }
+    pageCount++;
+    if (page->packer.addRect(width, height, location)) {
+      touchPage(page.get());
+      return page.get();
+    }
+    if (page->lastUsed < lockedSince &&
+        (oldestPage == nullptr || page->lastUsed < oldestPage->lastUsed)) {
+      oldestPage = page.get();
+    }
+  }
+  if (pageCount < MaxPageCount(type)) {
+    auto page = makePage(context, type);
+    if (page != nullptr) {
+      if (!page->packer.addRect(width, height, location)) {
+        return nullptr;
+      }
+      touchPage(page);
+      return page;
+    }
+  }
+  if (oldestPage == nullptr) {
+    return nullptr;
+  }
+  evictPage(oldestPage);
+  if (!oldestPage->packer.addRect(width, height, location)) {
+    return nullptr;
+  }
+  touchPage(oldestPage);
+  return oldestPage;
+}
+
+GlyphPage* GlyphAtlas::makePage(tgfx::Context* context, GlyphPageType type) {
+  auto size = std::min(PageSize, context->caps()->maxTextureSize);
+  std::shared_ptr<tgfx::Surface> surface = nullptr;
+  if (type != GlyphPageType::Color) {
+    surface = tgfx::Surface::Make(context, size, size, true);
+  }
+  if (surface == nullptr) {
+    surface = tgfx::Surface::Make(context, size, size);
+  }
+  if (surface == nullptr) {
+    return nullptr;
+  }
+  surface->getCanvas()->clear();
+  pages.push_back(std::unique_ptr<GlyphPage>(new GlyphPage(std::move(surface), type)));
+  return pages.back().get();
+}
+
+void GlyphAtlas::evictPage(GlyphPage* page) {
+  for (auto& glyphKey : page->glyphKeys) {
+    glyphLocations.erase(glyphKey);
+  }
+  page->glyphKeys.clear();
+  page->packer.reset();
+  page->_generation++;
+  page->surface->getCanvas()->clear();
+}
+}  // namespace pag
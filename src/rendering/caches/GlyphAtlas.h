@@ -0,0 +1,181 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <unordered_map>
+#include "gpu/Surface.h"
+#include "rendering/graphics/MutableGlyph.h"
+
+namespace pag {
+/**
+ * SkylinePacker packs rects into a fixed-size area with the skyline bottom-left heuristic. It keeps
+ * the top edge of the packed area as a list of horizontal segments, and places each new rect on the
+ * segment where its bottom edge ends up the lowest.
+ */
+class SkylinePacker {
+ public:
+  SkylinePacker(int width, int height);
+
+  /**
+   * Finds a location for a rect of the specified size. Returns false if there is no room left.
+   */
+  bool addRect(int width, int height, tgfx::Point* location);
+
+  /**
+   * Removes all packed rects.
+   */
+  void reset();
+
+ private:
+  struct Segment {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+  };
+
+  int width = 0;
+  int height = 0;
+  std::vector<Segment> skyline = {};
+
+  bool rectFits(size_t index, int rectWidth, int rectHeight, int* y) const;
+
+  void addSkylineLevel(size_t index, int x, int y, int rectWidth, int rectHeight);
+};
+
+enum class GlyphPageType {
+  /**
+   * Coverage masks of glyphs rasterized at a font size bucket.
+   */
+  Mask,
+  /**
+   * Color glyphs rasterized at a font size bucket.
+   */
+  Color,
+  /**
+   * Signed distance fields of glyphs, which are scale independent.
+   */
+  DistanceField
+};
+
+/**
+ * GlyphPage is a single texture of the GlyphAtlas. Its generation changes every time the page is
+ * evicted, which invalidates all the glyph locations previously handed out in the page.
+ */
+class GlyphPage {
+ public:
+  uint32_t generation() const {
+    return _generation;
+  }
+
+  GlyphPageType type() const {
+    return _type;
+  }
+
+  std::shared_ptr<tgfx::Texture> getTexture() const {
+    return surface->getTexture();
+  }
+
+ private:
+  GlyphPage(std::shared_ptr<tgfx::Surface> surface, GlyphPageType type);
+
+  std::shared_ptr<tgfx::Surface> surface = nullptr;
+  GlyphPageType _type = GlyphPageType::Mask;
+  SkylinePacker packer;
+  uint32_t _generation = 0;
+  int64_t lastUsed = 0;
+  std::vector<tgfx::BytesKey> glyphKeys = {};
+
+  friend class GlyphAtlas;
+};
+
+struct GlyphLocation {
+  GlyphPage* page = nullptr;
+  tgfx::Rect location = tgfx::Rect::MakeEmpty();
+};
+
+/**
+ * GlyphAtlas packs the rasterized glyphs of all text layers drawn on the same GPU device into a few
+ * shared pages, so identical glyphs are rasterized and uploaded only once. Glyphs are keyed by
+ * typeface, glyph ID, style and the font size they are rasterized at. That is either the exact font
+ * size they are drawn at, or the font size rounded up to a size bucket, which lets text animating
+ * its scale keep using the same glyphs until it crosses a bucket. New glyphs are appended to the
+ * existing pages, a new page is only allocated when none of them has room left, and the least
+ * recently used page is cleared once the page limit is reached. Glyphs can also be stored as signed
+ * distance fields generated at a fixed font size, which serve text animating its scale at any
+ * size. GlyphAtlas is not thread safe, it must be accessed with the device locked.
+ */
+class GlyphAtlas {
+ public:
+  /**
+   * The number of atlas pixels covered by the full range of the values stored in distance field
+   * pages. Half of it on each side of the outline still spans one screen pixel when the fields are
+   * drawn at 1/8 of their size, which keeps the edges of text down to 6px anti-aliased.
+   */
+  static constexpr float DistanceFieldRange = 8.0f;
+
+  /**
+   * Returns the rasterized font size of glyphs drawn at the specified font size, which is rounded
+   * up to the nearest size bucket.
+   */
+  static float BucketFontSize(float fontSize);
+
+  /**
+   * Returns the locations of the specified glyphs rasterized at the specified scale factor,
+   * rasterizes the missing ones into the pages first. If bucketed is true, the glyphs are
+   * rasterized at the font size bucket of the scaled font size and downscaled when drawing, which
+   * looks slightly softer than the exact size. The glyphs must either all have color or all have
+   * none. Returns false if some of the glyphs do not fit into the atlas.
+   */
+  bool locateGlyphs(tgfx::Context* context, const std::vector<GlyphHandle>& glyphs, float scale,
+                    bool bucketed, std::vector<GlyphLocation>* locations);
+
+  /**
+   * Returns the locations of the signed distance fields of the specified glyphs, generates the
+   * missing ones into the pages first. The glyphs must have no color. Returns false if some of the
+   * glyphs do not fit into the atlas.
+   */
+  bool locateDistanceFieldGlyphs(tgfx::Context* context, const std::vector<GlyphHandle>& glyphs,
+                                 std::vector<GlyphLocation>* locations);
+
+  /**
+   * Marks the specified page as used by the current frame.
+   */
+  void touchPage(GlyphPage* page);
+
+  /**
+   * Returns the total memory usage of all the pages.
+   */
+  size_t memoryUsage() const;
+
+ private:
+  std::vector<std::unique_ptr<GlyphPage>> pages = {};
+  std::unordered_map<tgfx::BytesKey, GlyphLocation, tgfx::BytesHasher> glyphLocations = {};
+  int64_t useCounter = 0;
+
+  bool findOrAddGlyphs(tgfx::Context* context, const std::vector<GlyphHandle>& glyphs, float scale,
+                       bool bucketed, bool distanceField, std::vector<GlyphLocation>* locations);
+
+  GlyphPage* addRect(tgfx::Context* context, GlyphPageType type, int width, int height,
+                     int64_t lockedSince, tgfx::Point* location);
+
+  GlyphPage* makePage(tgfx::Context* context, GlyphPageType type);
+
+  void evictPage(GlyphPage* page);
+};
+}  // namespace pag
@@ -18,6 +18,7 @@
 
 #include "LayerCache.h"
 #include "base/utils/TGFXCast.h"
+#include "rendering/caches/FrameCacheBudget.h"
 #include "rendering/caches/ImageContentCache.h"
 #include "rendering/caches/PreComposeContentCache.h"
 #include "rendering/caches/ShapeContentCache.h"
@@ -60,6 +61,7 @@ LayerCache::LayerCache(Layer* layer) : layer(layer) {
   if (!layer->masks.empty()) {
     maskCache = new MaskCache(layer);
   }
+  setBudget(FrameCacheBudget::Find(layer));
   updateStaticTimeRanges();
   maxScaleFactor = ToTGFX(layer->getMaxScaleFactor());
 }
@@ -70,6 +72,14 @@ LayerCache::~LayerCache() {
   delete contentCache;
 }
 
+void LayerCache::setBudget(FrameCacheBudget* budget) {
+  contentCache->setBudget(budget);
+  transformCache->setBudget(budget);
+  if (maskCache) {
+    maskCache->setBudget(budget);
+  }
+}
+
 Transform* LayerCache::getTransform(Frame contentFrame) {
   return transformCache->getCache(contentFrame);
 }
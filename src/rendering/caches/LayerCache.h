@@ -30,6 +30,11 @@ class LayerCache : public Cache {
 
   ~LayerCache() override;
 
+  /**
+   * Accounts the per-frame caches of the layer to the specified budget.
+   */
+  void setBudget(FrameCacheBudget* budget);
+
   Transform* getTransform(Frame contentFrame);
 
   tgfx::Path* getMasks(Frame contentFrame);
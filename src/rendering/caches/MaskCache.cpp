@@ -34,4 +34,10 @@ tgfx::Path* MaskCache::createCache(Frame layerFrame) {
   RenderMasks(maskContent, layer->masks, layerFrame);
   return maskContent;
 }
+
+size_t MaskCache::memoryUsage(const tgfx::Path* path) const {
+  size_t pointCount = 0;
+  path->decompose([&](tgfx::PathVerb, const tgfx::Point[4], void*) { pointCount += 3; });
+  return sizeof(tgfx::Path) + pointCount * sizeof(tgfx::Point);
+}
 }  // namespace pag
\ No newline at end of file
@@ -29,6 +29,8 @@ class MaskCache : public FrameCache<tgfx::Path> {
  protected:
   tgfx::Path* createCache(Frame layerFrame) override;
 
+  size_t memoryUsage(const tgfx::Path* path) const override;
+
  private:
   Layer* layer = nullptr;
 };
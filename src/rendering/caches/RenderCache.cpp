@@ -22,6 +22,7 @@
 #include "base/utils/TimeUtil.h"
 #include "base/utils/USE.h"
 #include "base/utils/UniqueID.h"
+#include "gpu/PathMaskCache.h"
 #include "rendering/caches/ImageContentCache.h"
 #include "rendering/caches/LayerCache.h"
 #include "rendering/renderers/FilterRenderer.h"
@@ -31,7 +32,10 @@ namespace pag {
 #define MAX_GRAPHICS_MEMORY 314572800
 #define PURGEABLE_GRAPHICS_MEMORY 20971520  // 20M
 #define PURGEABLE_EXPIRED_FRAME 10
+// 显存超过可清理阈值时，从 LRU 尾部最多取这么多个未使用的缓存，优先清理单位重绘耗时占用显存最多的。
+#define PURGEABLE_SAMPLE_COUNT 16
 #define SCALE_FACTOR_PRECISION 0.001f
+#define SCALE_STABLE_FRAME 10
 #define DECODING_VISIBLE_DISTANCE 500000  // 提前 500ms 秒开始解码。
 #define MIN_HARDWARE_PREPARE_TIME 100000  // 距离当前时刻小于100ms的视频启动软解转硬解优化。
 
@@ -43,7 +47,8 @@ class ImageTask : public Executor {
     }
     auto bitmap = new ImageTask(std::move(image));
     auto task = Task::Make(std::unique_ptr<ImageTask>(bitmap));
-    task->run();
+    // Images are decoded ahead of time for the frames to come.
+    task->run(TaskPriority::Low);
     return task;
   }
 
@@ -63,7 +68,8 @@ class ImageTask : public Executor {
   }
 };
 
-RenderCache::RenderCache(PAGStage* stage) : _uniqueID(UniqueID::Next()), stage(stage) {
+RenderCache::RenderCache(PAGStage* stage)
+    : _uniqueID(UniqueID::Next()), stage(stage), maxGraphicsMemory(MAX_GRAPHICS_MEMORY) {
 }
 
 RenderCache::~RenderCache() {
@@ -86,6 +92,22 @@ void RenderCache::setVideoEnabled(bool value) {
   clearAllSequenceCaches();
 }
 
+void RenderCache::setVideoLookaheadFrames(int value) {
+  _videoLookaheadFrames = std::max(value, 1);
+}
+
+void RenderCache::setVideoLookaheadMemory(size_t value) {
+  _videoLookaheadMemory = value;
+}
+
+void RenderCache::setVideoSegmentDecoders(int value) {
+  _videoSegmentDecoders = value;
+}
+
+void RenderCache::setVideoSegmentMemory(size_t value) {
+  _videoSegmentMemory = value;
+}
+
 bool RenderCache::initFilter(Filter* filter) {
   auto startTime = GetTimer();
   auto result = filter->initialize(getContext());
@@ -159,8 +181,33 @@ void RenderCache::setSnapshotEnabled(bool value) {
   clearAllSnapshots();
 }
 
+bool RenderCache::sharedCacheEnabled() const {
+  return _sharedCacheEnabled;
+}
+
+void RenderCache::setSharedCacheEnabled(bool value) {
+  if (_sharedCacheEnabled == value) {
+    return;
+  }
+  _sharedCacheEnabled = value;
+  if (!_sharedCacheEnabled) {
+    sharedCache = nullptr;
+  }
+  // 文字图集中的字形位置都指向当前的 GlyphAtlas，切换共享模式时需要一起重建。
+  textAtlases.clear();
+  glyphAtlas = nullptr;
+  graphicsMemory -= glyphAtlasMemory;
+  glyphAtlasMemory = 0;
+}
+
+void RenderCache::setMaxMemory(size_t value) {
+  maxGraphicsMemory = value;
+  purgeSnapshotsUntil(maxGraphicsMemory);
+}
+
 void RenderCache::prepareFrame() {
   usedAssets = {};
+  frameIndex++;
   resetPerformance();
   auto layerDistances = stage->findNearlyVisibleLayersIn(DECODING_VISIBLE_DISTANCE);
   for (auto& item : layerDistances) {
@@ -185,10 +232,21 @@ void RenderCache::attachToContext(tgfx::Context* current, bool forHitTest) {
   }
   context = current;
   deviceID = context->device()->uniqueID();
+  if (_sharedCacheEnabled && sharedCache == nullptr) {
+    sharedCache = SharedRenderCache::Get(context->device());
+  }
   hitTestOnly = forHitTest;
   if (hitTestOnly) {
     return;
   }
+  // Context 可能被多个 PAGPlayer 共用，每次绘制前都以当前 PAGPlayer 的设置为准。
+  context->setPathTriangulationEnabled(_pathTriangulationEnabled);
+  drawCallStart = context->drawCallCount();
+  triangulatedPathStart = context->triangulatedPathCount();
+  rasterizedPathStart = context->rasterizedPathCount();
+  pathMaskHitStart = context->pathMaskCache()->hitCount();
+  pathMaskMissStart = context->pathMaskCache()->missCount();
+  uploadedTextureStart = context->uploadedTextureBytes();
   auto removedAssets = stage->getRemovedAssets();
   for (auto assetID : removedAssets) {
     removeSnapshot(assetID);
@@ -201,6 +259,9 @@ void RenderCache::attachToContext(tgfx::Context* current, bool forHitTest) {
 
 void RenderCache::releaseAll() {
   clearAllSnapshots();
+  textAtlases.clear();
+  glyphAtlas = nullptr;
+  glyphAtlasMemory = 0;
   graphicsMemory = 0;
   clearAllSequenceCaches();
   for (auto& item : filterCaches) {
@@ -209,6 +270,7 @@ void RenderCache::releaseAll() {
   filterCaches.clear();
   delete motionBlurFilter;
   motionBlurFilter = nullptr;
+  sharedCache = nullptr;
   deviceID = 0;
 }
 
@@ -220,6 +282,16 @@ void RenderCache::detachFromContext() {
   clearExpiredSequences();
   clearExpiredBitmaps();
   clearExpiredSnapshots();
+  drawCallCount += static_cast<int64_t>(context->drawCallCount() - drawCallStart);
+  triangulatedPathCount +=
+      static_cast<int64_t>(context->triangulatedPathCount() - triangulatedPathStart);
+  rasterizedPathCount += static_cast<int64_t>(context->rasterizedPathCount() - rasterizedPathStart);
+  pathMaskCacheHits +=
+      static_cast<int64_t>(context->pathMaskCache()->hitCount() - pathMaskHitStart);
+  pathMaskCacheMisses +=
+      static_cast<int64_t>(context->pathMaskCache()->missCount() - pathMaskMissStart);
+  uploadedTextureBytes +=
+      static_cast<int64_t>(context->uploadedTextureBytes() - uploadedTextureStart);
   auto currentTimestamp = GetTimer();
   context->purgeResourcesNotUsedIn(currentTimestamp - lastTimestamp);
   lastTimestamp = currentTimestamp;
@@ -251,26 +323,41 @@ Snapshot* RenderCache::getSnapshot(const Picture* image) {
     snapshot = nullptr;
   }
   if (snapshot) {
-    snapshot->idleFrames = 0;
-    auto position = std::find(snapshotLRU.begin(), snapshotLRU.end(), snapshot);
-    if (position != snapshotLRU.end()) {
-      snapshotLRU.erase(position);
-    }
-    snapshotLRU.push_front(snapshot);
+    snapshot->usedFrame = frameIndex;
+    snapshotLRU.splice(snapshotLRU.begin(), snapshotLRU, snapshot->lruPosition);
     return snapshot;
   }
-  if (scaleFactor < SCALE_FACTOR_PRECISION || graphicsMemory >= MAX_GRAPHICS_MEMORY) {
+  if (scaleFactor < SCALE_FACTOR_PRECISION) {
     return nullptr;
   }
-  auto newSnapshot = image->makeSnapshot(this, scaleFactor);
+  if (graphicsMemory >= maxGraphicsMemory) {
+    purgeSnapshotsUntil(maxGraphicsMemory);
+    if (graphicsMemory >= maxGraphicsMemory) {
+      return nullptr;
+    }
+  }
+  std::unique_ptr<Snapshot> newSnapshot = nullptr;
+  if (sharedCache) {
+    newSnapshot = sharedCache->findSnapshot(image->assetID, image->uniqueKey, scaleFactor);
+  }
   if (newSnapshot == nullptr) {
-    return nullptr;
+    auto startTime = GetTimer();
+    newSnapshot = image->makeSnapshot(this, scaleFactor);
+    if (newSnapshot == nullptr) {
+      return nullptr;
+    }
+    // 共享命中的快照沿用首次生成时的耗时，清理缓存时按实际的重绘代价排序。
+    newSnapshot->makingTime = GetTimer() - startTime;
+    if (sharedCache) {
+      sharedCache->addSnapshot(image->assetID, image->uniqueKey, newSnapshot.get());
+    }
   }
   snapshot = newSnapshot.release();
   snapshot->assetID = image->assetID;
   snapshot->makerKey = image->uniqueKey;
+  snapshot->usedFrame = frameIndex;
   graphicsMemory += snapshot->memoryUsage();
-  snapshotLRU.push_front(snapshot);
+  snapshot->lruPosition = snapshotLRU.insert(snapshotLRU.begin(), snapshot);
   snapshotCaches[image->assetID] = snapshot;
   return snapshot;
 }
@@ -280,10 +367,7 @@ void RenderCache::removeSnapshot(ID assetID) {
   if (snapshot == snapshotCaches.end()) {
     return;
   }
-  auto position = std::find(snapshotLRU.begin(), snapshotLRU.end(), snapshot->second);
-  if (position != snapshotLRU.end()) {
-    snapshotLRU.erase(position);
-  }
+  snapshotLRU.erase(snapshot->second->lruPosition);
   graphicsMemory -= snapshot->second->memoryUsage();
   delete snapshot->second;
   snapshotCaches.erase(assetID);
@@ -294,39 +378,62 @@ TextAtlas* RenderCache::getTextAtlas(ID assetID) {
   if (textAtlas == textAtlases.end()) {
     return nullptr;
   }
-  return textAtlas->second;
+  return textAtlas->second.get();
 }
 
 TextAtlas* RenderCache::getTextAtlas(const TextGlyphs* textGlyphs) {
   auto maxScaleFactor = stage->getAssetMaxScale(textGlyphs->assetID());
   auto textAtlas = getTextAtlas(textGlyphs->assetID());
-  if (textAtlas && (textAtlas->textGlyphsID() != textGlyphs->id() ||
-                    fabsf(textAtlas->scaleFactor() - maxScaleFactor) > SCALE_FACTOR_PRECISION)) {
-    removeTextAtlas(textGlyphs->assetID());
-    textAtlas = nullptr;
+  bool bucketed = false;
+  bool distanceField = false;
+  if (textAtlas) {
+    auto scaleChanged = fabsf(textAtlas->scaleFactor() - maxScaleFactor) > SCALE_FACTOR_PRECISION;
+    auto expired = textAtlas->textGlyphsID() != textGlyphs->id() || !textAtlas->isValid();
+    if (textAtlas->bucketed() || textAtlas->distanceField()) {
+      // 缩放动画中的文字连续多帧缩放因子不变后，改回按精确字号光栅化的字形，恢复精确的字形边缘。
+      auto animating = textAtlas->updateScale(maxScaleFactor, frameIndex) < SCALE_STABLE_FRAME;
+      distanceField = animating && textAtlas->distanceField() && _distanceFieldTextEnabled;
+      bucketed = animating && !distanceField;
+      expired = expired || !animating || distanceField != textAtlas->distanceField() ||
+                (scaleChanged && !textAtlas->scaleInvariant());
+    } else if (scaleChanged) {
+      // 缩放因子发生变化的文字按字号档位光栅化，开启距离场时改用距离场绘制，继续缩放时只有跨档位
+      // 的字形才需要重新光栅化。
+      distanceField = _distanceFieldTextEnabled;
+      bucketed = !distanceField;
+      expired = true;
+    }
+    if (expired) {
+      removeTextAtlas(textGlyphs->assetID());
+      textAtlas = nullptr;
+    }
   }
   if (textAtlas) {
+    textAtlas->touchPages(glyphAtlas.get());
     return textAtlas;
   }
   if (maxScaleFactor < SCALE_FACTOR_PRECISION) {
     return nullptr;
   }
-  textAtlas = TextAtlas::Make(textGlyphs, this, maxScaleFactor).release();
-  if (textAtlas) {
-    graphicsMemory += textAtlas->memoryUsage();
-    textAtlases[textGlyphs->assetID()] = textAtlas;
+  if (glyphAtlas == nullptr) {
+    glyphAtlas = sharedCache ? sharedCache->getGlyphAtlas() : std::make_shared<GlyphAtlas>();
+  }
+  auto oldAtlasMemory = glyphAtlas->memoryUsage();
+  auto newTextAtlas = TextAtlas::Make(textGlyphs, glyphAtlas.get(), context, maxScaleFactor,
+                                      bucketed, distanceField);
+  // GlyphAtlas 可能被多个 RenderCache 共享，每个 RenderCache 只统计由自己分配的那部分显存。
+  auto atlasMemory = glyphAtlas->memoryUsage() - oldAtlasMemory;
+  graphicsMemory += atlasMemory;
+  glyphAtlasMemory += atlasMemory;
+  if (newTextAtlas == nullptr) {
+    return nullptr;
   }
-  return textAtlas;
+  textAtlases[textGlyphs->assetID()] = std::move(newTextAtlas);
+  return textAtlases[textGlyphs->assetID()].get();
 }
 
 void RenderCache::removeTextAtlas(ID assetID) {
-  auto textAtlas = textAtlases.find(assetID);
-  if (textAtlas == textAtlases.end()) {
-    return;
-  }
-  graphicsMemory -= textAtlas->second->memoryUsage();
-  delete textAtlas->second;
-  textAtlases.erase(textAtlas);
+  textAtlases.erase(assetID);
 }
 
 void RenderCache::clearAllSnapshots() {
@@ -342,20 +449,47 @@ void RenderCache::clearExpiredSnapshots() {
   while (!snapshotLRU.empty()) {
     auto snapshot = snapshotLRU.back();
     // 只有 Snapshot 数量可能会比较多，使用 LRU
-    // 来避免遍历完整的列表，遇到第一个用过的就可以取消遍历。
-    if (usedAssets.count((snapshot->assetID) > 0)) {
+    // 来避免遍历完整的列表，遇到第一个未过期的就可以取消遍历。
+    if (frameIndex - snapshot->usedFrame < PURGEABLE_EXPIRED_FRAME) {
       break;
     }
-    snapshot->idleFrames++;
-    if (snapshot->idleFrames < PURGEABLE_EXPIRED_FRAME &&
-        graphicsMemory < PURGEABLE_GRAPHICS_MEMORY) {
-      // 总显存占用未超过20M且所有缓存均未超过10帧未使用，跳过清理。
+    removeSnapshot(snapshot->assetID);
+  }
+  // 总显存占用超过可清理阈值时，继续清理当前帧未使用的缓存。
+  purgeSnapshotsUntil(std::min(static_cast<size_t>(PURGEABLE_GRAPHICS_MEMORY), maxGraphicsMemory));
+}
+
+void RenderCache::purgeSnapshotsUntil(size_t targetMemory) {
+  while (graphicsMemory > targetMemory) {
+    auto snapshot = findPurgeableSnapshot();
+    if (snapshot == nullptr) {
       break;
     }
     removeSnapshot(snapshot->assetID);
   }
 }
 
+Snapshot* RenderCache::findPurgeableSnapshot() const {
+  // 在 LRU 尾部的若干个未使用的缓存中，挑选释放显存最多而重新绘制耗时最少的一个。
+  Snapshot* purgeableSnapshot = nullptr;
+  float maxScore = 0;
+  int sampleCount = 0;
+  for (auto i = snapshotLRU.rbegin(); i != snapshotLRU.rend(); i++) {
+    auto snapshot = *i;
+    if (snapshot->usedFrame == frameIndex || sampleCount++ >= PURGEABLE_SAMPLE_COUNT) {
+      break;
+    }
+    auto score = static_cast<float>(snapshot->memoryUsage()) *
+                 static_cast<float>(frameIndex - snapshot->usedFrame) /
+                 static_cast<float>(snapshot->makingTime + 1);
+    if (purgeableSnapshot == nullptr || score > maxScore) {
+      purgeableSnapshot = snapshot;
+      maxScore = score;
+    }
+  }
+  return purgeableSnapshot;
+}
+
 void RenderCache::prepareImage(ID assetID, std::shared_ptr<tgfx::Image> image) {
   usedAssets.insert(assetID);
   if (imageTasks.count(assetID) != 0 || snapshotCaches.count(assetID) != 0) {
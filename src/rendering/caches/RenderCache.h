@@ -20,6 +20,7 @@
 
 #include <memory>
 #include <unordered_set>
+#include "SharedRenderCache.h"
 #include "TextAtlas.h"
 #include "TextGlyphs.h"
 #include "gpu/Device.h"
@@ -59,6 +60,20 @@ class RenderCache : public Performance {
     return graphicsMemory;
   }
 
+  /**
+   * Returns the maximum graphics memory this cache can use, no new snapshots are created once the
+   * limit is reached.
+   */
+  size_t maxMemory() const {
+    return maxGraphicsMemory;
+  }
+
+  /**
+   * Sets the maximum graphics memory this cache can use. The snapshots not used by current frame
+   * are purged immediately if the memory usage exceeds the new limit.
+   */
+  void setMaxMemory(size_t value);
+
   /**
    * Returns the GPU context associated with this cache.
    */
@@ -76,6 +91,17 @@ class RenderCache : public Performance {
    */
   void setSnapshotEnabled(bool value);
 
+  /**
+   * If set to true, the snapshots and the glyph atlas are shared with other RenderCaches attached
+   * to the same GPU device. The default value is false.
+   */
+  bool sharedCacheEnabled() const;
+
+  /**
+   * Set the value of sharedCacheEnabled property.
+   */
+  void setSharedCacheEnabled(bool value);
+
   /**
    * Returns true if there is snapshot cache available for specified asset ID.
    */
@@ -124,6 +150,111 @@ class RenderCache : public Performance {
 
   void setVideoEnabled(bool value);
 
+  /**
+   * Returns the maximum number of frames decoded ahead of the playhead for each video sequence.
+   * The default value is 3.
+   */
+  int videoLookaheadFrames() const {
+    return _videoLookaheadFrames;
+  }
+
+  /**
+   * Set the value of videoLookaheadFrames property.
+   */
+  void setVideoLookaheadFrames(int value);
+
+  /**
+   * Returns the maximum bytes of the frames decoded ahead of the playhead for each video sequence,
+   * which may reduce the number of frames decoded ahead for large videos. The default value is 24M.
+   */
+  size_t videoLookaheadMemory() const {
+    return _videoLookaheadMemory;
+  }
+
+  /**
+   * Set the value of videoLookaheadMemory property.
+   */
+  void setVideoLookaheadMemory(size_t value);
+
+  /**
+   * Returns the maximum number of segments decoded in parallel for each video sequence, where a
+   * segment starts at a keyframe and ends before the next one. Each segment uses a software decoder
+   * of its own and keeps its frames in memory until they are drawn, which only pays off when
+   * drawing all frames in order on a machine without hardware decoders, such as exporting videos.
+   * Values less than 2 disable it. The default value is 0.
+   */
+  int videoSegmentDecoders() const {
+    return _videoSegmentDecoders;
+  }
+
+  /**
+   * Set the value of videoSegmentDecoders property.
+   */
+  void setVideoSegmentDecoders(int value);
+
+  /**
+   * Returns the maximum bytes of the decoded frames of all the segments of each video sequence,
+   * the segments ahead of the playhead pause decoding once it is reached. The default value is
+   * 128M.
+   */
+  size_t videoSegmentMemory() const {
+    return _videoSegmentMemory;
+  }
+
+  /**
+   * Set the value of videoSegmentMemory property.
+   */
+  void setVideoSegmentMemory(size_t value);
+
+  /**
+   * If set to true, the Fast Blur effects and the Drop Shadow styles render their intermediate
+   * results into downscaled buffers once the blur is large enough. It is faster but the result is
+   * slightly different from the full-resolution one. The default value is false.
+   */
+  bool blurDownscaleEnabled() const {
+    return _blurDownscaleEnabled;
+  }
+
+  /**
+   * Set the value of blurDownscaleEnabled property.
+   */
+  void setBlurDownscaleEnabled(bool value) {
+    _blurDownscaleEnabled = value;
+  }
+
+  /**
+   * If set to true, convex paths are filled by triangulating them on the GPU also when the render
+   * target has no MSAA, instead of rasterizing them on the CPU. The antialiased edges are slightly
+   * different. The default value is false.
+   */
+  bool pathTriangulationEnabled() const {
+    return _pathTriangulationEnabled;
+  }
+
+  /**
+   * Set the value of pathTriangulationEnabled property.
+   */
+  void setPathTriangulationEnabled(bool value) {
+    _pathTriangulationEnabled = value;
+  }
+
+  /**
+   * If set to true, text whose scale factor keeps changing is drawn from signed distance fields,
+   * which are generated once and serve all scale factors. The text goes back to glyphs rasterized
+   * at its font size once the scale factor stops changing. The edges of distance field glyphs are
+   * slightly softer and their corners slightly rounded. The default value is false.
+   */
+  bool distanceFieldTextEnabled() const {
+    return _distanceFieldTextEnabled;
+  }
+
+  /**
+   * Set the value of distanceFieldTextEnabled property.
+   */
+  void setDistanceFieldTextEnabled(bool value) {
+    _distanceFieldTextEnabled = value;
+  }
+
   bool prepareSequenceReader(Sequence* sequence, Frame targetFrame, DecodingPolicy policy);
 
   std::shared_ptr<SequenceReader> getSequenceReader(Sequence* sequence);
@@ -150,14 +281,35 @@ class RenderCache : public Performance {
   uint32_t deviceID = 0;
   tgfx::Context* context = nullptr;
   int64_t lastTimestamp = 0;
+  size_t drawCallStart = 0;
+  size_t triangulatedPathStart = 0;
+  size_t rasterizedPathStart = 0;
+  size_t pathMaskHitStart = 0;
+  size_t pathMaskMissStart = 0;
+  size_t uploadedTextureStart = 0;
   bool hitTestOnly = false;
   size_t graphicsMemory = 0;
+  size_t maxGraphicsMemory = 0;
+  int64_t frameIndex = 0;
   bool _videoEnabled = true;
   bool _snapshotEnabled = true;
+  bool _sharedCacheEnabled = false;
+  bool _blurDownscaleEnabled = false;
+  bool _distanceFieldTextEnabled = false;
+  bool _pathTriangulationEnabled = false;
+  int _videoLookaheadFrames = 3;
+  size_t _videoLookaheadMemory = 25165824;  // 24M
+  int _videoSegmentDecoders = 0;
+  size_t _videoSegmentMemory = 134217728;  // 128M
+  std::shared_ptr<SharedRenderCache> sharedCache = nullptr;
   std::unordered_set<ID> usedAssets = {};
   std::unordered_map<ID, Snapshot*> snapshotCaches = {};
   std::list<Snapshot*> snapshotLRU = {};
-  std::unordered_map<ID, TextAtlas*> textAtlases = {};
+  std::shared_ptr<GlyphAtlas> glyphAtlas = nullptr;
+  // The memory of the GlyphAtlas pages allocated by this RenderCache. A shared GlyphAtlas is
+  // counted once in total, not once per RenderCache.
+  size_t glyphAtlasMemory = 0;
+  std::unordered_map<ID, std::unique_ptr<TextAtlas>> textAtlases = {};
   std::unordered_map<ID, std::shared_ptr<Task>> imageTasks;
   std::unordered_map<ID, std::shared_ptr<SequenceReader>> sequenceCaches;
   std::unordered_map<ID, Filter*> filterCaches;
@@ -169,6 +321,8 @@ class RenderCache : public Performance {
   // snapshot caches:
   void clearAllSnapshots();
   void clearExpiredSnapshots();
+  void purgeSnapshotsUntil(size_t targetMemory);
+  Snapshot* findPurgeableSnapshot() const;
 
   // sequence caches:
   void clearAllSequenceCaches();
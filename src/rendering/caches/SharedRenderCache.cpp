@@ -0,0 +1,136 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SharedRenderCache.h"
+#include <algorithm>
+#include <cmath>
+
+namespace pag {
+#define SCALE_FACTOR_PRECISION 0.001f
+// 过期条目数达到该数量后才统一清理一次，避免每次插入都遍历全表。
+#define MIN_PURGE_THRESHOLD 64
+
+static std::mutex sharedCacheLocker = {};
+static std::unordered_map<uint32_t, std::weak_ptr<SharedRenderCache>> sharedCacheMap = {};
+
+std::shared_ptr<SharedRenderCache> SharedRenderCache::Get(tgfx::Device* device) {
+  if (device == nullptr) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> autoLock(sharedCacheLocker);
+  auto result = sharedCacheMap.find(device->uniqueID());
+  if (result != sharedCacheMap.end()) {
+    auto cache = result->second.lock();
+    if (cache) {
+      return cache;
+    }
+  }
+  for (auto i = sharedCacheMap.begin(); i != sharedCacheMap.end();) {
+    if (i->second.expired()) {
+      i = sharedCacheMap.erase(i);
+    } else {
+      i++;
+    }
+  }
+  auto cache = std::make_shared<SharedRenderCache>();
+  sharedCacheMap[device->uniqueID()] = cache;
+  return cache;
+}
+
+static bool MatchEntry(const SnapshotEntry& entry, uint64_t makerKey, float scaleFactor) {
+  return entry.makerKey == makerKey &&
+         fabsf(entry.scaleFactor - scaleFactor) <= SCALE_FACTOR_PRECISION;
+}
+
+std::unique_ptr<Snapshot> SharedRenderCache::findSnapshot(ID assetID, uint64_t makerKey,
+                                                          float scaleFactor) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto result = snapshots.find(assetID);
+  if (result == snapshots.end()) {
+    return nullptr;
+  }
+  auto& entries = result->second;
+  for (auto i = entries.begin(); i != entries.end(); i++) {
+    if (!MatchEntry(*i, makerKey, scaleFactor)) {
+      continue;
+    }
+    auto texture = i->texture.lock();
+    if (texture == nullptr) {
+      entries.erase(i);
+      entryCount--;
+      if (entries.empty()) {
+        snapshots.erase(result);
+      }
+      return nullptr;
+    }
+    auto snapshot = std::make_unique<Snapshot>(std::move(texture), i->matrix);
+    snapshot->makingTime = i->makingTime;
+    return snapshot;
+  }
+  return nullptr;
+}
+
+void SharedRenderCache::addSnapshot(ID assetID, uint64_t makerKey, const Snapshot* snapshot) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto& entries = snapshots[assetID];
+  auto scaleFactor = snapshot->scaleFactor();
+  auto result = std::find_if(entries.begin(), entries.end(), [&](const SnapshotEntry& entry) {
+    return MatchEntry(entry, makerKey, scaleFactor);
+  });
+  if (result == entries.end()) {
+    result = entries.insert(entries.end(), SnapshotEntry());
+    entryCount++;
+  }
+  result->makerKey = makerKey;
+  result->scaleFactor = scaleFactor;
+  result->matrix = snapshot->matrix;
+  result->makingTime = snapshot->makingTime;
+  result->texture = snapshot->texture;
+  purgeExpiredEntries();
+}
+
+std::shared_ptr<GlyphAtlas> SharedRenderCache::getGlyphAtlas() {
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (glyphAtlas == nullptr) {
+    glyphAtlas = std::make_shared<GlyphAtlas>();
+  }
+  return glyphAtlas;
+}
+
+void SharedRenderCache::purgeExpiredEntries() {
+  if (entryCount < purgeThreshold) {
+    return;
+  }
+  entryCount = 0;
+  for (auto i = snapshots.begin(); i != snapshots.end();) {
+    auto& entries = i->second;
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [](const SnapshotEntry& entry) {
+                                   return entry.texture.expired();
+                                 }),
+                  entries.end());
+    entryCount += entries.size();
+    if (entries.empty()) {
+      i = snapshots.erase(i);
+    } else {
+      i++;
+    }
+  }
+  purgeThreshold = std::max(static_cast<size_t>(MIN_PURGE_THRESHOLD), entryCount * 2);
+}
+}  // namespace pag
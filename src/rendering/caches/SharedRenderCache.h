@@ -0,0 +1,78 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "GlyphAtlas.h"
+#include "gpu/Device.h"
+#include "rendering/graphics/Snapshot.h"
+
+namespace pag {
+struct SnapshotEntry {
+  uint64_t makerKey = 0;
+  float scaleFactor = 1.0f;
+  tgfx::Matrix matrix = tgfx::Matrix::I();
+  int64_t makingTime = 0;
+  std::weak_ptr<tgfx::Texture> texture;
+};
+
+/**
+ * SharedRenderCache shares the snapshot textures and the glyph atlas among all RenderCaches
+ * attached to the same GPU device, so that the PAGPlayers rendering the same File do not rasterize
+ * and store the identical static content repeatedly. The cache only keeps weak references to the
+ * snapshots, each of them is released once it is no longer used by any RenderCache.
+ */
+class SharedRenderCache {
+ public:
+  /**
+   * Returns the SharedRenderCache of the specified device, creates a new one if there is none.
+   */
+  static std::shared_ptr<SharedRenderCache> Get(tgfx::Device* device);
+
+  /**
+   * Returns a new Snapshot sharing the texture of the snapshot cached for the specified asset ID,
+   * maker key and scale factor. Returns nullptr if there is no such snapshot.
+   */
+  std::unique_ptr<Snapshot> findSnapshot(ID assetID, uint64_t makerKey, float scaleFactor);
+
+  /**
+   * Shares the texture of the specified snapshot with other RenderCaches.
+   */
+  void addSnapshot(ID assetID, uint64_t makerKey, const Snapshot* snapshot);
+
+  /**
+   * Returns the GlyphAtlas shared by all text layers drawn on the device. It must be accessed with
+   * the device locked.
+   */
+  std::shared_ptr<GlyphAtlas> getGlyphAtlas();
+
+ private:
+  std::mutex locker = {};
+  // The players of the same asset may draw it at different scale factors, each of them keeps its
+  // own entry.
+  std::unordered_map<ID, std::vector<SnapshotEntry>> snapshots = {};
+  std::shared_ptr<GlyphAtlas> glyphAtlas = nullptr;
+  size_t entryCount = 0;
+  size_t purgeThreshold = 0;
+
+  void purgeExpiredEntries();
+};
+}  // namespace pag
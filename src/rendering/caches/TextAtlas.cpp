@@ -17,280 +17,74 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "TextAtlas.h"
-#include "RenderCache.h"
-#include "core/Mask.h"
-#include "gpu/Canvas.h"
-#include "gpu/Surface.h"
-#include "gpu/opengl/GLTexture.h"
+#include <algorithm>
 
 namespace pag {
-class Atlas {
- public:
-  static std::unique_ptr<Atlas> Make(tgfx::Context* context, float scale,
-                                     const std::vector<GlyphHandle>& glyphs, int maxTextureSize,
-                                     bool alphaOnly = true);
-
-  bool getLocator(const tgfx::BytesKey& bytesKey, AtlasLocator* locator) const;
-
-  size_t memoryUsage() const;
-
- private:
-  Atlas(std::vector<std::shared_ptr<tgfx::Texture>> textures,
-        std::unordered_map<tgfx::BytesKey, AtlasLocator, tgfx::BytesHasher> glyphLocators)
-      : textures(std::move(textures)), glyphLocators(std::move(glyphLocators)) {
-  }
-
-  std::vector<std::shared_ptr<tgfx::Texture>> textures;
-  std::unordered_map<tgfx::BytesKey, AtlasLocator, tgfx::BytesHasher> glyphLocators;
-
-  friend class TextAtlas;
-};
-
-static constexpr int kDefaultPadding = 3;
-
-class RectanglePack {
- public:
-  explicit RectanglePack(int padding = kDefaultPadding) : padding(padding) {
-    reset();
-  }
-
-  int width() const {
-    return _width;
-  }
-
-  int height() const {
-    return _height;
-  }
-
-  Point addRect(int w, int h) {
-    w += padding;
-    h += padding;
-    auto area = (_width - x) * (_height - y);
-    if ((x + w - _width) * y > area || (y + h - _height) * x > area) {
-      if (_width <= _height) {
-        x = _width;
-        y = padding;
-        _width += w;
-      } else {
-        x = padding;
-        y = _height;
-        _height += h;
-      }
-    }
-    auto point = Point::Make(static_cast<float>(x), static_cast<float>(y));
-    if (x + w - _width < y + h - _height) {
-      x += w;
-      _height = std::max(_height, y + h);
-    } else {
-      y += h;
-      _width = std::max(_width, x + w);
-    }
-    return point;
-  }
-
-  void reset() {
-    _width = padding;
-    _height = padding;
-    x = padding;
-    y = padding;
-  }
-
- private:
-  int padding = kDefaultPadding;
-  int _width = 0;
-  int _height = 0;
-  int x = 0;
-  int y = 0;
-};
-
-size_t Atlas::memoryUsage() const {
-  if (textures.empty()) {
-    return 0;
-  }
-  size_t usage = 0;
-  for (auto& texture : textures) {
-    usage += texture->width() * texture->height();
-  }
-  auto bytesPerPixels = textures[0]->getSampler()->format == tgfx::PixelFormat::ALPHA_8 ? 1 : 4;
-  return usage * bytesPerPixels;
-}
-
-static tgfx::PaintStyle ToTGFX(TextStyle style) {
-  switch (style) {
-    case TextStyle::StrokeAndFill:
-    case TextStyle::Fill:
-      return tgfx::PaintStyle::Fill;
-    case TextStyle::Stroke:
-      return tgfx::PaintStyle::Stroke;
-  }
-}
-
-struct AtlasTextRun {
-  tgfx::Paint paint;
-  tgfx::Font textFont = {};
-  std::vector<tgfx::GlyphID> glyphIDs;
-  std::vector<tgfx::Point> positions;
-};
-
-static AtlasTextRun CreateTextRun(const GlyphHandle& glyph) {
-  AtlasTextRun textRun;
-  textRun.textFont = glyph->getFont();
-  textRun.paint.setStyle(ToTGFX(glyph->getStyle()));
-  if (glyph->getStyle() == TextStyle::Stroke) {
-    textRun.paint.setStrokeWidth(glyph->getStrokeWidth());
-  }
-  return textRun;
-}
-
-static void ComputeStyleKey(tgfx::BytesKey* styleKey, const GlyphHandle& glyph) {
-  styleKey->write(static_cast<uint32_t>(glyph->getStyle()));
-  styleKey->write(glyph->getStrokeWidth());
-  styleKey->write(glyph->getFont().getTypeface()->uniqueID());
-}
-
-struct Page {
-  std::vector<AtlasTextRun> textRuns;
-  int width = 0;
-  int height = 0;
-  std::unordered_map<tgfx::BytesKey, AtlasLocator, tgfx::BytesHasher> locators;
-};
-
-static std::vector<Page> CreatePages(const std::vector<GlyphHandle>& glyphs, float scale,
-                                     int maxTextureSize) {
-  std::vector<Page> pages = {};
-  std::vector<tgfx::BytesKey> styleKeys = {};
-  std::vector<AtlasTextRun> textRuns = {};
-  auto maxPageSize = static_cast<int>(std::floor(static_cast<float>(maxTextureSize) / scale));
-  int padding = static_cast<int>(ceil(static_cast<float>(kDefaultPadding) / scale));
-  RectanglePack pack(padding);
-  Page page;
-  for (auto& glyph : glyphs) {
-    tgfx::BytesKey styleKey = {};
-    ComputeStyleKey(&styleKey, glyph);
-    auto iter = std::find(styleKeys.begin(), styleKeys.end(), styleKey);
-    AtlasTextRun* textRun;
-    if (iter == styleKeys.end()) {
-      styleKeys.push_back(styleKey);
-      textRuns.push_back(CreateTextRun(glyph));
-      textRun = &textRuns.back();
-    } else {
-      auto index = iter - styleKeys.begin();
-      textRun = &textRuns[index];
-    }
-    auto glyphWidth = static_cast<int>(glyph->getBounds().width());
-    auto glyphHeight = static_cast<int>(glyph->getBounds().height());
-    int strokeWidth = 0;
-    if (glyph->getStyle() == TextStyle::Stroke) {
-      strokeWidth = static_cast<int>(ceil(glyph->getStrokeWidth()));
-    }
-    auto x = glyph->getBounds().x() - static_cast<float>(strokeWidth);
-    auto y = glyph->getBounds().y() - static_cast<float>(strokeWidth);
-    auto width = glyphWidth + strokeWidth * 2;
-    auto height = glyphHeight + strokeWidth * 2;
-    auto packWidth = pack.width();
-    auto packHeight = pack.height();
-    auto point = pack.addRect(width, height);
-    if (pack.width() > maxPageSize || pack.height() > maxPageSize) {
-      page.textRuns = std::move(textRuns);
-      page.width = static_cast<int>(ceil(static_cast<float>(packWidth) * scale));
-      page.height = static_cast<int>(ceil(static_cast<float>(packHeight) * scale));
-      pages.push_back(std::move(page));
-      styleKeys.clear();
-      textRuns = {};
-      page = {};
-      pack.reset();
-      point = pack.addRect(width, height);
-    }
-    textRun->glyphIDs.push_back(glyph->getGlyphID());
-    textRun->positions.push_back({-x + point.x, -y + point.y});
-    AtlasLocator locator;
-    locator.textureIndex = pages.size();
-    locator.location = tgfx::Rect::MakeXYWH(point.x, point.y, static_cast<float>(width),
-                                            static_cast<float>(height));
-    locator.location.scale(scale, scale);
-    tgfx::BytesKey bytesKey;
-    glyph->computeAtlasKey(&bytesKey, glyph->getStyle());
-    page.locators[bytesKey] = locator;
-  }
-  page.textRuns = std::move(textRuns);
-  page.width = static_cast<int>(ceil(static_cast<float>(pack.width()) * scale));
-  page.height = static_cast<int>(ceil(static_cast<float>(pack.height()) * scale));
-  pages.push_back(std::move(page));
-  return pages;
-}
+static constexpr float kMaxAtlasFontSize = 256.f;
 
-std::shared_ptr<tgfx::Texture> DrawMask(tgfx::Context* context, const Page& page, float scale) {
-  auto mask = tgfx::Mask::Make(page.width, page.height);
-  if (mask == nullptr) {
-    LOGE("Atlas: create mask failed.");
+std::unique_ptr<TextAtlas> TextAtlas::Make(const TextGlyphs* textGlyphs, GlyphAtlas* glyphAtlas,
+                                           tgfx::Context* context, float scale,
+                                           bool bucketed, bool distanceField) {
+  auto maxScale = scale * textGlyphs->maxScale();
+  const auto& maskGlyphs = textGlyphs->maskAtlasGlyphs();
+  if (maskGlyphs.empty() ||
+      (!distanceField && maskGlyphs[0]->getFont().getSize() * maxScale > kMaxAtlasFontSize)) {
     return nullptr;
   }
-  mask->setMatrix(tgfx::Matrix::MakeScale(scale));
-  for (auto& textRun : page.textRuns) {
-    auto blob = tgfx::TextBlob::MakeFrom(&textRun.glyphIDs[0], &textRun.positions[0],
-                                         textRun.glyphIDs.size(), textRun.textFont);
-    if (textRun.paint.getStyle() == tgfx::PaintStyle::Fill) {
-      mask->fillText(blob.get());
-    } else {
-      mask->strokeText(blob.get(), *textRun.paint.getStroke());
-    }
-  }
-  return mask->makeTexture(context);
-}
-
-std::shared_ptr<tgfx::Texture> DrawColor(tgfx::Context* context, const Page& page, float scale) {
-  auto surface = tgfx::Surface::Make(context, page.width, page.height);
-  if (surface == nullptr) {
+  const auto& colorGlyphs = textGlyphs->colorAtlasGlyphs();
+  if (!colorGlyphs.empty() && colorGlyphs[0]->getFont().getSize() * maxScale > kMaxAtlasFontSize) {
     return nullptr;
   }
-  auto canvas = surface->getCanvas();
-  auto totalMatrix = canvas->getMatrix();
-  for (auto& textRun : page.textRuns) {
-    canvas->setMatrix(totalMatrix);
-    canvas->concat(tgfx::Matrix::MakeScale(scale));
-    auto glyphs = &textRun.glyphIDs[0];
-    auto positions = &textRun.positions[0];
-    canvas->drawGlyphs(glyphs, positions, textRun.glyphIDs.size(), textRun.textFont, textRun.paint);
+  auto textAtlas =
+      std::unique_ptr<TextAtlas>(new TextAtlas(textGlyphs->id(), scale, bucketed, distanceField));
+  // Color glyphs can not be drawn as distance fields, they are always rasterized at a font size.
+  textAtlas->_scaleInvariant = distanceField && colorGlyphs.empty();
+  std::vector<GlyphLocation> glyphLocations = {};
+  auto success =
+      distanceField
+          ? glyphAtlas->locateDistanceFieldGlyphs(context, maskGlyphs, &glyphLocations)
+          : glyphAtlas->locateGlyphs(context, maskGlyphs, maxScale, bucketed, &glyphLocations);
+  if (!success || !textAtlas->addGlyphs(maskGlyphs, glyphLocations)) {
+    return nullptr;
   }
-  canvas->setMatrix(totalMatrix);
-  return surface->getTexture();
-}
-
-static std::vector<std::shared_ptr<tgfx::Texture>> DrawPages(tgfx::Context* context,
-                                                             std::vector<Page>* pages, float scale,
-                                                             bool alphaOnly) {
-  std::vector<std::shared_ptr<tgfx::Texture>> textures;
-  for (auto& page : *pages) {
-    if (alphaOnly) {
-      textures.push_back(DrawMask(context, page, scale));
-    } else {
-      textures.push_back(DrawColor(context, page, scale));
+  if (!colorGlyphs.empty()) {
+    // Text in the distance field mode keeps animating its scale, its color glyphs use the size
+    // buckets to avoid being rasterized again in every frame.
+    if (!glyphAtlas->locateGlyphs(context, colorGlyphs, maxScale, bucketed || distanceField,
+                                  &glyphLocations) ||
+        !textAtlas->addGlyphs(colorGlyphs, glyphLocations)) {
+      return nullptr;
     }
   }
-  return textures;
+  return textAtlas;
 }
 
-std::unique_ptr<Atlas> Atlas::Make(tgfx::Context* context, float scale,
-                                   const std::vector<GlyphHandle>& glyphs, int maxTextureSize,
-                                   bool alphaOnly) {
-  if (glyphs.empty()) {
-    return nullptr;
-  }
-  auto pages = CreatePages(glyphs, scale, maxTextureSize);
-  if (pages.empty()) {
-    return nullptr;
+bool TextAtlas::addGlyphs(const std::vector<GlyphHandle>& glyphs,
+                          const std::vector<GlyphLocation>& glyphLocations) {
+  if (glyphLocations.size() != glyphs.size()) {
+    return false;
   }
-  std::unordered_map<tgfx::BytesKey, AtlasLocator, tgfx::BytesHasher> glyphLocators;
-  for (const auto& page : pages) {
-    glyphLocators.insert(page.locators.begin(), page.locators.end());
+  for (size_t i = 0; i < glyphs.size(); i++) {
+    auto& glyphLocation = glyphLocations[i];
+    auto result = std::find(pages.begin(), pages.end(), glyphLocation.page);
+    auto textureIndex = static_cast<size_t>(result - pages.begin());
+    if (result == pages.end()) {
+      pages.push_back(glyphLocation.page);
+      generations.push_back(glyphLocation.page->generation());
+    }
+    AtlasLocator locator = {};
+    locator.textureIndex = textureIndex;
+    locator.location = glyphLocation.location;
+    tgfx::BytesKey bytesKey = {};
+    glyphs[i]->computeAtlasKey(&bytesKey, glyphs[i]->getStyle());
+    locators[bytesKey] = locator;
   }
-  auto textures = DrawPages(context, &pages, scale, alphaOnly);
-  return std::unique_ptr<Atlas>(new Atlas(std::move(textures), std::move(glyphLocators)));
+  return true;
 }
 
-bool Atlas::getLocator(const tgfx::BytesKey& bytesKey, AtlasLocator* locator) const {
-  auto iter = glyphLocators.find(bytesKey);
-  if (iter == glyphLocators.end()) {
+bool TextAtlas::getLocator(const tgfx::BytesKey& bytesKey, AtlasLocator* locator) const {
+  auto iter = locators.find(bytesKey);
+  if (iter == locators.end()) {
     return false;
   }
   if (locator) {
@@ -299,61 +93,40 @@ bool Atlas::getLocator(const tgfx::BytesKey& bytesKey, AtlasLocator* locator) co
   return true;
 }
 
-static constexpr float kMaxAtlasFontSize = 256.f;
-
-std::unique_ptr<TextAtlas> TextAtlas::Make(const TextGlyphs* textGlyphs, RenderCache* renderCache,
-                                           float scale) {
-  auto context = renderCache->getContext();
-  auto maxTextureSize = context->caps()->maxTextureSize;
-  auto maxScale = scale * textGlyphs->maxScale();
-  const auto& maskGlyphs = textGlyphs->maskAtlasGlyphs();
-  if (maskGlyphs.empty() || maskGlyphs[0]->getFont().getSize() * maxScale > kMaxAtlasFontSize) {
-    return nullptr;
-  }
-  const auto& colorGlyphs = textGlyphs->colorAtlasGlyphs();
-  if (!colorGlyphs.empty() && colorGlyphs[0]->getFont().getSize() * maxScale > kMaxAtlasFontSize) {
-    return nullptr;
-  }
-  auto maskAtlas = Atlas::Make(context, maxScale, maskGlyphs, maxTextureSize).release();
-  if (maskAtlas == nullptr) {
+std::shared_ptr<tgfx::Texture> TextAtlas::getAtlasTexture(size_t textureIndex) const {
+  if (textureIndex >= pages.size()) {
     return nullptr;
   }
-  auto colorAtlas = Atlas::Make(context, maxScale, colorGlyphs, maxTextureSize, false).release();
-  return std::unique_ptr<TextAtlas>(new TextAtlas(textGlyphs->id(), maskAtlas, colorAtlas, scale));
+  return pages[textureIndex]->getTexture();
 }
 
-TextAtlas::~TextAtlas() {
-  delete maskAtlas;
-  delete colorAtlas;
+int64_t TextAtlas::updateScale(float newScale, int64_t frameIndex) {
+  if (scaleChangedFrame < 0 || drawingScale != newScale) {
+    drawingScale = newScale;
+    scaleChangedFrame = frameIndex;
+  }
+  return frameIndex - scaleChangedFrame;
 }
 
-bool TextAtlas::getLocator(const tgfx::BytesKey& bytesKey, AtlasLocator* locator) const {
-  if (colorAtlas && colorAtlas->getLocator(bytesKey, locator)) {
-    locator->textureIndex += maskAtlas->textures.size();
-    return true;
+bool TextAtlas::isDistanceField(size_t textureIndex) const {
+  if (textureIndex >= pages.size()) {
+    return false;
   }
-  return maskAtlas->getLocator(bytesKey, locator);
+  return pages[textureIndex]->type() == GlyphPageType::DistanceField;
 }
 
-std::shared_ptr<tgfx::Texture> TextAtlas::getAtlasTexture(size_t textureIndex) const {
-  if (0 <= textureIndex && textureIndex < maskAtlas->textures.size()) {
-    return maskAtlas->textures[textureIndex];
-  }
-  textureIndex = textureIndex - maskAtlas->textures.size();
-  if (colorAtlas && 0 <= textureIndex && textureIndex < colorAtlas->textures.size()) {
-    return colorAtlas->textures[textureIndex];
+bool TextAtlas::isValid() const {
+  for (size_t i = 0; i < pages.size(); i++) {
+    if (pages[i]->generation() != generations[i]) {
+      return false;
+    }
   }
-  return nullptr;
+  return true;
 }
 
-size_t TextAtlas::memoryUsage() const {
-  size_t usage = 0;
-  if (maskAtlas) {
-    usage += maskAtlas->memoryUsage();
-  }
-  if (colorAtlas) {
-    usage += colorAtlas->memoryUsage();
+void TextAtlas::touchPages(GlyphAtlas* glyphAtlas) const {
+  for (auto page : pages) {
+    glyphAtlas->touchPage(page);
   }
-  return usage;
 }
 }  // namespace pag
@@ -18,25 +18,30 @@
 
 #pragma once
 
+#include "GlyphAtlas.h"
 #include "TextGlyphs.h"
 #include "core/BytesKey.h"
 #include "pag/types.h"
 
 namespace pag {
-class RenderCache;
-class Atlas;
-
 struct AtlasLocator {
   size_t textureIndex = 0;
   tgfx::Rect location = tgfx::Rect::MakeEmpty();
 };
 
+/**
+ * TextAtlas maps the atlas glyphs of a TextGlyphs to their locations in the shared GlyphAtlas. It
+ * owns no textures itself, so making a new one for another scale factor only rasterizes the glyphs
+ * missing in the GlyphAtlas at the new size. A bucketed TextAtlas rasterizes glyphs at font size
+ * buckets, which are shared by nearby scale factors. In the distance field mode, glyphs without
+ * color are located in the distance field pages instead, which are independent of the scale
+ * factor.
+ */
 class TextAtlas {
  public:
-  static std::unique_ptr<TextAtlas> Make(const TextGlyphs* textGlyphs, RenderCache* renderCache,
-                                         float scale);
-
-  ~TextAtlas();
+  static std::unique_ptr<TextAtlas> Make(const TextGlyphs* textGlyphs, GlyphAtlas* glyphAtlas,
+                                         tgfx::Context* context, float scale,
+                                         bool bucketed = false, bool distanceField = false);
 
   ID textGlyphsID() const {
     return _textGlyphsID;
@@ -50,16 +55,64 @@ class TextAtlas {
     return scale;
   }
 
-  size_t memoryUsage() const;
+  /**
+   * Returns true if the glyphs are rasterized at font size buckets, which is used for text
+   * animating its scale.
+   */
+  bool bucketed() const {
+    return _bucketed;
+  }
+
+  bool distanceField() const {
+    return _distanceField;
+  }
+
+  /**
+   * Returns true if the glyphs of this TextAtlas can be drawn at any scale factor.
+   */
+  bool scaleInvariant() const {
+    return _scaleInvariant;
+  }
+
+  /**
+   * Records the scale factor the text is drawn at in the specified frame, and returns the number of
+   * frames since it last changed.
+   */
+  int64_t updateScale(float scale, int64_t frameIndex);
+
+  /**
+   * Returns true if the texture at the specified index stores signed distance fields.
+   */
+  bool isDistanceField(size_t textureIndex) const;
+
+  /**
+   * Returns false if any of the pages used by this TextAtlas has been evicted since it was made.
+   */
+  bool isValid() const;
+
+  /**
+   * Marks all the pages used by this TextAtlas as used by the current frame.
+   */
+  void touchPages(GlyphAtlas* glyphAtlas) const;
 
  private:
-  TextAtlas(ID textGlyphsID, Atlas* maskAtlas, Atlas* colorAtlas, float scale)
-      : _textGlyphsID(textGlyphsID), maskAtlas(maskAtlas), colorAtlas(colorAtlas), scale(scale) {
+  TextAtlas(ID textGlyphsID, float scale, bool bucketed, bool distanceField)
+      : _textGlyphsID(textGlyphsID), scale(scale), _bucketed(bucketed),
+        _distanceField(distanceField), drawingScale(scale) {
   }
 
   ID _textGlyphsID = 0;
-  Atlas* maskAtlas = nullptr;
-  Atlas* colorAtlas = nullptr;
   float scale = 1.0f;
+  bool _bucketed = false;
+  bool _distanceField = false;
+  bool _scaleInvariant = false;
+  float drawingScale = 1.0f;
+  int64_t scaleChangedFrame = -1;
+  std::vector<GlyphPage*> pages = {};
+  std::vector<uint32_t> generations = {};
+  std::unordered_map<tgfx::BytesKey, AtlasLocator, tgfx::BytesHasher> locators = {};
+
+  bool addGlyphs(const std::vector<GlyphHandle>& glyphs,
+                 const std::vector<GlyphLocation>& glyphLocations);
 };
 }  // namespace pag
@@ -239,6 +239,7 @@ void LayerFilter::draw(tgfx::Context* context, const FilterSource* source,
   auto vertices = computeVertices(contentBounds, transformedBounds, filterScale);
   bindVertices(gl, source, target, vertices);
   gl->drawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  context->recordDrawCalls();
   if (filterProgram->vertexArray > 0) {
     gl->bindVertexArray(0);
   }
@@ -18,6 +18,7 @@
 
 #include "LayerStylesFilter.h"
 #include "rendering/caches/RenderCache.h"
+#include "rendering/filters/dropshadow/DropShadowFilter.h"
 #include "rendering/renderers/FilterRenderer.h"
 
 namespace pag {
@@ -31,6 +32,15 @@ void LayerStylesFilter::TransformBounds(tgfx::Rect* bounds, const FilterList* fi
   }
 }
 
+static LayerFilter* GetLayerStyleFilter(RenderCache* renderCache, LayerStyle* layerStyle) {
+  auto filter = renderCache->getFilterCache(layerStyle);
+  if (filter && layerStyle->type() == LayerStyleType::DropShadow) {
+    static_cast<DropShadowFilter*>(filter)->setDownscaleEnabled(
+        renderCache->blurDownscaleEnabled());
+  }
+  return filter;
+}
+
 LayerStylesFilter::LayerStylesFilter(RenderCache* renderCache) : renderCache(renderCache) {
   drawFilter = new LayerFilter();
 }
@@ -55,7 +65,7 @@ void LayerStylesFilter::draw(tgfx::Context* context, const FilterSource* source,
                              const FilterTarget* target) {
   for (auto& layerStyle : filterList->layerStyles) {
     if (layerStyle->drawPosition() == LayerStylePosition::Blow) {
-      auto filter = renderCache->getFilterCache(layerStyle);
+      auto filter = GetLayerStyleFilter(renderCache, layerStyle);
       if (filter) {
         filter->update(filterList->layerFrame, contentBounds, transformedBounds, filterScale);
         filter->draw(context, source, target);
@@ -68,7 +78,7 @@ void LayerStylesFilter::draw(tgfx::Context* context, const FilterSource* source,
 
   for (auto& layerStyle : filterList->layerStyles) {
     if (layerStyle->drawPosition() == LayerStylePosition::Above) {
-      auto filter = renderCache->getFilterCache(layerStyle);
+      auto filter = GetLayerStyleFilter(renderCache, layerStyle);
       if (filter) {
         filter->update(filterList->layerFrame, contentBounds, transformedBounds, filterScale);
         filter->draw(context, source, target);
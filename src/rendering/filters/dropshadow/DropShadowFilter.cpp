@@ -163,12 +163,23 @@ void DropShadowFilter::updateParamModeFullSpread(Frame frame, const tgfx::Rect&
   filtersBounds.emplace_back(filterBounds);
 }
 
+float DropShadowFilter::getDownscaleFactor(const tgfx::Point& sourceScale) const {
+  if (!downscaleEnabled) {
+    return 1.0f;
+  }
+  return std::min(blurFilterV->getDownscaleFactor(sourceScale),
+                  blurFilterH->getDownscaleFactor(sourceScale));
+}
+
 void DropShadowFilter::onDrawModeNotSpread(tgfx::Context* context, const FilterSource* source,
                                            const FilterTarget* target) {
   auto contentBounds = filtersBounds[0];
   auto filterBounds = filtersBounds[1];
-  auto targetWidth = static_cast<int>(ceilf(filterBounds.width() * source->scale.x));
-  auto targetHeight = static_cast<int>(ceilf(filterBounds.height() * source->scale.y));
+  blurFilterV->updateParams(blurSize, 1.0, false, BlurMode::Shadow);
+  blurFilterH->updateParams(blurSize, alpha, false, BlurMode::Shadow);
+  auto downscale = getDownscaleFactor(source->scale);
+  auto targetWidth = static_cast<int>(ceilf(filterBounds.width() * source->scale.x / downscale));
+  auto targetHeight = static_cast<int>(ceilf(filterBounds.height() * source->scale.y / downscale));
   if (blurFilterBuffer == nullptr || blurFilterBuffer->width() != targetWidth ||
       blurFilterBuffer->height() != targetHeight) {
     blurFilterBuffer = FilterBuffer::Make(context, targetWidth, targetHeight);
@@ -182,19 +193,21 @@ void DropShadowFilter::onDrawModeNotSpread(tgfx::Context* context, const FilterS
   auto offsetMatrix =
       tgfx::Matrix::MakeTrans((contentBounds.left - filterBounds.left) * source->scale.x,
                               (contentBounds.top - filterBounds.top) * source->scale.y);
+  offsetMatrix.postScale(1.0f / downscale, 1.0f / downscale);
   auto targetV = blurFilterBuffer->toFilterTarget(offsetMatrix);
 
-  blurFilterV->updateParams(blurSize, 1.0, false, BlurMode::Shadow);
   blurFilterV->enableBlurColor(color);
   blurFilterV->draw(context, source, targetV.get());
   blurFilterV->disableBlurColor();
 
-  auto sourceH = blurFilterBuffer->toFilterSource(source->scale);
+  auto sourceH =
+      blurFilterBuffer->toFilterSource({source->scale.x / downscale, source->scale.y / downscale});
 
-  blurFilterH->updateParams(blurSize, alpha, false, BlurMode::Shadow);
+  blurFilterH->updateDownscale(downscale);
   tgfx::Matrix revertMatrix =
       tgfx::Matrix::MakeTrans((filterBounds.left - contentBounds.left) * source->scale.x,
                               (filterBounds.top - contentBounds.top) * source->scale.y);
+  revertMatrix.preScale(downscale, downscale);
 
   auto targetH = *target;
   PreConcatMatrix(&targetH, revertMatrix);
@@ -230,8 +243,11 @@ void DropShadowFilter::onDrawModeNotFullSpread(tgfx::Context* context, const Fil
   auto sourceV = spreadFilterBuffer->toFilterSource(source->scale);
   lastBounds = filterBounds;
   filterBounds = filtersBounds[2];
-  targetWidth = static_cast<int>(ceilf(filterBounds.width() * source->scale.x));
-  targetHeight = static_cast<int>(ceilf(filterBounds.height() * source->scale.y));
+  blurFilterV->updateParams(blurSize, 1.0, false, BlurMode::Shadow);
+  blurFilterH->updateParams(blurSize, alpha, false, BlurMode::Shadow);
+  auto downscale = getDownscaleFactor(source->scale);
+  targetWidth = static_cast<int>(ceilf(filterBounds.width() * source->scale.x / downscale));
+  targetHeight = static_cast<int>(ceilf(filterBounds.height() * source->scale.y / downscale));
   if (blurFilterBuffer == nullptr || blurFilterBuffer->width() != targetWidth ||
       blurFilterBuffer->height() != targetHeight) {
     blurFilterBuffer = FilterBuffer::Make(context, targetWidth, targetHeight);
@@ -242,17 +258,19 @@ void DropShadowFilter::onDrawModeNotFullSpread(tgfx::Context* context, const Fil
   blurFilterBuffer->clearColor(gl);
   offsetMatrix = tgfx::Matrix::MakeTrans((lastBounds.left - filterBounds.left) * source->scale.x,
                                          (lastBounds.top - filterBounds.top) * source->scale.y);
+  offsetMatrix.postScale(1.0f / downscale, 1.0f / downscale);
   auto targetV = blurFilterBuffer->toFilterTarget(offsetMatrix);
-  blurFilterV->updateParams(blurSize, 1.0, false, BlurMode::Shadow);
   blurFilterV->draw(context, sourceV.get(), targetV.get());
 
-  auto sourceH = blurFilterBuffer->toFilterSource(source->scale);
+  auto sourceH =
+      blurFilterBuffer->toFilterSource({source->scale.x / downscale, source->scale.y / downscale});
   tgfx::Matrix revertMatrix =
       tgfx::Matrix::MakeTrans((filterBounds.left - contentBounds.left) * source->scale.x,
                               (filterBounds.top - contentBounds.top) * source->scale.y);
+  revertMatrix.preScale(downscale, downscale);
   auto targetH = *target;
   PreConcatMatrix(&targetH, revertMatrix);
-  blurFilterH->updateParams(blurSize, alpha, false, BlurMode::Shadow);
+  blurFilterH->updateDownscale(downscale);
   blurFilterH->draw(context, sourceH.get(), &targetH);
 }
 
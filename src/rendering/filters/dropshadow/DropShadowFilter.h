@@ -37,6 +37,14 @@ class DropShadowFilter : public LayerFilter {
   void draw(tgfx::Context* context, const FilterSource* source,
             const FilterTarget* target) override;
 
+  /**
+   * If set to true, large shadows render the vertical blur pass into a downscaled buffer, which is
+   * faster but slightly different from the full-resolution result. The default value is false.
+   */
+  void setDownscaleEnabled(bool value) {
+    downscaleEnabled = value;
+  }
+
  private:
   DropShadowStyle* layerStyle = nullptr;
 
@@ -53,6 +61,7 @@ class DropShadowFilter : public LayerFilter {
   float spread = 0.0f;
   float spreadSize = 0.0f;
   float blurSize = 0.0f;
+  bool downscaleEnabled = false;
   std::vector<tgfx::Rect> filtersBounds = {};
 
   void updateParamModeNotSpread(Frame frame, const tgfx::Rect& contentBounds,
@@ -65,6 +74,8 @@ class DropShadowFilter : public LayerFilter {
                                  const tgfx::Rect& transformedBounds,
                                  const tgfx::Point& filterScale);
 
+  float getDownscaleFactor(const tgfx::Point& sourceScale) const;
+
   void onDrawModeNotSpread(tgfx::Context* context, const FilterSource* source,
                            const FilterTarget* target);
   void onDrawModeNotFullSpread(tgfx::Context* context, const FilterSource* source,
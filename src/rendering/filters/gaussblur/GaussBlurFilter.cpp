@@ -86,14 +86,24 @@ void GaussBlurFilter::draw(tgfx::Context* context, const FilterSource* source,
       break;
     case BlurDirection::Horizontal:
       blurFilterH->updateParams(blurriness, 1.0, repeatEdge, BlurMode::Picture);
+      blurFilterH->updateDownscale(1.0f);
       blurFilterH->draw(context, source, target);
       break;
     case BlurDirection::Both:
       blurFilterV->updateParams(blurriness, 1.0, repeatEdge, BlurMode::Picture);
+      blurFilterH->updateParams(blurriness, 1.0f, repeatEdge, BlurMode::Picture);
+      // The vertical pass renders into a downscaled buffer for large blurs, and the horizontal
+      // pass upscales it back to the target.
+      auto downscale = 1.0f;
+      if (downscaleEnabled) {
+        downscale = std::min(blurFilterV->getDownscaleFactor(source->scale),
+                             blurFilterH->getDownscaleFactor(source->scale));
+      }
       auto contentBounds = filtersBounds[0];
       auto blurVBounds = filtersBounds[1];
-      auto targetWidth = static_cast<int>(ceilf(blurVBounds.width() * source->scale.x));
-      auto targetHeight = static_cast<int>(ceilf(blurVBounds.height() * source->scale.y));
+      auto targetWidth = static_cast<int>(ceilf(blurVBounds.width() * source->scale.x / downscale));
+      auto targetHeight =
+          static_cast<int>(ceilf(blurVBounds.height() * source->scale.y / downscale));
       if (blurFilterBuffer == nullptr || blurFilterBuffer->width() != targetWidth ||
           blurFilterBuffer->height() != targetHeight) {
         blurFilterBuffer = FilterBuffer::Make(context, targetWidth, targetHeight);
@@ -107,14 +117,17 @@ void GaussBlurFilter::draw(tgfx::Context* context, const FilterSource* source,
       auto offsetMatrix =
           tgfx::Matrix::MakeTrans((contentBounds.left - blurVBounds.left) * source->scale.x,
                                   (contentBounds.top - blurVBounds.top) * source->scale.y);
+      offsetMatrix.postScale(1.0f / downscale, 1.0f / downscale);
       auto targetV = blurFilterBuffer->toFilterTarget(offsetMatrix);
       blurFilterV->draw(context, source, targetV.get());
 
-      auto sourceH = blurFilterBuffer->toFilterSource(source->scale);
-      blurFilterH->updateParams(blurriness, 1.0f, repeatEdge, BlurMode::Picture);
+      auto sourceH = blurFilterBuffer->toFilterSource(
+          {source->scale.x / downscale, source->scale.y / downscale});
+      blurFilterH->updateDownscale(downscale);
       tgfx::Matrix revertMatrix =
           tgfx::Matrix::MakeTrans((blurVBounds.left - contentBounds.left) * source->scale.x,
                                   (blurVBounds.top - contentBounds.top) * source->scale.y);
+      revertMatrix.preScale(downscale, downscale);
       auto targetH = *target;
       PreConcatMatrix(&targetH, revertMatrix);
       blurFilterH->draw(context, sourceH.get(), &targetH);
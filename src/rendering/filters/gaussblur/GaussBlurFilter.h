@@ -36,6 +36,14 @@ class GaussBlurFilter : public LayerFilter {
   void update(Frame frame, const tgfx::Rect& contentBounds, const tgfx::Rect& transformedBounds,
               const tgfx::Point& filterScale) override;
 
+  /**
+   * If set to true, large blurs render the vertical pass into a downscaled buffer, which is faster
+   * but slightly different from the full-resolution result. The default value is false.
+   */
+  void setDownscaleEnabled(bool value) {
+    downscaleEnabled = value;
+  }
+
  private:
   Effect* effect = nullptr;
 
@@ -45,6 +53,7 @@ class GaussBlurFilter : public LayerFilter {
   std::shared_ptr<FilterBuffer> blurFilterBuffer = nullptr;
 
   bool repeatEdge = true;
+  bool downscaleEnabled = false;
   BlurDirection blurDirection = BlurDirection::Both;
   float blurriness = 0.0f;
   std::vector<tgfx::Rect> filtersBounds = {};
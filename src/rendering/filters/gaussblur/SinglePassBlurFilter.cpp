@@ -111,6 +111,37 @@ void SinglePassBlurFilter::updateParams(float blurrinessValue, float blurAlphaVa
   }
 }
 
+void SinglePassBlurFilter::update(Frame frame, const tgfx::Rect& contentBounds,
+                                  const tgfx::Rect& transformedBounds,
+                                  const tgfx::Point& filterScale) {
+  LayerFilter::update(frame, contentBounds, transformedBounds, filterScale);
+  directionScale = direction == BlurDirection::Horizontal ? filterScale.x : filterScale.y;
+}
+
+float SinglePassBlurFilter::getDownscaleFactor(const tgfx::Point& sourceScale) const {
+  auto scale = direction == BlurDirection::Horizontal ? sourceScale.x : sourceScale.y;
+  auto span = blurRadius() * blurLevel() * scale;
+  auto factor = 1.0f;
+  while (factor < BLUR_DOWNSCALE_MAX_FACTOR && span / (factor * 2.0f) >= BLUR_DOWNSCALE_MIN_SPAN) {
+    factor *= 2.0f;
+  }
+  return factor;
+}
+
+void SinglePassBlurFilter::updateDownscale(float factor) {
+  downscale = factor;
+}
+
+float SinglePassBlurFilter::blurRadius() const {
+  auto blurValue = std::min(blurriness * directionScale, BLUR_LIMIT_BLURRINESS);
+  return blurValue / BLUR_LIMIT_BLURRINESS * (maxRadius - 1.0) + 1.0;
+}
+
+float SinglePassBlurFilter::blurLevel() const {
+  auto blurValue = std::min(blurriness * directionScale, BLUR_LIMIT_BLURRINESS);
+  return blurValue / BLUR_LIMIT_BLURRINESS * (maxLevel - 1.0) + 1.0;
+}
+
 void SinglePassBlurFilter::enableBlurColor(tgfx::Color blurColor) {
   isColorValid = true;
   color = blurColor;
@@ -123,18 +154,16 @@ void SinglePassBlurFilter::disableBlurColor() {
 
 void SinglePassBlurFilter::onUpdateParams(const tgfx::GLInterface* gl,
                                           const tgfx::Rect& contentBounds,
-                                          const tgfx::Point& filterScale) {
-  auto scale = direction == BlurDirection::Horizontal ? filterScale.x : filterScale.y;
-
-  auto blurValue = std::min(blurriness * scale, BLUR_LIMIT_BLURRINESS);
-  auto blurRadius = blurValue / BLUR_LIMIT_BLURRINESS * (maxRadius - 1.0) + 1.0;
-  auto blurLevel = blurValue / BLUR_LIMIT_BLURRINESS * (maxLevel - 1.0) + 1.0;
+                                          const tgfx::Point&) {
+  // Fewer but sparser taps cover the same span in a downscaled source.
+  auto radius = std::max(blurRadius() / downscale, 1.0f);
+  auto level = blurLevel() * downscale;
 
-  gl->uniform1f(radiusHandle, blurRadius);
+  gl->uniform1f(radiusHandle, radius);
   gl->uniform2f(levelHandle,
-                blurLevel / static_cast<float>(contentBounds.width()) *
+                level / static_cast<float>(contentBounds.width()) *
                     (direction == BlurDirection::Horizontal),
-                blurLevel / static_cast<float>(contentBounds.height()) *
+                level / static_cast<float>(contentBounds.height()) *
                     (direction == BlurDirection::Vertical));
   gl->uniform1f(repeatEdgeHandle, repeatEdge);
   gl->uniform3f(colorHandle, color.red, color.green, color.blue);
@@ -29,9 +29,28 @@ class SinglePassBlurFilter : public LayerFilter {
 
   void updateParams(float blurriness, float alpha, bool repeatEdge, BlurMode mode);
 
+  /**
+   * Returns the factor to downscale the buffer this blur pass renders into. The blur spans over
+   * radius * level pixels, once the span is large enough, the buffer can be rendered at a lower
+   * resolution and the following pass can sample fewer taps from it without visible differences.
+   * Returns 1 if no downscaling should be applied. Must be called after update() and
+   * updateParams().
+   */
+  float getDownscaleFactor(const tgfx::Point& sourceScale) const;
+
+  /**
+   * Sets the factor by which the source of this pass is downscaled. The number of taps is divided
+   * by the factor and the distance between them is multiplied by it, so the blur covers the same
+   * span in the downscaled source. The default value is 1.
+   */
+  void updateDownscale(float factor);
+
   void enableBlurColor(tgfx::Color blurColor);
   void disableBlurColor();
 
+  void update(Frame frame, const tgfx::Rect& contentBounds, const tgfx::Rect& transformedBounds,
+              const tgfx::Point& filterScale) override;
+
  protected:
   std::string onBuildFragmentShader() override;
 
@@ -60,5 +79,10 @@ class SinglePassBlurFilter : public LayerFilter {
   bool repeatEdge = true;
   float maxRadius = 3.0f;
   float maxLevel = 13.0f;
+  float downscale = 1.0f;
+  float directionScale = 1.0f;
+
+  float blurRadius() const;
+  float blurLevel() const;
 };
 }  // namespace pag
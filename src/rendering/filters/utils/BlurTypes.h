@@ -27,6 +27,10 @@ namespace pag {
 #define BLUR_MODE_SHADOW_MAX_LEVEL (3.0f)
 #define DROPSHADOW_MAX_SPREAD_SIZE (25.0f)
 #define DROPSHADOW_SPREAD_MIN_THICK_SIZE (12.0f)
+// The blur span in pixels above which the two-pass blurs render the intermediate result into a
+// downscaled buffer, the span is divided by the downscale factor at most by this value.
+#define BLUR_DOWNSCALE_MIN_SPAN (24.0f)
+#define BLUR_DOWNSCALE_MAX_FACTOR (4.0f)
 
 enum class BlurMode {
   Picture = 0,
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <list>
 #include "core/Matrix.h"
 #include "gpu/Texture.h"
 #include "pag/types.h"
@@ -70,8 +71,14 @@ class Snapshot {
   tgfx::Matrix matrix = tgfx::Matrix::I();
   ID assetID = 0;
   uint64_t makerKey = 0;
-  Frame idleFrames = 0;
+  // The time cost in microseconds to rasterize this snapshot, used to weigh the eviction.
+  int64_t makingTime = 0;
+  // The frame index of the RenderCache when this snapshot was used last time.
+  int64_t usedFrame = 0;
+  // The position of this snapshot in the LRU list of the RenderCache, which allows O(1) removals.
+  std::list<Snapshot*>::iterator lruPosition = {};
 
   friend class RenderCache;
+  friend class SharedRenderCache;
 };
 }  // namespace pag
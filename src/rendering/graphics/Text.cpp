@@ -277,8 +277,14 @@ static void Draw(tgfx::Canvas* canvas, const TextAtlas* atlas, const Parameters&
     return;
   }
   auto atlasTexture = atlas->getAtlasTexture(parameters.textureIndex);
-  canvas->drawAtlas(atlasTexture.get(), &parameters.matrices[0], &parameters.rects[0],
-                    parameters.colors.empty() ? nullptr : &parameters.colors[0],
+  auto colors = parameters.colors.empty() ? nullptr : &parameters.colors[0];
+  if (atlas->isDistanceField(parameters.textureIndex)) {
+    canvas->drawDistanceFieldAtlas(atlasTexture.get(), &parameters.matrices[0],
+                                   &parameters.rects[0], colors, parameters.matrices.size(),
+                                   GlyphAtlas::DistanceFieldRange);
+    return;
+  }
+  canvas->drawAtlas(atlasTexture.get(), &parameters.matrices[0], &parameters.rects[0], colors,
                     parameters.matrices.size());
 }
 
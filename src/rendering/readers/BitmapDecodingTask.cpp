@@ -20,13 +20,14 @@
 
 namespace pag {
 std::shared_ptr<Task> BitmapDecodingTask::MakeAndRun(BitmapSequenceReader* reader,
-                                                     Frame targetFrame) {
+                                                     Frame targetFrame,
+                                                     TaskPriority priority) {
   if (reader == nullptr) {
     return nullptr;
   }
   auto executor = new BitmapDecodingTask(reader, targetFrame);
   auto task = Task::Make(std::unique_ptr<BitmapDecodingTask>(executor));
-  task->run();
+  task->run(priority);
   return task;
 }
 
@@ -24,7 +24,8 @@
 namespace pag {
 class BitmapDecodingTask : public Executor {
  public:
-  static std::shared_ptr<Task> MakeAndRun(BitmapSequenceReader* reader, Frame targetFrame);
+  static std::shared_ptr<Task> MakeAndRun(BitmapSequenceReader* reader, Frame targetFrame,
+                                          TaskPriority priority);
 
  private:
   BitmapSequenceReader* reader = nullptr;
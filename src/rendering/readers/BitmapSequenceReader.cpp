@@ -80,7 +80,7 @@ void BitmapSequenceReader::prepareAsync(Frame targetFrame) {
       pendingFrame = targetFrame;
     }
   } else {
-    lastTask = BitmapDecodingTask::MakeAndRun(this, targetFrame);
+    lastTask = BitmapDecodingTask::MakeAndRun(this, targetFrame, TaskPriority::Low);
   }
 }
 
@@ -107,7 +107,7 @@ std::shared_ptr<tgfx::Texture> BitmapSequenceReader::readTexture(Frame targetFra
       pendingFrame = -1;
     }
     if (nextFrame < sequence->duration()) {
-      lastTask = BitmapDecodingTask::MakeAndRun(this, nextFrame);
+      lastTask = BitmapDecodingTask::MakeAndRun(this, nextFrame, TaskPriority::High);
     }
   }
   return lastTexture;
@@ -26,6 +26,7 @@
 #include "rendering/filters/FilterModifier.h"
 #include "rendering/filters/LayerStylesFilter.h"
 #include "rendering/filters/MotionBlurFilter.h"
+#include "rendering/filters/gaussblur/GaussBlurFilter.h"
 #include "rendering/filters/utils/FilterBuffer.h"
 #include "rendering/filters/utils/FilterHelper.h"
 #include "rendering/utils/SurfaceUtil.h"
@@ -251,6 +252,10 @@ bool FilterRenderer::MakeEffectNode(std::vector<FilterNode>& filterNodes, tgfx::
         mapBounds.roundOut();
         mapFilter->updateMapTexture(renderCache, graphic.get(), mapBounds);
       }
+      if (effect->type() == EffectType::FastBlur) {
+        static_cast<GaussBlurFilter*>(filter)->setDownscaleEnabled(
+            renderCache->blurDownscaleEnabled());
+      }
       if (effectIndex >= clipIndex && !filterBounds.intersect(clipBounds)) {
         return false;
       }
@@ -0,0 +1,131 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DamageTracker.h"
+#include "base/utils/TGFXCast.h"
+#include "rendering/caches/LayerCache.h"
+#include "rendering/layers/PAGStage.h"
+
+namespace pag {
+bool DamageTracker::update(PAGStage* stage, tgfx::Rect* dirtyRect) {
+  std::vector<LayerState> states = {};
+  CollectLayerStates(stage, tgfx::Matrix::I(), 1.0f, true, &states);
+  auto expired = !hasStates || states.size() != layerStates.size();
+  auto rect = pendingRect;
+  for (size_t i = 0; i < states.size() && !expired; i++) {
+    auto& oldState = layerStates[i];
+    auto& newState = states[i];
+    if (oldState.layer != newState.layer || oldState.uniqueID != newState.uniqueID) {
+      expired = true;
+      break;
+    }
+    if (LayerChanged(oldState, newState)) {
+      rect.join(oldState.bounds);
+      rect.join(newState.bounds);
+    }
+  }
+  layerStates = std::move(states);
+  hasStates = true;
+  pendingRect.setEmpty();
+  if (expired) {
+    return false;
+  }
+  if (!rect.isEmpty()) {
+    // Leaves room for anti-aliased edges which may extend slightly beyond the measured bounds.
+    rect.outset(1.0f, 1.0f);
+    rect.roundOut();
+  }
+  *dirtyRect = rect;
+  return true;
+}
+
+void DamageTracker::invalidate(const tgfx::Rect& rect) {
+  pendingRect.join(rect);
+}
+
+void DamageTracker::reset() {
+  hasStates = false;
+  layerStates = {};
+  pendingRect.setEmpty();
+}
+
+void DamageTracker::CollectLayerStates(PAGComposition* composition,
+                                       const tgfx::Matrix& parentMatrix, float parentAlpha,
+                                       bool parentVisible, std::vector<LayerState>* states) {
+  for (auto& childLayer : composition->layers) {
+    auto pagLayer = childLayer.get();
+    auto layerCache = pagLayer->layerCache;
+    auto contentFrame = pagLayer->contentFrame;
+    auto visible =
+        parentVisible && pagLayer->layerVisible && layerCache->contentVisible(contentFrame);
+    if (ShouldExpand(pagLayer)) {
+      auto transform = layerCache->getTransform(contentFrame);
+      auto matrix = parentMatrix;
+      matrix.preConcat(ToTGFX(pagLayer->getTotalMatrixInternal()));
+      auto alpha = parentAlpha * transform->alpha * pagLayer->layerAlpha;
+      CollectLayerStates(static_cast<PAGComposition*>(pagLayer), matrix, alpha, visible, states);
+      continue;
+    }
+    LayerState state = {};
+    state.layer = pagLayer;
+    state.uniqueID = pagLayer->uniqueID();
+    state.contentVersion = pagLayer->contentVersion;
+    state.contentFrame = contentFrame;
+    state.matrix = parentMatrix;
+    state.matrix.preConcat(ToTGFX(pagLayer->layerMatrix));
+    state.alpha = parentAlpha * pagLayer->layerAlpha;
+    state.visible = visible;
+    if (visible) {
+      PAGComposition::MeasureChildLayer(&state.bounds, pagLayer);
+      parentMatrix.mapRect(&state.bounds);
+    }
+    states->push_back(state);
+  }
+}
+
+bool DamageTracker::ShouldExpand(PAGLayer* pagLayer) {
+  if (pagLayer->layerType() != LayerType::PreCompose) {
+    return false;
+  }
+  auto layer = pagLayer->layer;
+  auto composition = static_cast<PreComposeLayer*>(layer)->composition;
+  // The child layers of a composition can be tracked separately only if they are drawn onto the
+  // parent directly, without any offscreen pass which may mix their pixels together.
+  return composition->type() == CompositionType::Vector && !pagLayer->layerCache->hasFilters() &&
+         layer->masks.empty() && layer->blendMode == BlendMode::Normal &&
+         pagLayer->_trackMatteLayer == nullptr;
+}
+
+bool DamageTracker::LayerChanged(const LayerState& oldState, const LayerState& newState) {
+  if (!oldState.visible && !newState.visible) {
+    return false;
+  }
+  if (oldState.visible != newState.visible || oldState.contentVersion != newState.contentVersion ||
+      oldState.alpha != newState.alpha || !(oldState.matrix == newState.matrix)) {
+    return true;
+  }
+  if (oldState.contentFrame == newState.contentFrame) {
+    return false;
+  }
+  auto pagLayer = newState.layer;
+  // The replaced contents, such as PAGImages and text replacements, are not covered by the static
+  // time ranges of the LayerCache.
+  return pagLayer->contentModified() ||
+         pagLayer->layerCache->checkFrameChanged(newState.contentFrame, oldState.contentFrame);
+}
+}  // namespace pag
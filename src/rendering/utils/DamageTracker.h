@@ -0,0 +1,75 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "core/Matrix.h"
+#include "pag/pag.h"
+
+namespace pag {
+class PAGStage;
+
+/**
+ * DamageTracker compares the layers of a PAGStage between two flushes and computes the region of
+ * the stage that needs to be redrawn. Vector compositions without masks, filters, track mattes or
+ * blend modes are expanded into their child layers, all the other layers are tracked as a whole.
+ * A layer is considered changed if its content version, accumulated matrix, alpha or visibility
+ * changes, or if its new frame falls in another static time range of its LayerCache.
+ */
+class DamageTracker {
+ public:
+  /**
+   * Collects the layer states of the stage and writes the region that changed since the last
+   * update to dirtyRect, in the coordinate space of the stage. Returns false if the whole stage
+   * needs to be redrawn, which happens on the first update or after the layer tree changed.
+   */
+  bool update(PAGStage* stage, tgfx::Rect* dirtyRect);
+
+  /**
+   * Marks the specified region dirty in the next update.
+   */
+  void invalidate(const tgfx::Rect& rect);
+
+  /**
+   * Discards all recorded states, the next update requires redrawing the whole stage.
+   */
+  void reset();
+
+ private:
+  struct LayerState {
+    PAGLayer* layer = nullptr;
+    ID uniqueID = 0;
+    uint32_t contentVersion = 0;
+    Frame contentFrame = 0;
+    tgfx::Matrix matrix = tgfx::Matrix::I();
+    float alpha = 1.0f;
+    bool visible = false;
+    tgfx::Rect bounds = tgfx::Rect::MakeEmpty();
+  };
+
+  bool hasStates = false;
+  std::vector<LayerState> layerStates = {};
+  tgfx::Rect pendingRect = tgfx::Rect::MakeEmpty();
+
+  static void CollectLayerStates(PAGComposition* composition, const tgfx::Matrix& parentMatrix,
+                                 float parentAlpha, bool parentVisible,
+                                 std::vector<LayerState>* states);
+  static bool ShouldExpand(PAGLayer* pagLayer);
+  static bool LayerChanged(const LayerState& oldState, const LayerState& newState);
+};
+}  // namespace pag
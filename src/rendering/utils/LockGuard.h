@@ -20,6 +20,7 @@
 
 #include <memory>
 #include <mutex>
+#include "rendering/caches/CacheReclaimer.h"
 
 namespace pag {
 
@@ -29,12 +30,15 @@ class LockGuard {
     if (mutex) {
       mutex->lock();
     }
+    // The caches shared by the File may be accessed while locked, keeps the evicted entries alive.
+    CacheReclaimer::Enter();
   }
 
   ~LockGuard() {
     if (mutex) {
       mutex->unlock();
     }
+    CacheReclaimer::Leave();
   }
 
  private:
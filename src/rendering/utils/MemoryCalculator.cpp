@@ -18,6 +18,7 @@
 
 #include "MemoryCalculator.h"
 #include "base/utils/Log.h"
+#include "rendering/caches/FrameCacheBudget.h"
 #include "rendering/caches/LayerCache.h"
 
 namespace pag {
@@ -331,4 +332,9 @@ int64_t CalculateGraphicsMemory(std::shared_ptr<File> file) {
   }
   return maxGraphicsMemory;
 }
+
+size_t MemoryCalculator::GetFrameCacheMemoryUsage(File* file) {
+  auto budget = FrameCacheBudget::Get(file);
+  return budget ? budget->memoryUsage() : 0;
+}
 }  // namespace pag
@@ -34,6 +34,8 @@ class MemoryCalculator {
       PreComposeLayer* rootLayer, std::unordered_map<void*, tgfx::Point>& resourcesScaleMap,
       std::unordered_map<void*, std::vector<TimeRange>*>& resourcesTimeRangesMap);
 
+  static size_t GetFrameCacheMemoryUsage(File* file);
+
  private:
   static void FillBitmapGraphicsMemories(
       Composition* composition, std::unordered_map<void*, tgfx::Point>& resourcesScaleMap,
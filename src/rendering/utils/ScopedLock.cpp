@@ -17,10 +17,12 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "ScopedLock.h"
+#include "rendering/caches/CacheReclaimer.h"
 
 namespace pag {
 ScopedLock::ScopedLock(std::shared_ptr<std::mutex> first, std::shared_ptr<std::mutex> second)
     : firstLocker(std::move(first)), secondLocker(std::move(second)) {
+  CacheReclaimer::Enter();
   if (firstLocker == nullptr) {
     return;
   }
@@ -41,5 +43,6 @@ ScopedLock::~ScopedLock() {
   if (secondLocker) {
     secondLocker->unlock();
   }
+  CacheReclaimer::Leave();
 }
 }  // namespace pag
\ No newline at end of file
@@ -17,10 +17,40 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "I420Buffer.h"
+#include "YUVBufferPool.h"
 
 namespace pag {
 #define I420_PLANE_COUNT 3
 
+class PooledI420Buffer : public I420Buffer {
+ public:
+  PooledI420Buffer(int width, int height, uint8_t* data[3], const int lineSize[3],
+                   tgfx::YUVColorSpace colorSpace, tgfx::YUVColorRange colorRange,
+                   std::shared_ptr<uint8_t> block)
+      : I420Buffer(width, height, data, lineSize, colorSpace, colorRange), block(std::move(block)) {
+  }
+
+ private:
+  // The planes are stored in this block, which goes back to the pool once we are released.
+  std::shared_ptr<uint8_t> block = nullptr;
+};
+
+static inline int PlaneWidth(int width, int plane) {
+  return plane == 0 ? width : (width + 1) / 2;
+}
+
+static inline int PlaneHeight(int height, int plane) {
+  return plane == 0 ? height : (height + 1) / 2;
+}
+
+size_t I420Buffer::ByteSize(int width, int height) {
+  size_t byteSize = 0;
+  for (int i = 0; i < I420_PLANE_COUNT; i++) {
+    byteSize += static_cast<size_t>(PlaneWidth(width, i)) * PlaneHeight(height, i);
+  }
+  return byteSize;
+}
+
 I420Buffer::I420Buffer(int width, int height, uint8_t** data, const int* lineSize,
                        tgfx::YUVColorSpace colorSpace, tgfx::YUVColorRange colorRange)
     : VideoBuffer(width, height), colorSpace(colorSpace), colorRange(colorRange) {
@@ -34,6 +64,33 @@ size_t I420Buffer::planeCount() const {
   return I420_PLANE_COUNT;
 }
 
+std::shared_ptr<VideoBuffer> I420Buffer::makeCopy(YUVBufferPool* pool) const {
+  if (pool == nullptr || pool->blockSize() < ByteSize(width(), height())) {
+    return nullptr;
+  }
+  auto block = pool->obtain();
+  if (block == nullptr) {
+    return nullptr;
+  }
+  uint8_t* data[I420_PLANE_COUNT] = {};
+  int lineSize[I420_PLANE_COUNT] = {};
+  auto pixels = block.get();
+  for (int i = 0; i < I420_PLANE_COUNT; i++) {
+    auto planeWidth = PlaneWidth(width(), i);
+    auto planeHeight = PlaneHeight(height(), i);
+    data[i] = pixels;
+    lineSize[i] = planeWidth;
+    auto srcPixels = pixelsPlane[i];
+    for (int row = 0; row < planeHeight; row++) {
+      memcpy(pixels, srcPixels, static_cast<size_t>(planeWidth));
+      pixels += planeWidth;
+      srcPixels += rowBytesPlane[i];
+    }
+  }
+  return std::make_shared<PooledI420Buffer>(width(), height(), data, lineSize, colorSpace,
+                                            colorRange, std::move(block));
+}
+
 std::shared_ptr<tgfx::Texture> I420Buffer::makeTexture(tgfx::Context* context) const {
   if (context == nullptr) {
     return nullptr;
@@ -41,4 +98,16 @@ std::shared_ptr<tgfx::Texture> I420Buffer::makeTexture(tgfx::Context* context) c
   return tgfx::YUVTexture::MakeI420(context, colorSpace, colorRange, width(), height(),
                                     const_cast<uint8_t**>(pixelsPlane), rowBytesPlane);
 }
+
+bool I420Buffer::updateTexture(tgfx::Texture* texture) const {
+  if (texture == nullptr || !texture->isYUV() || texture->width() != width() ||
+      texture->height() != height()) {
+    return false;
+  }
+  auto yuvTexture = static_cast<tgfx::YUVTexture*>(texture);
+  if (yuvTexture->colorSpace() != colorSpace || yuvTexture->colorRange() != colorRange) {
+    return false;
+  }
+  return yuvTexture->updateI420(const_cast<uint8_t**>(pixelsPlane), rowBytesPlane);
+}
 }  // namespace pag
@@ -23,10 +23,24 @@
 namespace pag {
 class I420Buffer : public VideoBuffer {
  public:
+  /**
+   * Returns the number of bytes to store the planes of an I420 frame with the specified size
+   * without any row padding.
+   */
+  static size_t ByteSize(int width, int height);
+
   size_t planeCount() const override;
 
+  std::shared_ptr<VideoBuffer> makeCopy(YUVBufferPool* pool) const override;
+
   std::shared_ptr<tgfx::Texture> makeTexture(tgfx::Context* context) const override;
 
+  bool isStreamable() const override {
+    return true;
+  }
+
+  bool updateTexture(tgfx::Texture* texture) const override;
+
  protected:
   I420Buffer(int width, int height, uint8_t* data[3], const int lineSize[3],
              tgfx::YUVColorSpace colorSpace, tgfx::YUVColorRange colorRange);
@@ -17,6 +17,8 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "SoftAVCDecoder.h"
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 
 #ifdef PAG_USE_LIBAVC
@@ -65,13 +67,32 @@ static void ivd_aligned_free(void*, void* block) {
 
 #endif
 
-bool SoftAVCDecoder::onConfigure(const std::vector<HeaderData>& headers, std::string mimeType, int,
-                                 int) {
+// The maximum number of cores accepted by libavc.
+static constexpr int MaxNumCores = 4;
+static std::atomic_int numCores = {1};
+
+void SoftAVCDecoder::SetNumCores(int count) {
+  numCores = std::max(1, std::min(count, MaxNumCores));
+}
+
+bool SoftAVCDecoder::onConfigure(const std::vector<HeaderData>& headers, std::string mimeType,
+                                 int videoWidth, int videoHeight) {
   if (mimeType != "video/avc") {
     return false;
   }
-  if (!initDecoder()) {
-    return false;
+  if (codecContext == nullptr) {
+    if (!initDecoder()) {
+      return false;
+    }
+  } else {
+    resetDecoder();
+    flushed = true;
+  }
+  if (videoWidth != width || videoHeight != height) {
+    // The output buffers are allocated by the size decoded from the headers.
+    outputFrame = nullptr;
+    width = videoWidth;
+    height = videoHeight;
   }
   size_t totalLength = 0;
   for (auto& header : headers) {
@@ -276,7 +297,7 @@ bool SoftAVCDecoder::setNumCores() {
   ih264d_ctl_set_num_cores_op_t s_set_cores_op;
   s_set_cores_ip.e_cmd = IVD_CMD_VIDEO_CTL;
   s_set_cores_ip.e_sub_cmd = (IVD_CONTROL_API_COMMAND_TYPE_T)IH264D_CMD_CTL_SET_NUM_CORES;
-  s_set_cores_ip.u4_num_cores = 1;
+  s_set_cores_ip.u4_num_cores = static_cast<UWORD32>(numCores.load());
   s_set_cores_ip.u4_size = sizeof(ih264d_ctl_set_num_cores_ip_t);
   s_set_cores_op.u4_size = sizeof(ih264d_ctl_set_num_cores_op_t);
   auto status = ih264d_api_function(codecContext, &s_set_cores_ip, &s_set_cores_op);
@@ -37,10 +37,18 @@ extern "C" {
 
 namespace pag {
 /**
- * SoftAVCDecoder supports the annex-b format only.
+ * SoftAVCDecoder supports the annex-b format only. It can be configured again after decoding, which
+ * resets the codec instance instead of creating a new one, and keeps the output buffers if the size
+ * of the video is not changed.
  */
 class SoftAVCDecoder : public SoftwareDecoder {
  public:
+  /**
+   * Sets the number of CPU cores each decoder uses, which is clamped to [1, 4]. The default value
+   * is 1. It takes effect the next time a decoder is configured or flushed.
+   */
+  static void SetNumCores(int count);
+
   ~SoftAVCDecoder() override;
 
   bool onConfigure(const std::vector<HeaderData>& headers, std::string mime, int width,
@@ -63,6 +71,8 @@ class SoftAVCDecoder : public SoftwareDecoder {
   ivd_video_decode_ip_t decodeInput = {};
   ivd_video_decode_op_t decodeOutput = {};
   bool flushed = true;
+  int width = 0;
+  int height = 0;
 
   bool initDecoder();
   bool openDecoder();
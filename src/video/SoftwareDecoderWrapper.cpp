@@ -45,7 +45,7 @@ class SoftwareI420Buffer : public I420Buffer {
 };
 
 std::unique_ptr<VideoDecoder> SoftwareDecoderWrapper::Wrap(
-    std::shared_ptr<SoftwareDecoder> softwareDecoder, const VideoConfig& config) {
+    std::shared_ptr<SoftwareDecoder> softwareDecoder, const VideoConfig& config, bool reusable) {
   if (softwareDecoder == nullptr) {
     return nullptr;
   }
@@ -54,6 +54,7 @@ std::unique_ptr<VideoDecoder> SoftwareDecoderWrapper::Wrap(
     delete decoder;
     return nullptr;
   }
+  decoder->reusable = reusable;
   return std::unique_ptr<VideoDecoder>(decoder);
 }
 
@@ -179,4 +180,18 @@ std::shared_ptr<VideoBuffer> SoftwareDecoderWrapper::onRenderFrame() {
 int64_t SoftwareDecoderWrapper::presentationTime() {
   return currentDecodedTime;
 }
+
+bool SoftwareDecoderWrapper::isReusable() const {
+  // The buffers rendered before still refer to the memory of the software decoder.
+  return reusable && softwareDecoder.use_count() == 1;
+}
+
+bool SoftwareDecoderWrapper::onReconfigure(const VideoConfig& config) {
+  if (!isReusable()) {
+    return false;
+  }
+  pendingFrames.clear();
+  currentDecodedTime = -1;
+  return onConfigure(config);
+}
 }  // namespace pag
@@ -25,8 +25,12 @@
 namespace pag {
 class SoftwareDecoderWrapper : public VideoDecoder {
  public:
+  /**
+   * Wraps a software decoder and configures it. Set reusable to true only if the software decoder
+   * supports being configured again after decoding.
+   */
   static std::unique_ptr<VideoDecoder> Wrap(std::shared_ptr<SoftwareDecoder> softwareDecoder,
-                                            const VideoConfig& config);
+                                            const VideoConfig& config, bool reusable = false);
 
   ~SoftwareDecoderWrapper() override;
 
@@ -44,6 +48,10 @@ class SoftwareDecoderWrapper : public VideoDecoder {
 
   int64_t presentationTime() override;
 
+  bool isReusable() const override;
+
+  bool onReconfigure(const VideoConfig& config) override;
+
  private:
   std::shared_ptr<SoftwareDecoder> softwareDecoder = nullptr;
   VideoConfig videoConfig = {};
@@ -51,6 +59,7 @@ class SoftwareDecoderWrapper : public VideoDecoder {
   size_t frameLength = 0;
   int64_t currentDecodedTime = -1;
   std::list<int64_t> pendingFrames{};
+  bool reusable = false;
 
   explicit SoftwareDecoderWrapper(std::shared_ptr<SoftwareDecoder> externalDecoder);
 };
@@ -22,6 +22,8 @@
 #include "gpu/YUVTexture.h"
 
 namespace pag {
+class YUVBufferPool;
+
 /**
  * VideoBuffer describes a two dimensional array of pixels from a decoded video frame.
  */
@@ -32,6 +34,32 @@ class VideoBuffer : public tgfx::TextureBuffer {
    */
   virtual size_t planeCount() const = 0;
 
+  /**
+   * Copies the planes of this video buffer into a block obtained from the specified pool, so that
+   * the copy stays valid after the decoder outputs the next frame. Returns nullptr if the pixels
+   * are not accessible on the CPU, e.g. the buffers output by hardware decoders.
+   */
+  virtual std::shared_ptr<VideoBuffer> makeCopy(YUVBufferPool*) const {
+    return nullptr;
+  }
+
+  /**
+   * Returns true if the pixels of this video buffer can be uploaded into an existing texture by
+   * updateTexture(), which saves allocating a new texture for every frame.
+   */
+  virtual bool isStreamable() const {
+    return false;
+  }
+
+  /**
+   * Uploads the pixels of this video buffer into the specified texture, which was created by
+   * makeTexture() of a streamable video buffer with the same size. Returns false if the texture
+   * can not be updated.
+   */
+  virtual bool updateTexture(tgfx::Texture*) const {
+    return false;
+  }
+
  protected:
   VideoBuffer(int width, int height) : tgfx::TextureBuffer(width, height) {
   }
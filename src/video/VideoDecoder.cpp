@@ -21,6 +21,8 @@
 #include <mutex>
 #include "SoftAVCDecoder.h"
 #include "SoftwareDecoderWrapper.h"
+#include "VideoDecoderPool.h"
+#include "base/utils/USE.h"
 #include "pag/pag.h"
 #include "platform/Platform.h"
 
@@ -37,6 +39,18 @@ void PAGVideoDecoder::RegisterSoftwareDecoderFactory(SoftwareDecoderFactory* dec
   softwareDecoderFactory = decoderFactory;
 }
 
+void PAGVideoDecoder::SetSoftwareDecoderCores(int count) {
+#ifdef PAG_USE_LIBAVC
+  SoftAVCDecoder::SetNumCores(count);
+#else
+  USE(count);
+#endif
+}
+
+void PAGVideoDecoder::SetMaxIdleSoftwareDecoderCount(int count) {
+  VideoDecoderPool::SetMaxIdleDecoders(count);
+}
+
 bool VideoDecoder::HasHardwareDecoder() {
   return Platform::Current()->hasHardwareDecoder();
 }
@@ -82,7 +96,7 @@ std::unique_ptr<VideoDecoder> VideoDecoder::CreateSoftwareDecoder(const VideoCon
 
 #ifdef PAG_USE_LIBAVC
   if (videoDecoder == nullptr) {
-    videoDecoder = SoftwareDecoderWrapper::Wrap(std::make_unique<SoftAVCDecoder>(), config);
+    videoDecoder = SoftwareDecoderWrapper::Wrap(std::make_unique<SoftAVCDecoder>(), config, true);
     if (videoDecoder != nullptr) {
       LOGI("All other video decoders are not available, fallback to SoftAVCDecoder!");
     }
@@ -118,6 +118,22 @@ class VideoDecoder {
    */
   virtual int64_t presentationTime() = 0;
 
+  /**
+   * Returns true if the decoder can be configured again by onReconfigure() to decode another video
+   * of the same size, which is much cheaper than creating a new decoder.
+   */
+  virtual bool isReusable() const {
+    return false;
+  }
+
+  /**
+   * Resets the decoder and configures it to decode the video of the specified config. Returns false
+   * if it fails, in which case the decoder should be destroyed.
+   */
+  virtual bool onReconfigure(const VideoConfig&) {
+    return false;
+  }
+
  private:
   bool hardwareBacked = false;
 
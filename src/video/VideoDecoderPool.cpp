@@ -0,0 +1,103 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "VideoDecoderPool.h"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <list>
+#include <mutex>
+
+namespace pag {
+struct IdleDecoder {
+  int width = 0;
+  int height = 0;
+  std::unique_ptr<VideoDecoder> decoder = nullptr;
+};
+
+static std::mutex PoolLocker = {};
+static size_t MaxIdleDecoders = 2;
+// The most recently released decoders are at the front.
+static std::list<IdleDecoder> IdleDecoders = {};
+static std::atomic_size_t ReusedDecoders = {0};
+
+void VideoDecoderPool::SetMaxIdleDecoders(int count) {
+  // The expired decoders are destroyed after unlocking.
+  std::list<IdleDecoder> expiredDecoders = {};
+  {
+    std::lock_guard<std::mutex> autoLock(PoolLocker);
+    MaxIdleDecoders = static_cast<size_t>(std::max(count, 0));
+    while (IdleDecoders.size() > MaxIdleDecoders) {
+      expiredDecoders.splice(expiredDecoders.end(), IdleDecoders, std::prev(IdleDecoders.end()));
+    }
+  }
+}
+
+std::unique_ptr<VideoDecoder> VideoDecoderPool::Acquire(const VideoConfig& config) {
+  while (true) {
+    std::unique_ptr<VideoDecoder> decoder = nullptr;
+    {
+      std::lock_guard<std::mutex> autoLock(PoolLocker);
+      auto result = std::find_if(IdleDecoders.begin(), IdleDecoders.end(),
+                                 [&](const IdleDecoder& item) {
+                                   return item.width == config.width &&
+                                          item.height == config.height;
+                                 });
+      if (result == IdleDecoders.end()) {
+        break;
+      }
+      decoder = std::move(result->decoder);
+      IdleDecoders.erase(result);
+    }
+    if (decoder->onReconfigure(config)) {
+      ReusedDecoders++;
+      return decoder;
+    }
+  }
+  return VideoDecoder::Make(config, false);
+}
+
+void VideoDecoderPool::Release(std::unique_ptr<VideoDecoder> decoder, const VideoConfig& config) {
+  if (decoder == nullptr || decoder->isHardwareBacked() || !decoder->isReusable()) {
+    return;
+  }
+  std::unique_ptr<VideoDecoder> expiredDecoder = nullptr;
+  std::lock_guard<std::mutex> autoLock(PoolLocker);
+  if (MaxIdleDecoders == 0) {
+    return;
+  }
+  if (IdleDecoders.size() >= MaxIdleDecoders) {
+    expiredDecoder = std::move(IdleDecoders.back().decoder);
+    IdleDecoders.pop_back();
+  }
+  IdleDecoder item = {};
+  item.width = config.width;
+  item.height = config.height;
+  item.decoder = std::move(decoder);
+  IdleDecoders.push_front(std::move(item));
+}
+
+size_t VideoDecoderPool::IdleCount() {
+  std::lock_guard<std::mutex> autoLock(PoolLocker);
+  return IdleDecoders.size();
+}
+
+size_t VideoDecoderPool::ReusedCount() {
+  return ReusedDecoders;
+}
+}  // namespace pag
@@ -0,0 +1,60 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "VideoDecoder.h"
+
+namespace pag {
+/**
+ * VideoDecoderPool keeps the idle software decoders released by video readers, keyed by the size of
+ * the video, so that the next reader of the same size resets and reuses one instead of creating a
+ * new codec instance and allocating its buffers again. Only the decoders that report isReusable()
+ * are kept, the others are destroyed immediately.
+ */
+class VideoDecoderPool {
+ public:
+  /**
+   * Sets the maximum number of idle decoders kept in the pool, the least recently released ones
+   * are destroyed first. The default value is 2, 0 disables the pool.
+   */
+  static void SetMaxIdleDecoders(int count);
+
+  /**
+   * Returns an idle software decoder reconfigured for the specified config, or creates a new one if
+   * no idle decoder of the same size is available. Returns nullptr if it fails.
+   */
+  static std::unique_ptr<VideoDecoder> Acquire(const VideoConfig& config);
+
+  /**
+   * Returns a decoder that was configured with the specified config to the pool.
+   */
+  static void Release(std::unique_ptr<VideoDecoder> decoder, const VideoConfig& config);
+
+  /**
+   * Returns the number of decoders currently kept in the pool.
+   */
+  static size_t IdleCount();
+
+  /**
+   * Returns the total number of times Acquire() has handed out an idle decoder instead of creating
+   * a new one.
+   */
+  static size_t ReusedCount();
+};
+}  // namespace pag
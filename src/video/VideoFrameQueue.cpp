@@ -0,0 +1,255 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "VideoFrameQueue.h"
+#include "I420Buffer.h"
+#include "base/utils/GetTimer.h"
+
+namespace pag {
+class VideoPrefetchTask : public Executor {
+ public:
+  static std::shared_ptr<Task> MakeAndRun(VideoFrameQueue* queue, TaskPriority priority) {
+    auto task = Task::Make(std::unique_ptr<VideoPrefetchTask>(new VideoPrefetchTask(queue)));
+    task->run(priority);
+    return task;
+  }
+
+ private:
+  VideoFrameQueue* queue = nullptr;
+
+  explicit VideoPrefetchTask(VideoFrameQueue* queue) : queue(queue) {
+  }
+
+  void execute() override {
+    queue->fill();
+  }
+};
+
+VideoFrameQueue::VideoFrameQueue(VideoReader* reader, int width, int height) : reader(reader) {
+  bufferPool = YUVBufferPool::Make(I420Buffer::ByteSize(width, height), maxFrames + 1);
+}
+
+VideoFrameQueue::~VideoFrameQueue() {
+  stop();
+}
+
+void VideoFrameQueue::setCapacity(int frameCount, size_t maxMemory) {
+  auto capacity = static_cast<size_t>(std::max(frameCount, 1));
+  if (bufferPool != nullptr) {
+    capacity = std::min(capacity, maxMemory / bufferPool->blockSize());
+  }
+  capacity = std::max(capacity, static_cast<size_t>(1));
+  {
+    std::lock_guard<std::mutex> autoLock(locker);
+    if (maxFrames == capacity) {
+      return;
+    }
+    // The frames beyond the new capacity are kept, they get consumed soon.
+    maxFrames = capacity;
+  }
+  if (bufferPool != nullptr) {
+    // One more block for the frame being decoded in the background.
+    bufferPool->setMaxFreeBlocks(capacity + 1);
+  }
+}
+
+bool VideoFrameQueue::isActive() {
+  std::lock_guard<std::mutex> autoLock(locker);
+  return taskActive || !frames.empty();
+}
+
+void VideoFrameQueue::prefetch(int64_t targetTime, TaskPriority priority) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (targetTime == INT64_MAX) {
+    // Reached the end of the video.
+    if (loopStartTime < 0) {
+      return;
+    }
+    targetTime = loopStartTime;
+    loopStartTime = -1;
+  }
+  if (!frames.empty()) {
+    auto& frame = frames.front();
+    if (frame.sampleTime <= targetTime && targetTime < frame.nextSampleTime) {
+      startTask(priority);
+      return;
+    }
+  } else if (taskActive && (isDecoding(targetTime) || pendingTime == targetTime)) {
+    return;
+  }
+  clearFrames();
+  pendingTime = targetTime;
+  startTask(priority);
+}
+
+void VideoFrameQueue::resume() {
+  std::lock_guard<std::mutex> autoLock(locker);
+  startTask(TaskPriority::High);
+}
+
+void VideoFrameQueue::setLoopStartTime(int64_t targetTime) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (!taskActive && pendingTime == INT64_MAX && !frames.empty() &&
+      frames.back().nextSampleTime == INT64_MAX) {
+    // The last frame of the video is already buffered, continues from the loop start time once
+    // the queue resumes.
+    pendingTime = targetTime;
+  } else {
+    loopStartTime = targetTime;
+  }
+}
+
+std::shared_ptr<VideoBuffer> VideoFrameQueue::take(int64_t targetTime) {
+  {
+    std::unique_lock<std::mutex> autoLock(locker);
+    auto waited = false;
+    while (true) {
+      for (size_t index = 0; index < frames.size(); index++) {
+        auto& frame = frames[index];
+        if (frame.sampleTime <= targetTime && targetTime < frame.nextSampleTime) {
+          auto buffer = frame.buffer;
+          for (size_t i = 0; i <= index; i++) {
+            frames.pop_front();
+          }
+          if (waited) {
+            underruns++;
+          }
+          return buffer;
+        }
+      }
+      if (!taskActive || !isDecoding(targetTime)) {
+        break;
+      }
+      // The frame is about to be ready, waiting for it is cheaper than decoding it again.
+      waited = true;
+      condition.wait(autoLock);
+    }
+    if (taskActive || !frames.empty()) {
+      underruns++;
+    }
+  }
+  stop();
+  return nullptr;
+}
+
+void VideoFrameQueue::recordPerformance(Performance* performance) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (performance) {
+    performance->videoBufferedFrames += static_cast<int64_t>(frames.size());
+    performance->videoBufferUnderruns += underruns;
+    performance->videoPrefetchedFrames += prefetchedFrames;
+    performance->videoPrefetchingTime += prefetchingTime;
+  }
+  underruns = 0;
+  prefetchedFrames = 0;
+  prefetchingTime = 0;
+}
+
+void VideoFrameQueue::fill() {
+  while (true) {
+    int64_t targetTime = 0;
+    uint32_t currentGeneration = 0;
+    {
+      std::lock_guard<std::mutex> autoLock(locker);
+      if (pendingTime == INT64_MAX || isFull()) {
+        taskActive = false;
+        condition.notify_all();
+        return;
+      }
+      targetTime = pendingTime;
+      currentGeneration = generation;
+    }
+    auto startTime = GetTimer();
+    auto sampleTime = reader->getSampleTimeAt(targetTime);
+    auto nextSampleTime = reader->getNextSampleTimeAt(targetTime);
+    {
+      std::lock_guard<std::mutex> autoLock(locker);
+      if (currentGeneration != generation) {
+        // The queue was cleared, continues from the new pending time.
+        continue;
+      }
+      decodingStartTime = sampleTime;
+      decodingEndTime = nextSampleTime;
+    }
+    auto buffer = reader->readSample(targetTime);
+    auto copy = buffer ? buffer->makeCopy(bufferPool.get()) : nullptr;
+    auto costTime = GetTimer() - startTime;
+
+    std::lock_guard<std::mutex> autoLock(locker);
+    decodingStartTime = decodingEndTime = INT64_MAX;
+    condition.notify_all();
+    if (currentGeneration != generation) {
+      continue;
+    }
+    if (buffer == nullptr) {
+      pendingTime = INT64_MAX;
+      continue;
+    }
+    prefetchedFrames++;
+    prefetchingTime += costTime;
+    DecodedFrame frame = {};
+    frame.sampleTime = sampleTime;
+    frame.nextSampleTime = nextSampleTime;
+    frame.buffer = copy ? copy : buffer;
+    frame.transient = copy == nullptr;
+    frames.push_back(std::move(frame));
+    if (nextSampleTime == INT64_MAX && loopStartTime >= 0) {
+      nextSampleTime = loopStartTime;
+      loopStartTime = -1;
+    }
+    pendingTime = nextSampleTime;
+  }
+}
+
+bool VideoFrameQueue::isFull() const {
+  if (frames.empty()) {
+    return false;
+  }
+  // A transient buffer must be consumed before decoding the next frame.
+  return frames.size() >= maxFrames || frames.back().transient;
+}
+
+bool VideoFrameQueue::isDecoding(int64_t targetTime) const {
+  return decodingStartTime <= targetTime && targetTime < decodingEndTime;
+}
+
+void VideoFrameQueue::clearFrames() {
+  frames.clear();
+  generation++;
+}
+
+void VideoFrameQueue::startTask(TaskPriority priority) {
+  if (taskActive || pendingTime == INT64_MAX || isFull()) {
+    return;
+  }
+  taskActive = true;
+  task = VideoPrefetchTask::MakeAndRun(this, priority);
+}
+
+void VideoFrameQueue::stop() {
+  {
+    std::lock_guard<std::mutex> autoLock(locker);
+    clearFrames();
+    pendingTime = INT64_MAX;
+  }
+  // Setting task to nullptr triggers cancel(), which waits for the frame being decoded.
+  task = nullptr;
+  std::lock_guard<std::mutex> autoLock(locker);
+  taskActive = false;
+}
+}  // namespace pag
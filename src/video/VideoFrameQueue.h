@@ -0,0 +1,127 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include "VideoReader.h"
+#include "YUVBufferPool.h"
+#include "base/utils/Task.h"
+
+namespace pag {
+/**
+ * VideoFrameQueue decodes the upcoming frames of a VideoReader on the task pool and keeps them in a
+ * ring of decoded video buffers ahead of the playhead, so that a slow frame of the decoder does not
+ * stall the rendering. The ring is bounded by both a frame count and a byte count, the planes of
+ * the buffered frames are stored in blocks recycled by a YUVBufferPool. Buffers that are not
+ * accessible on the CPU (e.g. from hardware decoders) are overwritten once the decoder outputs the
+ * next frame, so in that case the queue decodes only one frame ahead.
+ */
+class VideoFrameQueue {
+ public:
+  VideoFrameQueue(VideoReader* reader, int width, int height);
+
+  ~VideoFrameQueue();
+
+  /**
+   * Sets the maximum number of frames and the maximum bytes of the buffered frames. At least one
+   * frame is always decoded ahead.
+   */
+  void setCapacity(int frameCount, size_t maxMemory);
+
+  /**
+   * Returns true if the queue has buffered frames or is decoding in the background.
+   */
+  bool isActive();
+
+  /**
+   * Starts decoding frames in the background from the sample at the specified time, unless the
+   * sample is already buffered or being decoded, in which case the queue just resumes decoding.
+   */
+  void prefetch(int64_t targetTime, TaskPriority priority);
+
+  /**
+   * Resumes decoding in the background if the queue stopped after being filled up.
+   */
+  void resume();
+
+  /**
+   * Sets the time to continue decoding from once the queue reaches the end of the video, which is
+   * usually the start time of the next loop. It only takes effect once.
+   */
+  void setLoopStartTime(int64_t targetTime);
+
+  /**
+   * Returns the buffered frame of the sample at the specified time and drops all the frames before
+   * it, waits for the frame if it is being decoded in the background. Otherwise, the queue is
+   * cleared, the background decoding is stopped and nullptr is returned, the caller should decode
+   * the frame by itself and then call prefetch().
+   */
+  std::shared_ptr<VideoBuffer> take(int64_t targetTime);
+
+  /**
+   * Clears the buffered frames and stops decoding in the background.
+   */
+  void stop();
+
+  /**
+   * Adds the buffered frame count, the underruns and the background decoding statistics since the
+   * last call to the specified performance.
+   */
+  void recordPerformance(Performance* performance);
+
+ private:
+  struct DecodedFrame {
+    int64_t sampleTime = 0;
+    // The time of the next sample, the frame is displayed until then.
+    int64_t nextSampleTime = INT64_MAX;
+    std::shared_ptr<VideoBuffer> buffer = nullptr;
+    // True if the buffer is owned by the decoder and gets overwritten by the next frame.
+    bool transient = false;
+  };
+
+  std::mutex locker = {};
+  std::condition_variable condition = {};
+  VideoReader* reader = nullptr;
+  std::shared_ptr<YUVBufferPool> bufferPool = nullptr;
+  std::deque<DecodedFrame> frames = {};
+  std::shared_ptr<Task> task = nullptr;
+  bool taskActive = false;
+  // The time of the next frame to decode, INT64_MAX means there is nothing to decode.
+  int64_t pendingTime = INT64_MAX;
+  // The time range of the frame being decoded in the background.
+  int64_t decodingStartTime = INT64_MAX;
+  int64_t decodingEndTime = INT64_MAX;
+  int64_t loopStartTime = -1;
+  // Increased every time the queue is cleared, frames decoded before that are discarded.
+  uint32_t generation = 0;
+  size_t maxFrames = 1;
+  int64_t underruns = 0;
+  int64_t prefetchedFrames = 0;
+  int64_t prefetchingTime = 0;
+
+  void fill();
+  bool isFull() const;
+  bool isDecoding(int64_t targetTime) const;
+  void clearFrames();
+  void startTask(TaskPriority priority);
+
+  friend class VideoPrefetchTask;
+};
+}  // namespace pag
@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "VideoReader.h"
+#include "VideoDecoderPool.h"
 #include "base/utils/GetTimer.h"
 
 namespace pag {
@@ -30,7 +31,7 @@ class GPUDecoderTask : public Executor {
  public:
   static std::shared_ptr<Task> MakeAndRun(const VideoConfig& config) {
     auto task = Task::Make(std::unique_ptr<GPUDecoderTask>(new GPUDecoderTask(config)));
-    task->run();
+    task->run(TaskPriority::Low);
     return task;
   }
 
@@ -79,7 +80,7 @@ VideoReader::VideoReader(VideoConfig config, std::unique_ptr<MediaDemuxer> demux
 }
 
 VideoReader::~VideoReader() {
-  destroyVideoDecoder();
+  destroyVideoDecoder(true);
   delete demuxer;
 }
 
@@ -232,13 +233,18 @@ void VideoReader::tryMakeVideoDecoder() {
   decoderTypeIndex = DECODER_TYPE_FAIL;
 }
 
-void VideoReader::destroyVideoDecoder() {
+void VideoReader::destroyVideoDecoder(bool recycle) {
   if (videoDecoder == nullptr) {
     return;
   }
-  delete videoDecoder;
-  videoDecoder = nullptr;
+  // Releases the output buffer first, the decoder can not be reused if it is still referenced.
   outputBuffer = nullptr;
+  if (recycle) {
+    VideoDecoderPool::Release(std::unique_ptr<VideoDecoder>(videoDecoder), videoConfig);
+  } else {
+    delete videoDecoder;
+  }
+  videoDecoder = nullptr;
   currentRenderedTime = INT64_MIN;
   resetParams();
 }
@@ -252,7 +258,7 @@ void VideoReader::resetParams() {
 }
 
 bool VideoReader::switchToGPUDecoderOfTask() {
-  destroyVideoDecoder();
+  destroyVideoDecoder(true);
   auto executor = gpuDecoderTask->wait();
   videoDecoder = static_cast<GPUDecoderTask*>(executor)->getDecoder().release();
   gpuDecoderTask = nullptr;
@@ -298,8 +304,8 @@ VideoDecoder* VideoReader::makeDecoder() {
   }
   if (decoderTypeIndex <= DECODER_TYPE_SOFTWARE) {
     int64_t initialStartTime = GetTimer();
-    // try software decoder.
-    decoder = VideoDecoder::Make(videoConfig, false).release();
+    // try software decoder, reuses an idle one of the same size if possible.
+    decoder = VideoDecoderPool::Acquire(videoConfig).release();
     softDecodingInitialTime = GetTimer() - initialStartTime;
     if (decoder) {
       decoderTypeIndex = DECODER_TYPE_SOFTWARE;
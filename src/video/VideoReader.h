@@ -61,7 +61,11 @@ class VideoReader {
   int64_t hardDecodingInitialTime = 0;
   int64_t softDecodingInitialTime = 0;
 
-  void destroyVideoDecoder();
+  /**
+   * Returns the decoder to VideoDecoderPool if recycle is true, otherwise destroys it, which should
+   * be used if the decoder failed.
+   */
+  void destroyVideoDecoder(bool recycle = false);
 
   void tryMakeVideoDecoder();
 
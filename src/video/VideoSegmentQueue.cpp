@@ -0,0 +1,271 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "VideoSegmentQueue.h"
+#include <algorithm>
+#include "I420Buffer.h"
+#include "base/utils/GetTimer.h"
+#include "base/utils/TimeUtil.h"
+
+namespace pag {
+class VideoSegmentTask : public Executor {
+ public:
+  VideoSegmentTask(VideoSegmentQueue* queue, size_t index) : queue(queue), index(index) {
+  }
+
+ private:
+  VideoSegmentQueue* queue = nullptr;
+  size_t index = 0;
+
+  void execute() override {
+    queue->decodeSegment(index, INT64_MAX);
+  }
+};
+
+std::unique_ptr<VideoSegmentQueue> VideoSegmentQueue::Make(VideoSequence* sequence,
+                                                           const VideoConfig& config) {
+  std::vector<int64_t> startTimes = {};
+  for (auto& frame : sequence->frames) {
+    if (frame->isKeyframe) {
+      startTimes.push_back(FrameToTime(frame->frame, sequence->frameRate));
+    }
+  }
+  if (startTimes.size() < 2) {
+    return nullptr;
+  }
+  std::sort(startTimes.begin(), startTimes.end());
+  return std::unique_ptr<VideoSegmentQueue>(
+      new VideoSegmentQueue(sequence, config, std::move(startTimes)));
+}
+
+VideoSegmentQueue::VideoSegmentQueue(VideoSequence* sequence, VideoConfig videoConfig,
+                                     std::vector<int64_t> startTimes)
+    : sequence(sequence), config(std::move(videoConfig)) {
+  demuxer = std::make_unique<VideoSequenceDemuxer>(sequence);
+  bufferPool = YUVBufferPool::Make(I420Buffer::ByteSize(config.width, config.height), maxFrames);
+  for (size_t i = 0; i < startTimes.size(); i++) {
+    Segment segment = {};
+    segment.startTime = startTimes[i];
+    segment.endTime = i + 1 < startTimes.size() ? startTimes[i + 1] : INT64_MAX;
+    segments.push_back(std::move(segment));
+  }
+}
+
+VideoSegmentQueue::~VideoSegmentQueue() {
+  for (size_t i = 0; i < segments.size(); i++) {
+    releaseSegment(i);
+  }
+}
+
+void VideoSegmentQueue::setCapacity(int segmentCount, size_t maxMemory) {
+  maxSegments = static_cast<size_t>(std::max(segmentCount, 1));
+  auto capacity = std::max(maxMemory / bufferPool->blockSize(), static_cast<size_t>(1));
+  {
+    std::lock_guard<std::mutex> autoLock(locker);
+    if (maxFrames == capacity) {
+      return;
+    }
+    // The frames beyond the new capacity are kept, they get consumed soon.
+    maxFrames = capacity;
+  }
+  bufferPool->setMaxFreeBlocks(capacity);
+}
+
+std::shared_ptr<VideoBuffer> VideoSegmentQueue::take(int64_t targetTime) {
+  auto sampleTime = demuxer->getSampleTimeAt(targetTime);
+  if (sampleTime == INT64_MIN || sampleTime == INT64_MAX) {
+    return nullptr;
+  }
+  auto index = findSegment(sampleTime);
+  auto endIndex = std::min(index + maxSegments, segments.size());
+  for (size_t i = 0; i < segments.size(); i++) {
+    if (i < index || i >= endIndex) {
+      releaseSegment(i);
+    }
+  }
+  auto dropped = false;
+  auto buffer = readFrame(index, sampleTime, &dropped);
+  if (dropped) {
+    // Seeking backwards inside the segment, decodes it again from the keyframe.
+    releaseSegment(index);
+    buffer = readFrame(index, sampleTime, &dropped);
+  }
+  // Reading the frame releases the frames before it, which may resume the paused segments.
+  for (auto i = index; i < endIndex; i++) {
+    startSegment(i, i == index ? TaskPriority::High : TaskPriority::Low);
+  }
+  return buffer;
+}
+
+void VideoSegmentQueue::recordPerformance(Performance* performance) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (performance) {
+    performance->videoBufferedFrames += static_cast<int64_t>(bufferedFrames);
+    performance->videoBufferUnderruns += underruns;
+    performance->videoPrefetchedFrames += prefetchedFrames;
+    performance->videoPrefetchingTime += prefetchingTime;
+  }
+  underruns = 0;
+  prefetchedFrames = 0;
+  prefetchingTime = 0;
+}
+
+size_t VideoSegmentQueue::findSegment(int64_t sampleTime) const {
+  auto result = std::upper_bound(
+      segments.begin(), segments.end(), sampleTime,
+      [](int64_t time, const Segment& segment) { return time < segment.startTime; });
+  if (result == segments.begin()) {
+    return 0;
+  }
+  return static_cast<size_t>(result - segments.begin()) - 1;
+}
+
+bool VideoSegmentQueue::isFinished(const Segment& segment) const {
+  return segment.pendingTime >= segment.endTime;
+}
+
+void VideoSegmentQueue::startSegment(size_t index, TaskPriority priority) {
+  auto& segment = segments[index];
+  {
+    std::lock_guard<std::mutex> autoLock(locker);
+    if (segment.pendingTime == INT64_MIN) {
+      segment.pendingTime = demuxer->getSampleTimeAt(segment.startTime);
+    }
+    if (segment.decoding || isFinished(segment) || bufferedFrames >= maxFrames) {
+      return;
+    }
+  }
+  if (segment.task == nullptr) {
+    segment.task = Task::Make(std::make_unique<VideoSegmentTask>(this, index));
+  }
+  // Does nothing if the task is still queued or running.
+  segment.task->run(priority);
+}
+
+void VideoSegmentQueue::releaseSegment(size_t index) {
+  auto& segment = segments[index];
+  {
+    std::lock_guard<std::mutex> autoLock(locker);
+    if (segment.pendingTime == INT64_MIN) {
+      return;
+    }
+    segment.released = true;
+  }
+  // Setting task to nullptr triggers cancel(), which waits for the frame being decoded.
+  segment.task = nullptr;
+  segment.reader = nullptr;
+  std::lock_guard<std::mutex> autoLock(locker);
+  bufferedFrames -= segment.frames.size();
+  segment.frames.clear();
+  segment.pendingTime = INT64_MIN;
+  segment.released = false;
+  segment.failed = false;
+}
+
+std::shared_ptr<VideoBuffer> VideoSegmentQueue::readFrame(size_t index, int64_t sampleTime,
+                                                          bool* dropped) {
+  auto& segment = segments[index];
+  auto& frames = segment.frames;
+  std::unique_lock<std::mutex> autoLock(locker);
+  if (segment.pendingTime == INT64_MIN) {
+    segment.pendingTime = demuxer->getSampleTimeAt(segment.startTime);
+  }
+  auto waited = false;
+  while (true) {
+    while (!frames.empty() && frames.front().sampleTime < sampleTime) {
+      // Frames are taken in order, releases the blocks of the frames already drawn.
+      frames.pop_front();
+      bufferedFrames--;
+    }
+    if (!frames.empty() || segment.pendingTime > sampleTime) {
+      break;
+    }
+    waited = true;
+    if (segment.decoding) {
+      condition.wait(autoLock);
+    } else {
+      // No worker is decoding the segment yet, decodes the frame here instead of waiting for the
+      // queued task, which may be stuck behind the other segments in the task pool.
+      autoLock.unlock();
+      decodeSegment(index, sampleTime);
+      autoLock.lock();
+    }
+  }
+  if (waited) {
+    underruns++;
+  }
+  if (!frames.empty() && frames.front().sampleTime == sampleTime) {
+    return frames.front().buffer;
+  }
+  // The frame was released after being drawn, unless the segment failed to decode.
+  *dropped = !segment.failed;
+  return nullptr;
+}
+
+void VideoSegmentQueue::decodeSegment(size_t index, int64_t targetTime) {
+  auto& segment = segments[index];
+  // Decoding in the background stops at the budget, while decoding on the rendering thread stops
+  // at the target frame.
+  auto inBackground = targetTime == INT64_MAX;
+  std::unique_lock<std::mutex> autoLock(locker);
+  if (segment.decoding) {
+    return;
+  }
+  segment.decoding = true;
+  while (!segment.released && !isFinished(segment)) {
+    if (inBackground ? bufferedFrames >= maxFrames : segment.pendingTime > targetTime) {
+      break;
+    }
+    auto sampleTime = segment.pendingTime;
+    // Reserves the budget for the frame being decoded.
+    bufferedFrames++;
+    autoLock.unlock();
+    auto startTime = GetTimer();
+    if (segment.reader == nullptr) {
+      // Every segment starts with a keyframe, so each one gets a demuxer and a decoder of its own.
+      segment.reader =
+          std::make_unique<VideoReader>(config, std::make_unique<VideoSequenceDemuxer>(sequence),
+                                        DecodingPolicy::Software);
+    }
+    auto buffer = segment.reader->readSample(sampleTime);
+    // The buffer is overwritten by the next frame of the decoder, keeps a copy of it.
+    auto copy = buffer ? buffer->makeCopy(bufferPool.get()) : nullptr;
+    auto nextSampleTime = segment.reader->getNextSampleTimeAt(sampleTime);
+    auto costTime = GetTimer() - startTime;
+    autoLock.lock();
+    if (copy == nullptr) {
+      bufferedFrames--;
+      segment.failed = true;
+      segment.pendingTime = INT64_MAX;
+      break;
+    }
+    if (inBackground) {
+      prefetchedFrames++;
+      prefetchingTime += costTime;
+    }
+    DecodedFrame frame = {};
+    frame.sampleTime = sampleTime;
+    frame.buffer = std::move(copy);
+    segment.frames.push_back(std::move(frame));
+    segment.pendingTime = nextSampleTime;
+    condition.notify_all();
+  }
+  segment.decoding = false;
+  condition.notify_all();
+}
+}  // namespace pag
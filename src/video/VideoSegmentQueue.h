@@ -0,0 +1,122 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include "VideoReader.h"
+#include "VideoSequenceDemuxer.h"
+#include "YUVBufferPool.h"
+#include "base/utils/Task.h"
+
+namespace pag {
+class VideoSegmentTask;
+
+/**
+ * VideoSegmentQueue decodes a video sequence in parallel for offline exporting on machines without
+ * hardware decoders. The frames are split into segments at keyframes, each of which is decodable on
+ * its own, and the segments ahead of the playhead are decoded on the task pool at the same time,
+ * one software decoder per segment. Frames must be taken in order of presentation to benefit from
+ * it, the segments behind the playhead are released once the playhead leaves them. The decoded
+ * frames of all the segments share one byte budget, the background decoding of a segment pauses
+ * once the budget is used up and resumes after the playhead consumes some frames. The segment under
+ * the playhead never waits in the task pool, its frames are decoded on the rendering thread if no
+ * worker has picked it up yet.
+ */
+class VideoSegmentQueue {
+ public:
+  /**
+   * Creates a VideoSegmentQueue for the specified sequence. Returns nullptr if the sequence has
+   * only one segment, which can not be decoded in parallel.
+   */
+  static std::unique_ptr<VideoSegmentQueue> Make(VideoSequence* sequence,
+                                                 const VideoConfig& config);
+
+  ~VideoSegmentQueue();
+
+  /**
+   * Sets the maximum number of segments decoded at the same time, including the one under the
+   * playhead, and the maximum bytes of the decoded frames of all the segments.
+   */
+  void setCapacity(int segmentCount, size_t maxMemory);
+
+  /**
+   * Returns the decoded frame of the sample at the specified time, waits for it if the segment
+   * containing the frame is still being decoded. The frames before it are dropped. Returns nullptr
+   * if the segment failed to decode, the caller should decode the frame by itself.
+   */
+  std::shared_ptr<VideoBuffer> take(int64_t targetTime);
+
+  /**
+   * Adds the underruns and the segment decoding statistics since the last call to the specified
+   * performance.
+   */
+  void recordPerformance(Performance* performance);
+
+ private:
+  struct DecodedFrame {
+    int64_t sampleTime = 0;
+    std::shared_ptr<VideoBuffer> buffer = nullptr;
+  };
+
+  struct Segment {
+    // The time of the keyframe that starts the segment.
+    int64_t startTime = 0;
+    // The time of the keyframe that starts the next segment.
+    int64_t endTime = INT64_MAX;
+    // The fields below are guarded by the locker of the queue.
+    std::deque<DecodedFrame> frames = {};
+    // The time of the next frame to decode, INT64_MIN means the segment is not started.
+    int64_t pendingTime = INT64_MIN;
+    // True if a thread is decoding the segment, only that thread may access the reader.
+    bool decoding = false;
+    bool released = false;
+    bool failed = false;
+    std::unique_ptr<VideoReader> reader = nullptr;
+    // Only accessed on the rendering thread.
+    std::shared_ptr<Task> task = nullptr;
+  };
+
+  std::mutex locker = {};
+  std::condition_variable condition = {};
+  VideoSequence* sequence = nullptr;
+  VideoConfig config = {};
+  // Only used to look up sample times on the rendering thread.
+  std::unique_ptr<VideoSequenceDemuxer> demuxer = nullptr;
+  std::shared_ptr<YUVBufferPool> bufferPool = nullptr;
+  std::vector<Segment> segments = {};
+  size_t maxSegments = 1;
+  size_t maxFrames = 1;
+  // The number of the decoded frames of all the segments, including the ones being decoded.
+  size_t bufferedFrames = 0;
+  int64_t underruns = 0;
+  int64_t prefetchedFrames = 0;
+  int64_t prefetchingTime = 0;
+
+  VideoSegmentQueue(VideoSequence* sequence, VideoConfig config, std::vector<int64_t> startTimes);
+  size_t findSegment(int64_t sampleTime) const;
+  bool isFinished(const Segment& segment) const;
+  void startSegment(size_t index, TaskPriority priority);
+  void releaseSegment(size_t index);
+  std::shared_ptr<VideoBuffer> readFrame(size_t index, int64_t sampleTime, bool* dropped);
+  void decodeSegment(size_t index, int64_t targetTime);
+
+  friend class VideoSegmentTask;
+};
+}  // namespace pag
@@ -21,6 +21,8 @@
 #include "rendering/caches/RenderCache.h"
 
 namespace pag {
+#define STREAMING_TEXTURE_COUNT 3
+
 std::shared_ptr<SequenceReader> SequenceReader::Make(std::shared_ptr<File> file,
                                                      VideoSequence* sequence,
                                                      DecodingPolicy policy) {
@@ -49,6 +51,10 @@ VideoSequenceReader::VideoSequenceReader(std::shared_ptr<File> file, VideoSequen
   config.colorSpace = tgfx::YUVColorSpace::Rec601;
   config.frameRate = sequence->frameRate;
   reader = std::make_unique<VideoReader>(config, std::move(demuxer), policy);
+  frameQueue = std::make_unique<VideoFrameQueue>(reader.get(), config.width, config.height);
+  if (!staticContent && !VideoDecoder::HasHardwareDecoder() && VideoDecoder::HasSoftwareDecoder()) {
+    segmentQueue = VideoSegmentQueue::Make(sequence, config);
+  }
 }
 
 void VideoSequenceReader::prepareAsync(Frame targetFrame) {
@@ -56,12 +62,13 @@ void VideoSequenceReader::prepareAsync(Frame targetFrame) {
     return;
   }
   auto targetTime = FrameToTime(targetFrame, sequence->frameRate);
-  if (lastTask != nullptr) {
+  if (frameQueue->isActive()) {
     if (lastFrame != -1) {
-      pendingTime = targetTime;
+      // Add preparation for the first frame when reach to the end.
+      frameQueue->setLoopStartTime(targetTime);
     }
   } else {
-    lastTask = VideoDecodingTask::MakeAndRun(reader.get(), targetTime);
+    frameQueue->prefetch(targetTime, TaskPriority::Low);
   }
 }
 
@@ -73,33 +80,84 @@ std::shared_ptr<tgfx::Texture> VideoSequenceReader::readTexture(Frame targetFram
   if (lastFrame == targetFrame) {
     return lastTexture;
   }
+  if (segmentQueue && cache->videoSegmentDecoders() > 1) {
+    auto texture = readSegmentTexture(targetFrame, cache);
+    if (texture) {
+      return texture;
+    }
+    // Falls back to decoding the frame by the reader if the segment failed to decode.
+  }
   auto startTime = GetTimer();
-  // setting task to nullptr triggers cancel(), in case the bitmap content changes before we
-  // makeTexture().
-  lastTask = nullptr;
   auto targetTime = FrameToTime(targetFrame, sequence->frameRate);
-  auto buffer = reader->readSample(targetTime);
+  frameQueue->setCapacity(cache->videoLookaheadFrames(), cache->videoLookaheadMemory());
+  // The queue stops decoding in the background if the frame is not buffered, in case the decoder
+  // outputs other frames before we makeTexture().
+  auto buffer = frameQueue->take(targetTime);
+  auto buffered = buffer != nullptr;
+  if (!buffered) {
+    buffer = reader->readSample(targetTime);
+  }
   auto decodingTime = GetTimer() - startTime;
   reader->recordPerformance(cache, decodingTime);
+  makeTexture(buffer, targetFrame, cache);
+  if (buffer && !staticContent) {
+    if (buffered) {
+      frameQueue->resume();
+    } else {
+      frameQueue->prefetch(reader->getNextSampleTimeAt(targetTime), TaskPriority::High);
+    }
+  }
+  frameQueue->recordPerformance(cache);
+  return lastTexture;
+}
+
+std::shared_ptr<tgfx::Texture> VideoSequenceReader::readSegmentTexture(Frame targetFrame,
+                                                                       RenderCache* cache) {
+  // Frames come from the segments from now on, the lookahead frames are of no use.
+  frameQueue->stop();
+  auto startTime = GetTimer();
+  segmentQueue->setCapacity(cache->videoSegmentDecoders(), cache->videoSegmentMemory());
+  auto buffer = segmentQueue->take(FrameToTime(targetFrame, sequence->frameRate));
+  segmentQueue->recordPerformance(cache);
+  if (buffer == nullptr) {
+    return nullptr;
+  }
+  cache->softwareDecodingTime += GetTimer() - startTime;
+  makeTexture(buffer, targetFrame, cache);
+  return lastTexture;
+}
+
+void VideoSequenceReader::makeTexture(std::shared_ptr<VideoBuffer> buffer, Frame targetFrame,
+                                      RenderCache* cache) {
   lastTexture = nullptr;  // Release the last texture for reusing in context.
   lastFrame = -1;
-  if (buffer) {
-    startTime = GetTimer();
+  if (buffer == nullptr) {
+    return;
+  }
+  auto startTime = GetTimer();
+  if (!staticContent && buffer->isStreamable()) {
+    lastTexture = makeStreamingTexture(buffer.get(), cache->getContext());
+  } else {
     lastTexture = buffer->makeTexture(cache->getContext());
-    lastFrame = targetFrame;
-    cache->textureUploadingTime += GetTimer() - startTime;
-    if (!staticContent) {
-      auto nextSampleTime = reader->getNextSampleTimeAt(targetTime);
-      if (nextSampleTime == INT64_MAX && pendingTime >= 0) {
-        // Add preparation for the first frame when reach to the end.
-        nextSampleTime = pendingTime;
-        pendingTime = -1;
-      }
-      if (nextSampleTime != INT64_MAX) {
-        lastTask = VideoDecodingTask::MakeAndRun(reader.get(), nextSampleTime);
-      }
-    }
   }
-  return lastTexture;
+  lastFrame = targetFrame;
+  cache->textureUploadingTime += GetTimer() - startTime;
+}
+
+std::shared_ptr<tgfx::Texture> VideoSequenceReader::makeStreamingTexture(const VideoBuffer* buffer,
+                                                                         tgfx::Context* context) {
+  if (streamingTextures.empty()) {
+    streamingTextures.resize(STREAMING_TEXTURE_COUNT);
+  }
+  auto& texture = streamingTextures[streamingIndex];
+  streamingIndex = (streamingIndex + 1) % streamingTextures.size();
+  // Only updates the texture if nobody else is holding it, otherwise the pixels of a frame that
+  // is still in use would be overwritten.
+  if (texture != nullptr && texture.use_count() == 1 && texture->getContext() == context &&
+      buffer->updateTexture(texture.get())) {
+    return texture;
+  }
+  texture = buffer->makeTexture(context);
+  return texture;
 }
 }  // namespace pag
@@ -18,7 +18,8 @@
 
 #pragma once
 
-#include "VideoDecodingTask.h"
+#include "VideoFrameQueue.h"
+#include "VideoSegmentQueue.h"
 #include "base/utils/TimeUtil.h"
 #include "rendering/readers/SequenceReader.h"
 #include "video/VideoReader.h"
@@ -34,9 +35,20 @@ class VideoSequenceReader : public SequenceReader {
 
  private:
   Frame lastFrame = -1;
-  int64_t pendingTime = -1;
   std::shared_ptr<VideoReader> reader = nullptr;
+  // Declared after the reader, so that it stops decoding before the reader is destroyed.
+  std::unique_ptr<VideoFrameQueue> frameQueue = nullptr;
+  // Only available if there is no hardware decoder.
+  std::unique_ptr<VideoSegmentQueue> segmentQueue = nullptr;
   std::shared_ptr<tgfx::Texture> lastTexture = nullptr;
-  std::shared_ptr<Task> lastTask = nullptr;
+  // The software decoded frames are uploaded into these textures in turn, so that the texture
+  // being uploaded is never the one the GPU may still be sampling from.
+  std::vector<std::shared_ptr<tgfx::Texture>> streamingTextures = {};
+  size_t streamingIndex = 0;
+
+  std::shared_ptr<tgfx::Texture> readSegmentTexture(Frame targetFrame, RenderCache* cache);
+  void makeTexture(std::shared_ptr<VideoBuffer> buffer, Frame targetFrame, RenderCache* cache);
+  std::shared_ptr<tgfx::Texture> makeStreamingTexture(const VideoBuffer* buffer,
+                                                      tgfx::Context* context);
 };
 }  // namespace pag
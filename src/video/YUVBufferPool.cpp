@@ -0,0 +1,85 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "YUVBufferPool.h"
+#include <new>
+
+namespace pag {
+std::shared_ptr<YUVBufferPool> YUVBufferPool::Make(size_t blockSize, size_t maxFreeBlocks) {
+  if (blockSize == 0) {
+    return nullptr;
+  }
+  return std::shared_ptr<YUVBufferPool>(new YUVBufferPool(blockSize, maxFreeBlocks));
+}
+
+YUVBufferPool::YUVBufferPool(size_t blockSize, size_t maxFreeBlocks)
+    : _blockSize(blockSize), maxFreeBlocks(maxFreeBlocks) {
+}
+
+YUVBufferPool::~YUVBufferPool() {
+  for (auto block : freeBlocks) {
+    delete[] block;
+  }
+}
+
+void YUVBufferPool::setMaxFreeBlocks(size_t count) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  maxFreeBlocks = count;
+  while (freeBlocks.size() > maxFreeBlocks) {
+    delete[] freeBlocks.back();
+    freeBlocks.pop_back();
+  }
+}
+
+std::shared_ptr<uint8_t> YUVBufferPool::obtain() {
+  uint8_t* block = nullptr;
+  {
+    std::lock_guard<std::mutex> autoLock(locker);
+    if (!freeBlocks.empty()) {
+      block = freeBlocks.back();
+      freeBlocks.pop_back();
+    }
+  }
+  if (block == nullptr) {
+    block = new (std::nothrow) uint8_t[_blockSize];
+    if (block == nullptr) {
+      return nullptr;
+    }
+  }
+  // The blocks may outlive the pool, e.g. a decoded frame is still being uploaded after the
+  // reader was released.
+  std::weak_ptr<YUVBufferPool> weakPool = weak_from_this();
+  return std::shared_ptr<uint8_t>(block, [weakPool](uint8_t* pixels) {
+    auto pool = weakPool.lock();
+    if (pool) {
+      pool->recycle(pixels);
+    } else {
+      delete[] pixels;
+    }
+  });
+}
+
+void YUVBufferPool::recycle(uint8_t* block) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (freeBlocks.size() < maxFreeBlocks) {
+    freeBlocks.push_back(block);
+  } else {
+    delete[] block;
+  }
+}
+}  // namespace pag
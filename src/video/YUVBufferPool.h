@@ -0,0 +1,66 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace pag {
+/**
+ * YUVBufferPool recycles the memory blocks that store the planes of decoded video frames, all of
+ * which have the same size. A block returns to the pool once the last reference to it is released.
+ */
+class YUVBufferPool : public std::enable_shared_from_this<YUVBufferPool> {
+ public:
+  /**
+   * Creates a pool of blocks with the specified size in bytes. At most maxFreeBlocks unused blocks
+   * are kept for reusing, the others are freed immediately.
+   */
+  static std::shared_ptr<YUVBufferPool> Make(size_t blockSize, size_t maxFreeBlocks);
+
+  ~YUVBufferPool();
+
+  /**
+   * Returns the size in bytes of each block.
+   */
+  size_t blockSize() const {
+    return _blockSize;
+  }
+
+  /**
+   * Sets the maximum number of unused blocks kept for reusing.
+   */
+  void setMaxFreeBlocks(size_t count);
+
+  /**
+   * Returns a block from the pool, or a newly allocated one if there is no unused block.
+   */
+  std::shared_ptr<uint8_t> obtain();
+
+ private:
+  std::mutex locker = {};
+  size_t _blockSize = 0;
+  size_t maxFreeBlocks = 0;
+  std::vector<uint8_t*> freeBlocks = {};
+
+  YUVBufferPool(size_t blockSize, size_t maxFreeBlocks);
+  void recycle(uint8_t* block);
+};
+}  // namespace pag
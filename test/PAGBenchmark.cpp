@@ -0,0 +1,263 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef PAG_BENCHMARK
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "base/utils/GetTimer.h"
+#include "base/utils/TimeUtil.h"
+#include "core/Bitmap.h"
+#include "core/utils/PixelConverter.h"
+#include "framework/pag_test.h"
+#include "nlohmann/json.hpp"
+#include "rendering/caches/RenderCache.h"
+#include "skcms.h"
+
+namespace pag {
+using nlohmann::json;
+
+static constexpr auto BenchmarkResourceDir = "../resources";
+static constexpr auto BenchmarkOutputPath = "../test/out/Benchmark/benchmark.json";
+static constexpr auto PixelConvertOutputPath = "../test/out/Benchmark/pixel_convert.json";
+
+struct FrameSample {
+  int64_t flushTime = 0;
+  int64_t renderingTime = 0;
+  int64_t presentingTime = 0;
+  int64_t imageDecodingTime = 0;
+  int64_t videoDecodingTime = 0;
+  int64_t textureUploadingTime = 0;
+  int64_t programCompilingTime = 0;
+  int64_t drawCallCount = 0;
+  int64_t drawnPixels = 0;
+};
+
+static std::vector<std::string> GetBenchmarkFiles() {
+  std::vector<std::string> files = {};
+  for (auto& entry : std::filesystem::recursive_directory_iterator(BenchmarkResourceDir)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".pag") {
+      files.push_back(entry.path().string());
+    }
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+/**
+ * Returns the nearest-rank percentile of the sorted values.
+ */
+static int64_t Percentile(const std::vector<int64_t>& sortedValues, double percent) {
+  if (sortedValues.empty()) {
+    return 0;
+  }
+  auto rank = static_cast<size_t>(ceil(percent / 100.0 * static_cast<double>(sortedValues.size())));
+  rank = std::clamp(rank, static_cast<size_t>(1), sortedValues.size());
+  return sortedValues[rank - 1];
+}
+
+static int64_t Average(const std::vector<FrameSample>& samples, int64_t FrameSample::*field) {
+  if (samples.empty()) {
+    return 0;
+  }
+  int64_t total = 0;
+  for (auto& sample : samples) {
+    total += sample.*field;
+  }
+  return total / static_cast<int64_t>(samples.size());
+}
+
+static json MakeFileReport(const std::vector<FrameSample>& samples, int64_t peakMemory) {
+  // The first frame includes decoder creation and shader compiling, it is reported separately.
+  std::vector<FrameSample> frames(samples.begin() + 1, samples.end());
+  std::vector<int64_t> flushTimes = {};
+  for (auto& sample : frames) {
+    flushTimes.push_back(sample.flushTime);
+  }
+  std::sort(flushTimes.begin(), flushTimes.end());
+  json report = {};
+  report["frames"] = samples.size();
+  report["firstFrameTime"] = samples[0].flushTime;
+  report["flushTime"] = {{"p50", Percentile(flushTimes, 50)},
+                         {"p95", Percentile(flushTimes, 95)},
+                         {"p99", Percentile(flushTimes, 99)},
+                         {"max", flushTimes.empty() ? 0 : flushTimes.back()},
+                         {"avg", Average(frames, &FrameSample::flushTime)}};
+  report["breakdown"] = {
+      {"renderingTime", Average(frames, &FrameSample::renderingTime)},
+      {"presentingTime", Average(frames, &FrameSample::presentingTime)},
+      {"imageDecodingTime", Average(frames, &FrameSample::imageDecodingTime)},
+      {"videoDecodingTime", Average(frames, &FrameSample::videoDecodingTime)},
+      {"textureUploadingTime", Average(frames, &FrameSample::textureUploadingTime)},
+      {"programCompilingTime", Average(frames, &FrameSample::programCompilingTime)},
+      {"drawCallCount", Average(frames, &FrameSample::drawCallCount)},
+      {"drawnPixels", Average(frames, &FrameSample::drawnPixels)}};
+  report["peakGraphicsMemory"] = peakMemory;
+  return report;
+}
+
+/**
+ * 用例描述: 逐帧渲染 resources 目录下所有 PAG 文件，统计 flush 耗时分位数、首帧耗时、
+ * 各阶段耗时和峰值显存，结果以 JSON 格式写入 test/out/Benchmark/benchmark.json，时间单位为微秒。
+ */
+PAG_TEST(PAGBenchmark, RenderAllFiles) {
+  json result = {};
+  for (auto& path : GetBenchmarkFiles()) {
+    auto fileName = std::filesystem::relative(path, BenchmarkResourceDir).generic_string();
+    auto pagFile = PAGFile::Load(path);
+    if (pagFile == nullptr) {
+      continue;
+    }
+    auto pagSurface = PAGSurface::MakeOffscreen(pagFile->width(), pagFile->height());
+    ASSERT_NE(pagSurface, nullptr) << fileName;
+    auto pagPlayer = std::make_shared<PAGPlayer>();
+    pagPlayer->setSurface(pagSurface);
+    pagPlayer->setComposition(pagFile);
+    auto totalFrames = TimeToFrame(pagFile->duration(), pagFile->frameRate());
+    if (totalFrames <= 1) {
+      continue;
+    }
+    std::vector<FrameSample> samples = {};
+    int64_t peakMemory = 0;
+    for (Frame currentFrame = 0; currentFrame < totalFrames; currentFrame++) {
+      pagPlayer->setProgress((currentFrame + 0.1) * 1.0 / totalFrames);
+      auto flushStart = GetTimer();
+      pagPlayer->flush();
+      FrameSample sample = {};
+      sample.flushTime = GetTimer() - flushStart;
+      auto cache = pagPlayer->renderCache;
+      sample.renderingTime = cache->renderingTime;
+      sample.presentingTime = cache->presentingTime;
+      sample.imageDecodingTime = cache->imageDecodingTime;
+      sample.videoDecodingTime = cache->hardwareDecodingTime + cache->softwareDecodingTime;
+      sample.textureUploadingTime = cache->textureUploadingTime;
+      sample.programCompilingTime = cache->programCompilingTime;
+      sample.drawCallCount = cache->drawCallCount;
+      sample.drawnPixels = cache->drawnPixels;
+      samples.push_back(sample);
+      peakMemory = std::max(peakMemory, pagPlayer->graphicsMemory());
+    }
+    auto report = MakeFileReport(samples, peakMemory);
+    std::cout << fileName << ": " << report["flushTime"].dump() << std::endl;
+    result[fileName] = report;
+  }
+  std::filesystem::path outputPath(BenchmarkOutputPath);
+  std::filesystem::create_directories(outputPath.parent_path());
+  std::ofstream outputFile(outputPath);
+  outputFile << std::setw(4) << result << std::endl;
+  outputFile.close();
+}
+
+struct PixelConvertCase {
+  std::string name;
+  tgfx::ColorType srcColorType;
+  tgfx::AlphaType srcAlphaType;
+  tgfx::ColorType dstColorType;
+  tgfx::AlphaType dstAlphaType;
+  gfx::skcms_PixelFormat srcFormat;
+  gfx::skcms_AlphaFormat srcAlpha;
+  gfx::skcms_PixelFormat dstFormat;
+  gfx::skcms_AlphaFormat dstAlpha;
+};
+
+template <typename Func>
+static int64_t MeasureBest(int repeatCount, Func func) {
+  int64_t bestTime = INT64_MAX;
+  for (int i = 0; i < repeatCount; i++) {
+    auto startTime = GetTimer();
+    func();
+    bestTime = std::min(bestTime, GetTimer() - startTime);
+  }
+  return bestTime;
+}
+
+/**
+ * 用例描述: 对比 skcms 逐行转换、PixelConverter 单线程转换和 Bitmap 多线程转换在常见像素格式转换上
+ * 的耗时，结果以 JSON 格式写入 test/out/Benchmark/pixel_convert.json，时间单位为微秒。
+ */
+PAG_TEST(PAGBenchmark, PixelConvert) {
+  using namespace tgfx;
+  const int width = 2048;
+  const int height = 2048;
+  const int repeatCount = 10;
+  std::vector<PixelConvertCase> cases = {
+      {"RGBA_to_BGRA", ColorType::RGBA_8888, AlphaType::Premultiplied, ColorType::BGRA_8888,
+       AlphaType::Premultiplied, gfx::skcms_PixelFormat_RGBA_8888,
+       gfx::skcms_AlphaFormat_PremulAsEncoded, gfx::skcms_PixelFormat_BGRA_8888,
+       gfx::skcms_AlphaFormat_PremulAsEncoded},
+      {"Premultiply", ColorType::RGBA_8888, AlphaType::Unpremultiplied, ColorType::RGBA_8888,
+       AlphaType::Premultiplied, gfx::skcms_PixelFormat_RGBA_8888, gfx::skcms_AlphaFormat_Unpremul,
+       gfx::skcms_PixelFormat_RGBA_8888, gfx::skcms_AlphaFormat_PremulAsEncoded},
+      {"Unpremultiply", ColorType::RGBA_8888, AlphaType::Premultiplied, ColorType::BGRA_8888,
+       AlphaType::Unpremultiplied, gfx::skcms_PixelFormat_RGBA_8888,
+       gfx::skcms_AlphaFormat_PremulAsEncoded, gfx::skcms_PixelFormat_BGRA_8888,
+       gfx::skcms_AlphaFormat_Unpremul},
+      {"A8_to_RGBA", ColorType::ALPHA_8, AlphaType::Premultiplied, ColorType::RGBA_8888,
+       AlphaType::Premultiplied, gfx::skcms_PixelFormat_A_8,
+       gfx::skcms_AlphaFormat_PremulAsEncoded, gfx::skcms_PixelFormat_RGBA_8888,
+       gfx::skcms_AlphaFormat_PremulAsEncoded},
+      {"RGBA_to_A8", ColorType::RGBA_8888, AlphaType::Premultiplied, ColorType::ALPHA_8,
+       AlphaType::Premultiplied, gfx::skcms_PixelFormat_RGBA_8888,
+       gfx::skcms_AlphaFormat_PremulAsEncoded, gfx::skcms_PixelFormat_A_8,
+       gfx::skcms_AlphaFormat_PremulAsEncoded}};
+  std::vector<uint8_t> srcPixels(static_cast<size_t>(width) * height * 4);
+  for (size_t i = 0; i < srcPixels.size(); i++) {
+    // Makes one third of the pixels translucent, the rest are opaque.
+    srcPixels[i] = (i % 4 == 3 && i % 3 != 0) ? 255 : static_cast<uint8_t>(i * 7);
+  }
+  std::vector<uint8_t> dstPixels(srcPixels.size());
+  json result = {};
+  for (auto& item : cases) {
+    auto srcInfo = ImageInfo::Make(width, height, item.srcColorType, item.srcAlphaType);
+    auto dstInfo = ImageInfo::Make(width, height, item.dstColorType, item.dstAlphaType);
+    auto proc = PixelConverter::GetProc(item.srcColorType, item.srcAlphaType, item.dstColorType,
+                                        item.dstAlphaType);
+    ASSERT_TRUE(proc != nullptr) << item.name;
+    auto skcmsTime = MeasureBest(repeatCount, [&]() {
+      for (int i = 0; i < height; i++) {
+        gfx::skcms_Transform(srcPixels.data() + srcInfo.rowBytes() * i, item.srcFormat,
+                             item.srcAlpha, nullptr, dstPixels.data() + dstInfo.rowBytes() * i,
+                             item.dstFormat, item.dstAlpha, nullptr, width);
+      }
+    });
+    auto simdTime = MeasureBest(repeatCount, [&]() {
+      for (int i = 0; i < height; i++) {
+        proc(dstPixels.data() + dstInfo.rowBytes() * i, srcPixels.data() + srcInfo.rowBytes() * i,
+             width);
+      }
+    });
+    Bitmap bitmap(srcInfo, srcPixels.data());
+    auto bitmapTime =
+        MeasureBest(repeatCount, [&]() { bitmap.readPixels(dstInfo, dstPixels.data()); });
+    json report = {{"skcms", skcmsTime}, {"simd", simdTime}, {"bitmap", bitmapTime}};
+    std::cout << item.name << ": " << report.dump() << std::endl;
+    result[item.name] = report;
+  }
+  std::filesystem::path outputPath(PixelConvertOutputPath);
+  std::filesystem::create_directories(outputPath.parent_path());
+  std::ofstream outputFile(outputPath);
+  outputFile << std::setw(4) << result << std::endl;
+  outputFile.close();
+}
+}  // namespace pag
+#endif
@@ -0,0 +1,102 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "framework/pag_test.h"
+#include "framework/utils/PAGTestUtils.h"
+
+namespace pag {
+PAG_TEST_SUIT(PAGDecoderTest)
+
+/**
+ * 用例描述: PAGDecoder 逐帧解码结果与 PAGPlayer 渲染一致，静态帧跳过渲染和读取
+ */
+PAG_TEST(PAGDecoderTest, ReadFrame) {
+  auto pagFile = PAGFile::Load("../resources/apitest/test.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  EXPECT_TRUE(PAGDecoder::MakeFrom(nullptr, 100, 100) == nullptr);
+  EXPECT_TRUE(PAGDecoder::MakeFrom(pagFile, 0, 100) == nullptr);
+  auto decoder = PAGDecoder::MakeFrom(pagFile, pagFile->width(), pagFile->height(), 15);
+  ASSERT_TRUE(decoder != nullptr);
+  EXPECT_EQ(decoder->frameRate(), std::min(15.0f, pagFile->frameRate()));
+  auto numFrames = decoder->numFrames();
+  ASSERT_GT(numFrames, 0);
+  auto rowBytes = static_cast<size_t>(decoder->width()) * 4;
+  std::vector<uint8_t> pixels(rowBytes * decoder->height());
+  EXPECT_FALSE(decoder->readFrame(numFrames, pixels.data(), rowBytes));
+
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  auto pagSurface = PAGSurface::MakeOffscreen(decoder->width(), decoder->height());
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(PAGFile::Load("../resources/apitest/test.pag"));
+  pagPlayer->setMaxFrameRate(decoder->frameRate());
+  std::vector<uint8_t> expected(pixels.size());
+  for (int i = 0; i < numFrames; i++) {
+    auto changed = decoder->checkFrameChanged(i);
+    ASSERT_TRUE(decoder->readFrame(i, pixels.data(), rowBytes));
+    EXPECT_FALSE(decoder->checkFrameChanged(i));
+    pagPlayer->setProgress((i + 0.1) / numFrames);
+    auto flushed = pagPlayer->flush();
+    if (i > 0) {
+      EXPECT_EQ(changed, flushed) << "frame: " << i;
+    }
+    pagSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied, expected.data(),
+                           rowBytes);
+    EXPECT_TRUE(pixels == expected) << "frame: " << i;
+  }
+}
+
+/**
+ * 用例描述: PAGParallelDecoder 多分片并行解码，结果按帧序回调且与 PAGDecoder 一致
+ */
+PAG_TEST(PAGDecoderTest, ParallelReadFrames) {
+  auto pagFile = PAGFile::Load("../resources/apitest/test.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto parallelDecoder =
+      PAGParallelDecoder::MakeFrom(pagFile, pagFile->width() / 2, pagFile->height() / 2, 0, 3);
+  ASSERT_TRUE(parallelDecoder != nullptr);
+  EXPECT_GE(parallelDecoder->numShards(), 1);
+  auto decoder = PAGDecoder::MakeFrom(pagFile->copyOriginal(), parallelDecoder->width(),
+                                      parallelDecoder->height());
+  ASSERT_TRUE(decoder != nullptr);
+  ASSERT_EQ(parallelDecoder->numFrames(), decoder->numFrames());
+  int nextIndex = 0;
+  std::vector<uint8_t> expected = {};
+  auto compareFrame = [&](int index, const void* pixels, size_t rowBytes) {
+    EXPECT_EQ(index, nextIndex++);
+    expected.resize(rowBytes * decoder->height());
+    EXPECT_TRUE(decoder->readFrame(index, expected.data(), rowBytes));
+    EXPECT_EQ(memcmp(expected.data(), pixels, expected.size()), 0) << "frame: " << index;
+    return true;
+  };
+  auto result = parallelDecoder->readFrames(compareFrame);
+  EXPECT_TRUE(result);
+  EXPECT_EQ(nextIndex, parallelDecoder->numFrames());
+
+  // The chunk buffers of the second run may reuse the addresses freed by the first run, the shards
+  // must still read every frame into them.
+  nextIndex = 0;
+  result = parallelDecoder->readFrames(compareFrame);
+  EXPECT_TRUE(result);
+  EXPECT_EQ(nextIndex, parallelDecoder->numFrames());
+
+  nextIndex = 0;
+  result = parallelDecoder->readFrames([&](int, const void*, size_t) { return ++nextIndex < 5; });
+  EXPECT_FALSE(result);
+  EXPECT_EQ(nextIndex, 5);
+}
+}  // namespace pag
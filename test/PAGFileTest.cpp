@@ -671,4 +671,105 @@ PAG_TEST_F(PAGFileBaseTest, SetStartTime) {
   TestPAGPlayer->flush();
   EXPECT_TRUE(Baseline::Compare(TestPAGSurface, "PAGFileBaseTest/SetStartTime"));
 }
+
+/**
+ * 用例描述: PAGFile逐帧缓存内存上限
+ */
+PAG_TEST_F(PAGFileBaseTest, MaxFrameCacheMemory) {
+  auto pagFile = PAGFile::Load("../assets/replacement.pag");
+  ASSERT_NE(pagFile, nullptr);
+  EXPECT_EQ(pagFile->maxFrameCacheMemory(), 0u);
+  TestPAGPlayer->setComposition(pagFile);
+  for (int i = 0; i < 10; i++) {
+    TestPAGPlayer->setProgress(i * 0.1);
+    TestPAGPlayer->flush();
+  }
+  auto unlimitedUsage = pagFile->frameCacheMemoryUsage();
+  EXPECT_GT(unlimitedUsage, 0u);
+
+  auto maxMemory = unlimitedUsage / 2;
+  pagFile->setMaxFrameCacheMemory(maxMemory);
+  EXPECT_EQ(pagFile->maxFrameCacheMemory(), maxMemory);
+  // 设置上限后立即淘汰超出的帧缓存.
+  EXPECT_LE(pagFile->frameCacheMemoryUsage(), maxMemory);
+  for (int i = 0; i < 10; i++) {
+    TestPAGPlayer->setProgress(i * 0.1 + 0.05);
+    TestPAGPlayer->flush();
+    EXPECT_LE(pagFile->frameCacheMemoryUsage(), maxMemory);
+  }
+
+  pagFile->setMaxFrameCacheMemory(0);
+  for (int i = 0; i < 10; i++) {
+    TestPAGPlayer->setProgress(i * 0.1);
+    TestPAGPlayer->flush();
+  }
+  EXPECT_GT(pagFile->frameCacheMemoryUsage(), maxMemory);
+  TestPAGPlayer->setComposition(nullptr);
+}
+
+/**
+ * 用例描述: 嵌套预合成的帧缓存在极小的内存上限下逐帧淘汰，创建父级缓存期间不会死锁
+ */
+PAG_TEST_F(PAGFileBaseTest, NestedFrameCacheEviction) {
+  auto pagFile = PAGFile::Load(PAG_COMPLEX_FILE_PATH);
+  ASSERT_NE(pagFile, nullptr);
+  TestPAGPlayer->setComposition(pagFile);
+  for (int i = 0; i < 10; i++) {
+    TestPAGPlayer->setProgress(i * 0.1);
+    TestPAGPlayer->flush();
+  }
+  auto unlimitedUsage = pagFile->frameCacheMemoryUsage();
+  EXPECT_GT(unlimitedUsage, 0u);
+  // 每个新建的帧缓存都会超出上限，创建子合成的帧缓存时，父级的帧缓存可能正位于 LRU 的尾部。
+  pagFile->setMaxFrameCacheMemory(1);
+  for (int i = 0; i < 10; i++) {
+    TestPAGPlayer->setProgress(i * 0.1 + 0.05);
+    TestPAGPlayer->flush();
+  }
+  EXPECT_LT(pagFile->frameCacheMemoryUsage(), unlimitedUsage);
+  pagFile->setMaxFrameCacheMemory(0);
+  TestPAGPlayer->setComposition(nullptr);
+}
+
+/**
+ * 用例描述: File驻留缓存命中与清理
+ */
+PAG_TEST_F(PAGFileBaseTest, FileInternCache) {
+  auto byteData = ByteData::FromPath(PAG_CORRECT_FILE_PATH);
+  ASSERT_NE(byteData, nullptr);
+  File::SetMaxCacheSize(byteData->length() * 2);
+  auto file = File::Load(byteData->data(), byteData->length());
+  ASSERT_NE(file, nullptr);
+  auto stats = File::CacheStats();
+  EXPECT_EQ(stats.fileCount, 1u);
+  EXPECT_EQ(stats.totalBytes, byteData->length());
+
+  auto internedFile = File::Load(byteData->data(), byteData->length());
+  EXPECT_EQ(internedFile, file);
+  EXPECT_EQ(File::CacheStats().hitCount, stats.hitCount + 1);
+
+  File::PurgeCache();
+  EXPECT_EQ(File::CacheStats().fileCount, 0u);
+  File::SetMaxCacheSize(0);
+  auto newFile = File::Load(byteData->data(), byteData->length());
+  EXPECT_NE(newFile, file);
+}
+
+/**
+ * 用例描述: PAGFile引用文件数据解码的渲染结果与默认模式一致，且与默认模式加载的File互不复用
+ */
+PAG_TEST_F(PAGFileBaseTest, ReferenceDecoding) {
+  auto file = File::Load("../assets/replacement.pag", DecodingMode::Reference);
+  ASSERT_NE(file, nullptr);
+  EXPECT_EQ(File::Load("../assets/replacement.pag", DecodingMode::Reference), file);
+  EXPECT_NE(File::Load("../assets/replacement.pag"), file);
+  auto pagFile = PAGFile::Load("../assets/replacement.pag", DecodingMode::Reference);
+  ASSERT_NE(pagFile, nullptr);
+  TestPAGPlayer->setComposition(pagFile);
+  pagFile->setStartTime(2000000);
+  TestPAGPlayer->setProgress(0);
+  TestPAGPlayer->flush();
+  EXPECT_TRUE(Baseline::Compare(TestPAGSurface, "PAGFileBaseTest/SetStartTime"));
+  TestPAGPlayer->setComposition(nullptr);
+}
 }  // namespace pag
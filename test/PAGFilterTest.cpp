@@ -275,4 +275,48 @@ PAG_TEST(PAGFilterTest, MultiFilter) {
   pagPlayer->flush();
   EXPECT_TRUE(Baseline::Compare(pagSurface, "PAGFilterTest/MultiFilter_Motiontile_Blur"));
 }
+
+static std::vector<uint8_t> RenderBlurredPixels(const std::string& path, int64_t time,
+                                                bool downscaleEnabled) {
+  auto pagFile = PAGFile::Load(path);
+  auto pagSurface = PAGSurface::MakeOffscreen(pagFile->width() * 2, pagFile->height() * 2);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setBlurDownscaleEnabled(downscaleEnabled);
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  pagFile->setCurrentTime(time);
+  pagPlayer->flush();
+  auto rowBytes = static_cast<size_t>(pagSurface->width()) * 4;
+  std::vector<uint8_t> pixels(rowBytes * pagSurface->height());
+  pagSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied, pixels.data(), rowBytes);
+  return pixels;
+}
+
+/**
+ * 用例描述: 开启降采样后，大半径模糊与逐像素模糊的结果误差在容忍范围内，默认不开启降采样
+ */
+PAG_TEST(PAGFilterTest, BlurDownscale) {
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  EXPECT_FALSE(pagPlayer->blurDownscaleEnabled());
+  std::vector<std::pair<std::string, int64_t>> items = {
+      {"../resources/filter/fastblur.pag", 1000000},
+      {"../resources/filter/fastblur_norepeat.pag", 1000000},
+      {"../resources/filter/DropShadow.pag", 1000000}};
+  for (auto& item : items) {
+    auto expected = RenderBlurredPixels(item.first, item.second, false);
+    auto actual = RenderBlurredPixels(item.first, item.second, true);
+    ASSERT_EQ(expected.size(), actual.size());
+    int maxDiff = 0;
+    size_t diffCount = 0;
+    for (size_t i = 0; i < expected.size(); i++) {
+      auto diff = abs(expected[i] - actual[i]);
+      maxDiff = std::max(maxDiff, diff);
+      if (diff > 5) {
+        diffCount++;
+      }
+    }
+    EXPECT_LE(maxDiff, 16) << item.first;
+    EXPECT_LE(diffCount, expected.size() / 1000) << item.first;
+  }
+}
 }  // namespace pag
@@ -16,9 +16,14 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "base/utils/TimeUtil.h"
 #include "framework/pag_test.h"
 #include "framework/utils/PAGTestUtils.h"
+#include "gpu/opengl/GLDevice.h"
 #include "nlohmann/json.hpp"
+#include "rendering/caches/ContentPrefetcher.h"
+#include "rendering/caches/RenderCache.h"
+#include "rendering/caches/SharedRenderCache.h"
 
 namespace pag {
 using nlohmann::json;
@@ -131,4 +136,154 @@ PAG_TEST_F(PAGPlayerTest, autoClear) {
   EXPECT_TRUE(Baseline::Compare(pagSurface, "PAGPlayerTest/autoClear_autoClear_true"));
 }
 
-}  // namespace pag
\ No newline at end of file
+/**
+ * 用例描述: PAGPlayer 设置缓存显存上限
+ */
+PAG_TEST_F(PAGPlayerTest, maxCacheMemory) {
+  auto pagFile = PAGFile::Load(DEFAULT_PAG_PATH);
+  TestPAGPlayer->setComposition(pagFile);
+  EXPECT_EQ(TestPAGPlayer->maxCacheMemory(), static_cast<size_t>(314572800));
+  TestPAGPlayer->setProgress(0.5);
+  TestPAGPlayer->flush();
+  auto cacheCount = TestPAGPlayer->renderCache->snapshotCaches.size();
+  auto memoryUsage = TestPAGPlayer->renderCache->memoryUsage();
+  TestPAGPlayer->setMaxCacheMemory(0);
+  EXPECT_EQ(TestPAGPlayer->maxCacheMemory(), static_cast<size_t>(0));
+  // Snapshots used by current frame are kept.
+  EXPECT_EQ(TestPAGPlayer->renderCache->snapshotCaches.size(), cacheCount);
+  TestPAGPlayer->setProgress(0.8);
+  TestPAGPlayer->flush();
+  // No more snapshots are created once the limit is reached.
+  EXPECT_LE(TestPAGPlayer->renderCache->memoryUsage(), memoryUsage);
+  TestPAGPlayer->setMaxCacheMemory(314572800);
+}
+
+static std::vector<uint8_t> ReadSurfacePixels(std::shared_ptr<PAGSurface> pagSurface) {
+  auto rowBytes = static_cast<size_t>(pagSurface->width()) * 4;
+  std::vector<uint8_t> pixels(rowBytes * pagSurface->height());
+  pagSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied, pixels.data(), rowBytes);
+  return pixels;
+}
+
+/**
+ * 用例描述: PAGPlayer 开启局部重绘后，逐帧渲染结果与全量重绘一致，且重绘像素数不超过全屏
+ */
+PAG_TEST_F(PAGPlayerTest, partialRedraw) {
+  auto fullFile = PAGFile::Load(DEFAULT_PAG_PATH);
+  auto fullSurface = PAGSurface::MakeOffscreen(fullFile->width(), fullFile->height());
+  auto fullPlayer = std::make_shared<PAGPlayer>();
+  fullPlayer->setSurface(fullSurface);
+  fullPlayer->setComposition(fullFile);
+
+  auto partialFile = PAGFile::Load(DEFAULT_PAG_PATH);
+  auto partialSurface = PAGSurface::MakeOffscreen(partialFile->width(), partialFile->height());
+  auto partialPlayer = std::make_shared<PAGPlayer>();
+  partialPlayer->setSurface(partialSurface);
+  partialPlayer->setComposition(partialFile);
+  EXPECT_FALSE(partialPlayer->partialRedrawEnabled());
+  partialPlayer->setPartialRedrawEnabled(true);
+  EXPECT_TRUE(partialPlayer->partialRedrawEnabled());
+
+  auto surfacePixels = static_cast<int64_t>(fullSurface->width()) * fullSurface->height();
+  for (int i = 0; i < 10; i++) {
+    auto progress = i * 0.1;
+    fullPlayer->setProgress(progress);
+    fullPlayer->flush();
+    partialPlayer->setProgress(progress);
+    partialPlayer->flush();
+    EXPECT_LE(partialPlayer->renderCache->drawnPixels, surfacePixels);
+    auto expected = ReadSurfacePixels(fullSurface);
+    auto actual = ReadSurfacePixels(partialSurface);
+    ASSERT_EQ(expected.size(), actual.size());
+    size_t diffCount = 0;
+    for (size_t j = 0; j < expected.size(); j++) {
+      if (abs(expected[j] - actual[j]) > 2) {
+        diffCount++;
+      }
+    }
+    EXPECT_LE(diffCount, expected.size() / 1000) << "progress: " << progress;
+  }
+  // Flushing again without any change redraws nothing.
+  partialPlayer->flush();
+  EXPECT_EQ(partialPlayer->renderCache->drawnPixels, 0);
+}
+
+/**
+ * 用例描述: PAGPlayer 开启流水线录制后，逐帧渲染结果与关闭时一致
+ */
+PAG_TEST_F(PAGPlayerTest, pipelineDepth) {
+  auto pipelineFile = PAGFile::Load(DEFAULT_PAG_PATH);
+  auto pipelineSurface = PAGSurface::MakeOffscreen(pipelineFile->width(), pipelineFile->height());
+  auto pipelinePlayer = std::make_shared<PAGPlayer>();
+  pipelinePlayer->setSurface(pipelineSurface);
+  pipelinePlayer->setComposition(pipelineFile);
+  EXPECT_EQ(pipelinePlayer->pipelineDepth(), 0);
+  pipelinePlayer->setPipelineDepth(10);
+  EXPECT_EQ(pipelinePlayer->pipelineDepth(), 4);
+  pipelinePlayer->setPipelineDepth(2);
+  EXPECT_EQ(pipelinePlayer->pipelineDepth(), 2);
+
+  auto totalFrames = TimeToFrame(pipelineFile->duration(), pipelineFile->frameRate());
+  for (int i = 0; i < std::min(static_cast<int>(totalFrames), 10); i++) {
+    auto progress = (i + 0.1) / totalFrames;
+    TestPAGPlayer->setProgress(progress);
+    TestPAGPlayer->flush();
+    pipelinePlayer->setProgress(progress);
+    pipelinePlayer->flush();
+    auto expected = ReadSurfacePixels(TestPAGSurface);
+    auto actual = ReadSurfacePixels(pipelineSurface);
+    EXPECT_TRUE(expected == actual) << "frame: " << i;
+  }
+  auto prefetcher = pipelinePlayer->contentPrefetcher;
+  ASSERT_TRUE(prefetcher != nullptr);
+  if (prefetcher->task) {
+    prefetcher->task->wait();
+  }
+  EXPECT_GT(prefetcher->prefetchedFrames(), 0);
+}
+
+/**
+ * 用例描述: 共享快照按素材、内容和缩放因子区分，命中时沿用首次生成的耗时
+ */
+PAG_TEST_F(PAGPlayerTest, SharedSnapshots) {
+  auto device = tgfx::GLDevice::Make();
+  ASSERT_NE(device, nullptr);
+  auto sharedCache = SharedRenderCache::Get(device.get());
+  ASSERT_NE(sharedCache, nullptr);
+  EXPECT_EQ(SharedRenderCache::Get(device.get()), sharedCache);
+  auto context = device->lockContext();
+  ASSERT_NE(context, nullptr);
+  auto halfTexture = tgfx::Texture::MakeRGBA(context, 50, 50);
+  auto fullTexture = tgfx::Texture::MakeRGBA(context, 100, 100);
+  ASSERT_NE(halfTexture, nullptr);
+  ASSERT_NE(fullTexture, nullptr);
+  auto halfSnapshot = std::make_unique<Snapshot>(halfTexture, tgfx::Matrix::MakeScale(2.0f));
+  halfSnapshot->makingTime = 3000;
+  auto fullSnapshot = std::make_unique<Snapshot>(fullTexture, tgfx::Matrix::I());
+  fullSnapshot->makingTime = 5000;
+  ID assetID = 1;
+  uint64_t makerKey = 2;
+  sharedCache->addSnapshot(assetID, makerKey, halfSnapshot.get());
+  sharedCache->addSnapshot(assetID, makerKey, fullSnapshot.get());
+  // 同一素材以不同缩放因子绘制时，两份快照都保留，不会互相覆盖。
+  auto snapshot = sharedCache->findSnapshot(assetID, makerKey, 0.5f);
+  ASSERT_NE(snapshot, nullptr);
+  EXPECT_EQ(snapshot->getTexture(), halfTexture.get());
+  EXPECT_EQ(snapshot->makingTime, 3000);
+  snapshot = sharedCache->findSnapshot(assetID, makerKey, 1.0f);
+  ASSERT_NE(snapshot, nullptr);
+  EXPECT_EQ(snapshot->getTexture(), fullTexture.get());
+  EXPECT_EQ(snapshot->makingTime, 5000);
+  EXPECT_EQ(sharedCache->findSnapshot(assetID, makerKey, 2.0f), nullptr);
+  EXPECT_EQ(sharedCache->findSnapshot(assetID, makerKey + 1, 1.0f), nullptr);
+  snapshot = nullptr;
+  fullSnapshot = nullptr;
+  fullTexture = nullptr;
+  // 快照纹理不再被任何 RenderCache 使用后，共享条目随之失效。
+  EXPECT_EQ(sharedCache->findSnapshot(assetID, makerKey, 1.0f), nullptr);
+  EXPECT_NE(sharedCache->findSnapshot(assetID, makerKey, 0.5f), nullptr);
+  halfSnapshot = nullptr;
+  halfTexture = nullptr;
+  device->unlock();
+}
+}  // namespace pag
@@ -20,6 +20,7 @@
 #include <vector>
 #include "core/Bitmap.h"
 #include "core/Image.h"
+#include "core/utils/PixelConverter.h"
 #include "framework/pag_test.h"
 #include "framework/utils/PAGTestUtils.h"
 #include "gpu/Surface.h"
@@ -349,4 +350,206 @@ PAG_TEST(PAGReadPixelsTest, JpegCodec) {
   ASSERT_TRUE(res);
 }
 
+/**
+ * 用例描述: PAGSurface 异步读取像素，结果与同步读取一致且回调按顺序执行
+ */
+PAG_TEST(PAGReadPixelsTest, PAGSurfaceReadPixelsAsync) {
+  auto pagFile = PAGFile::Load("../resources/apitest/test.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto pagSurface = PAGSurface::MakeOffscreen(pagFile->width(), pagFile->height());
+  ASSERT_TRUE(pagSurface != nullptr);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  auto rowBytes = static_cast<size_t>(pagSurface->width()) * 4;
+  auto byteSize = rowBytes * pagSurface->height();
+  std::vector<std::vector<uint8_t>> expectedPixels = {};
+  std::vector<std::vector<uint8_t>> asyncPixels(5, std::vector<uint8_t>(byteSize));
+  std::vector<int> finishedFrames = {};
+  for (int i = 0; i < 5; i++) {
+    pagPlayer->setProgress(i * 0.2);
+    pagPlayer->flush();
+    std::vector<uint8_t> pixels(byteSize);
+    ASSERT_TRUE(pagSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied,
+                                       pixels.data(), rowBytes));
+    expectedPixels.push_back(pixels);
+    auto result = pagSurface->readPixelsAsync(
+        ColorType::RGBA_8888, AlphaType::Premultiplied, asyncPixels[i].data(), rowBytes,
+        [&finishedFrames, i](bool success) {
+          EXPECT_TRUE(success);
+          finishedFrames.push_back(i);
+        });
+    ASSERT_TRUE(result);
+  }
+  pagSurface->finishReadPixels();
+  ASSERT_EQ(finishedFrames.size(), 5u);
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(finishedFrames[i], i);
+    EXPECT_TRUE(asyncPixels[i] == expectedPixels[i]) << "frame: " << i;
+  }
+
+  // Destroying the surface finishes the pending reading.
+  auto finished = false;
+  auto result = pagSurface->readPixelsAsync(
+      ColorType::RGBA_8888, AlphaType::Premultiplied, asyncPixels[0].data(), rowBytes,
+      [&finished](bool success) {
+        EXPECT_TRUE(success);
+        finished = true;
+      });
+  ASSERT_TRUE(result);
+  pagPlayer->setSurface(nullptr);
+  pagSurface = nullptr;
+  EXPECT_TRUE(finished);
+  EXPECT_TRUE(asyncPixels[0] == expectedPixels[4]);
+}
+
+/**
+ * 用例描述: 像素上传到按尺寸复用的纹理中，多次上传（含行间有填充的像素）后读回的内容与原始像素一致
+ */
+PAG_TEST(PAGReadPixelsTest, TextureUploader) {
+  auto image = Image::MakeFrom("../resources/apitest/test_timestretch.png");
+  ASSERT_TRUE(image != nullptr);
+  auto width = image->width();
+  auto height = image->height();
+  auto info =
+      ImageInfo::Make(width, height, tgfx::ColorType::RGBA_8888, tgfx::AlphaType::Premultiplied);
+  std::vector<uint8_t> pixels(info.byteSize());
+  ASSERT_TRUE(image->readPixels(info, pixels.data()));
+  auto paddedRowBytes = info.rowBytes() + 16;
+  std::vector<uint8_t> paddedPixels(paddedRowBytes * height);
+  for (int row = 0; row < height; row++) {
+    memcpy(paddedPixels.data() + row * paddedRowBytes, pixels.data() + row * info.rowBytes(),
+           info.rowBytes());
+  }
+  std::vector<uint8_t> blankPixels(info.byteSize(), 0);
+  std::vector<uint8_t> result(info.byteSize());
+
+  auto device = GLDevice::Make();
+  auto context = device->lockContext();
+  ASSERT_TRUE(context != nullptr);
+  auto surface = Surface::Make(context, width, height);
+  ASSERT_TRUE(surface != nullptr);
+  auto uploadedBytes = context->uploadedTextureBytes();
+  // Uploads more times than the number of staging buffers, and the texture released before each
+  // upload is recycled by the next one.
+  for (int i = 0; i < 6; i++) {
+    auto blank = Texture::MakeRGBA(context, width, height, blankPixels.data(), info.rowBytes());
+    ASSERT_TRUE(blank != nullptr);
+    blank = nullptr;
+    auto padded = i % 2 == 1;
+    auto texture = Texture::MakeRGBA(context, width, height,
+                                     padded ? paddedPixels.data() : pixels.data(),
+                                     padded ? paddedRowBytes : info.rowBytes());
+    ASSERT_TRUE(texture != nullptr);
+    auto canvas = surface->getCanvas();
+    canvas->clear();
+    canvas->drawTexture(texture.get());
+    ASSERT_TRUE(surface->readPixels(info, result.data()));
+    EXPECT_TRUE(result == pixels) << "upload: " << i;
+  }
+  EXPECT_EQ(context->uploadedTextureBytes() - uploadedBytes, info.byteSize() * 12);
+  device->unlock();
+}
+
+static void ConvertPixelReference(const uint8_t* src, uint8_t* dst, int count, bool swapRB,
+                                  tgfx::AlphaType srcAlphaType, tgfx::AlphaType dstAlphaType) {
+  for (int i = 0; i < count; i++) {
+    auto alpha = static_cast<float>(src[3]);
+    for (int c = 0; c < 3; c++) {
+      auto value = static_cast<float>(src[c]);
+      if (srcAlphaType == tgfx::AlphaType::Unpremultiplied &&
+          dstAlphaType == tgfx::AlphaType::Premultiplied) {
+        value = std::round(value * alpha / 255.0f);
+      } else if (srcAlphaType == tgfx::AlphaType::Premultiplied &&
+                 dstAlphaType == tgfx::AlphaType::Unpremultiplied) {
+        value = alpha == 0 ? 0 : std::min(std::round(value * 255.0f / alpha), 255.0f);
+      }
+      dst[swapRB ? 2 - c : c] = static_cast<uint8_t>(value);
+    }
+    dst[3] = src[3];
+    src += 4;
+    dst += 4;
+  }
+}
+
+/**
+ * 用例描述: 像素格式转换快速路径与参考实现的结果对比，预乘和交换通道必须完全一致，反预乘误差不超过1
+ */
+PAG_TEST(PAGReadPixelsTest, PixelConverter) {
+  // An odd width with an offset row to cover the unaligned heads and the scalar tails.
+  int width = 1027;
+  int height = 3;
+  std::vector<uint8_t> srcPixels(static_cast<size_t>(width) * height * 4);
+  uint32_t seed = 1;
+  for (auto& value : srcPixels) {
+    seed = seed * 1103515245 + 12345;
+    value = static_cast<uint8_t>(seed >> 16);
+  }
+  for (int i = 0; i < 64; i++) {
+    srcPixels[i * 4 + 3] = 255;
+    srcPixels[(i + 64) * 4 + 3] = 0;
+  }
+  auto premulPixels = srcPixels;
+  for (size_t i = 0; i < premulPixels.size(); i += 4) {
+    for (size_t c = 0; c < 3; c++) {
+      premulPixels[i + c] = std::min(premulPixels[i + c], premulPixels[i + 3]);
+    }
+  }
+  tgfx::ColorType colorTypes[] = {tgfx::ColorType::RGBA_8888, tgfx::ColorType::BGRA_8888};
+  tgfx::AlphaType alphaTypes[] = {tgfx::AlphaType::Premultiplied, tgfx::AlphaType::Unpremultiplied};
+  auto rowBytes = static_cast<size_t>(width) * 4;
+  for (auto srcColorType : colorTypes) {
+    for (auto srcAlphaType : alphaTypes) {
+      for (auto dstColorType : colorTypes) {
+        for (auto dstAlphaType : alphaTypes) {
+          if (srcColorType == dstColorType && srcAlphaType == dstAlphaType) {
+            continue;
+          }
+          auto& pixels = srcAlphaType == tgfx::AlphaType::Premultiplied ? premulPixels : srcPixels;
+          auto srcInfo = ImageInfo::Make(width - 1, height, srcColorType, srcAlphaType, rowBytes);
+          auto dstInfo = ImageInfo::Make(width - 1, height, dstColorType, dstAlphaType);
+          std::vector<uint8_t> dstPixels(dstInfo.byteSize());
+          Bitmap bitmap(srcInfo, pixels.data() + 4);
+          ASSERT_TRUE(bitmap.readPixels(dstInfo, dstPixels.data()));
+          std::vector<uint8_t> expected(dstInfo.byteSize());
+          for (int y = 0; y < height; y++) {
+            ConvertPixelReference(pixels.data() + rowBytes * y + 4,
+                                  expected.data() + dstInfo.rowBytes() * y, width - 1,
+                                  srcColorType != dstColorType, srcAlphaType, dstAlphaType);
+          }
+          auto tolerance = srcAlphaType == tgfx::AlphaType::Premultiplied &&
+                                   dstAlphaType == tgfx::AlphaType::Unpremultiplied
+                               ? 1
+                               : 0;
+          int maxDiff = 0;
+          for (size_t i = 0; i < expected.size(); i++) {
+            maxDiff = std::max(maxDiff, std::abs(dstPixels[i] - expected[i]));
+          }
+          EXPECT_LE(maxDiff, tolerance) << static_cast<int>(srcColorType) << "/"
+                                        << static_cast<int>(srcAlphaType) << " -> "
+                                        << static_cast<int>(dstColorType) << "/"
+                                        << static_cast<int>(dstAlphaType);
+        }
+      }
+    }
+  }
+
+  std::vector<uint8_t> alphaPixels(static_cast<size_t>(width));
+  auto proc = PixelConverter::GetProc(tgfx::ColorType::RGBA_8888, tgfx::AlphaType::Premultiplied,
+                                      tgfx::ColorType::ALPHA_8, tgfx::AlphaType::Premultiplied);
+  ASSERT_TRUE(proc != nullptr);
+  proc(alphaPixels.data(), premulPixels.data(), width);
+  std::vector<uint8_t> expandedPixels(rowBytes);
+  proc = PixelConverter::GetProc(tgfx::ColorType::ALPHA_8, tgfx::AlphaType::Premultiplied,
+                                 tgfx::ColorType::BGRA_8888, tgfx::AlphaType::Premultiplied);
+  ASSERT_TRUE(proc != nullptr);
+  proc(expandedPixels.data(), alphaPixels.data(), width);
+  for (int i = 0; i < width; i++) {
+    EXPECT_EQ(alphaPixels[i], premulPixels[i * 4 + 3]);
+    EXPECT_EQ(expandedPixels[i * 4], 0);
+    EXPECT_EQ(expandedPixels[i * 4 + 1], 0);
+    EXPECT_EQ(expandedPixels[i * 4 + 2], 0);
+    EXPECT_EQ(expandedPixels[i * 4 + 3], alphaPixels[i]);
+  }
+}
 }  // namespace pag
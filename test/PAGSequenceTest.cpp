@@ -16,11 +16,14 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "base/utils/TimeUtil.h"
 #include "framework/pag_test.h"
 #include "framework/utils/PAGTestUtils.h"
 #include "pag/pag.h"
 #include "platform/swiftshader/NativePlatform.h"
 #include "rendering/caches/RenderCache.h"
+#include "video/VideoDecoder.h"
+#include "video/VideoDecoderPool.h"
 
 namespace pag {
 
@@ -75,4 +78,164 @@ PAG_TEST_F(PAGSequenceTest, VideoSequenceAsMask) {
   pagPlayer->flush();
   EXPECT_TRUE(Baseline::Compare(pagSurface, "PAGSequenceTest/VideoSequenceAsMask"));
 }
+
+/**
+ * 用例描述: 视频序列帧提前解码多帧到缓冲队列，逐帧播放时的画面与只提前解码一帧时一致
+ */
+PAG_TEST_F(PAGSequenceTest, VideoFrameLookahead) {
+  auto pagFile = PAGFile::Load("../resources/apitest/wz_mvp.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto width = pagFile->width();
+  auto height = pagFile->height();
+  auto pagSurface = PAGSurface::MakeOffscreen(width, height);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  pagPlayer->renderCache->setVideoLookaheadFrames(4);
+  auto baseFile = PAGFile::Load("../resources/apitest/wz_mvp.pag");
+  auto baseSurface = PAGSurface::MakeOffscreen(width, height);
+  auto basePlayer = std::make_shared<PAGPlayer>();
+  basePlayer->setSurface(baseSurface);
+  basePlayer->setComposition(baseFile);
+  basePlayer->renderCache->setVideoLookaheadFrames(1);
+
+  auto rowBytes = static_cast<size_t>(width) * 4;
+  std::vector<uint8_t> pixels(rowBytes * height);
+  std::vector<uint8_t> basePixels(rowBytes * height);
+  auto totalFrames = TimeToFrame(pagFile->duration(), pagFile->frameRate());
+  int64_t prefetchedFrames = 0;
+  for (Frame frame = 0; frame < std::min(totalFrames, static_cast<Frame>(30)); frame++) {
+    auto progress = (frame + 0.1) * 1.0 / totalFrames;
+    pagPlayer->setProgress(progress);
+    pagPlayer->flush();
+    prefetchedFrames += pagPlayer->renderCache->videoPrefetchedFrames;
+    EXPECT_LE(pagPlayer->renderCache->videoBufferedFrames, 4);
+    basePlayer->setProgress(progress);
+    basePlayer->flush();
+    ASSERT_TRUE(pagSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied,
+                                       pixels.data(), rowBytes));
+    ASSERT_TRUE(baseSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied,
+                                        basePixels.data(), rowBytes));
+    EXPECT_TRUE(pixels == basePixels) << "frame: " << frame;
+  }
+  EXPECT_GT(prefetchedFrames, 0);
+}
+
+/**
+ * 用例描述: 视频序列帧按关键帧分段并行软解，逐帧导出时的画面与串行解码时一致，并支持回退播放
+ */
+PAG_TEST_F(PAGSequenceTest, VideoSegmentDecoding) {
+  auto pagFile = PAGFile::Load("../resources/apitest/wz_mvp.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto width = pagFile->width();
+  auto height = pagFile->height();
+  auto pagSurface = PAGSurface::MakeOffscreen(width, height);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  pagPlayer->renderCache->setVideoSegmentDecoders(4);
+  auto baseFile = PAGFile::Load("../resources/apitest/wz_mvp.pag");
+  auto baseSurface = PAGSurface::MakeOffscreen(width, height);
+  auto basePlayer = std::make_shared<PAGPlayer>();
+  basePlayer->setSurface(baseSurface);
+  basePlayer->setComposition(baseFile);
+
+  auto rowBytes = static_cast<size_t>(width) * 4;
+  std::vector<uint8_t> pixels(rowBytes * height);
+  std::vector<uint8_t> basePixels(rowBytes * height);
+  auto totalFrames = TimeToFrame(pagFile->duration(), pagFile->frameRate());
+  std::vector<Frame> frames = {};
+  for (Frame frame = 0; frame < std::min(totalFrames, static_cast<Frame>(60)); frame++) {
+    frames.push_back(frame);
+  }
+  // Seeks backwards at the end.
+  frames.push_back(std::min(totalFrames - 1, static_cast<Frame>(5)));
+  int64_t prefetchedFrames = 0;
+  for (auto frame : frames) {
+    auto progress = (frame + 0.1) * 1.0 / totalFrames;
+    pagPlayer->setProgress(progress);
+    pagPlayer->flush();
+    prefetchedFrames += pagPlayer->renderCache->videoPrefetchedFrames;
+    basePlayer->setProgress(progress);
+    basePlayer->flush();
+    ASSERT_TRUE(pagSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied,
+                                       pixels.data(), rowBytes));
+    ASSERT_TRUE(baseSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied,
+                                        basePixels.data(), rowBytes));
+    EXPECT_TRUE(pixels == basePixels) << "frame: " << frame;
+  }
+  // The segments ahead of the playhead are decoded in the background.
+  EXPECT_GT(prefetchedFrames, 0);
+}
+
+/**
+ * 用例描述: 视频序列帧上传到轮换复用的纹理中，循环播放时复用纹理的画面与首次播放时一致
+ */
+PAG_TEST_F(PAGSequenceTest, VideoStreamingTexture) {
+  auto pagFile = PAGFile::Load("../resources/apitest/wz_mvp.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto width = pagFile->width();
+  auto height = pagFile->height();
+  auto pagSurface = PAGSurface::MakeOffscreen(width, height);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+
+  auto rowBytes = static_cast<size_t>(width) * 4;
+  auto totalFrames = TimeToFrame(pagFile->duration(), pagFile->frameRate());
+  auto frameCount = std::min(totalFrames, static_cast<Frame>(10));
+  std::vector<std::vector<uint8_t>> basePixels = {};
+  std::vector<uint8_t> pixels(rowBytes * height);
+  for (int loop = 0; loop < 2; loop++) {
+    for (Frame frame = 0; frame < frameCount; frame++) {
+      pagPlayer->setProgress((frame + 0.1) * 1.0 / totalFrames);
+      pagPlayer->flush();
+      ASSERT_TRUE(pagSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied,
+                                         pixels.data(), rowBytes));
+      if (loop == 0) {
+        basePixels.push_back(pixels);
+      } else {
+        EXPECT_TRUE(pixels == basePixels[frame]) << "frame: " << frame;
+      }
+    }
+  }
+}
+
+#ifdef PAG_USE_LIBAVC
+static std::vector<uint8_t> ReadVideoFrame(const std::string& path, float progress) {
+  auto pagFile = PAGFile::Load(path);
+  auto pagSurface = PAGSurface::MakeOffscreen(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  pagPlayer->setProgress(progress);
+  pagPlayer->flush();
+  auto rowBytes = static_cast<size_t>(pagFile->width()) * 4;
+  std::vector<uint8_t> pixels(rowBytes * pagFile->height());
+  pagSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied, pixels.data(), rowBytes);
+  return pixels;
+}
+
+/**
+ * 用例描述: 内置软解码器释放后被同尺寸的视频序列帧复用，复用时解码的画面与新建解码器时一致
+ */
+PAG_TEST_F(PAGSequenceTest, SoftwareDecoderReuse) {
+  auto factory = VideoDecoder::GetExternalSoftwareDecoderFactory();
+  PAGVideoDecoder::RegisterSoftwareDecoderFactory(nullptr);
+  PAGVideoDecoder::SetMaxIdleSoftwareDecoderCount(0);
+  auto path = "../resources/apitest/wz_mvp.pag";
+  auto basePixels = ReadVideoFrame(path, 0.6f);
+  EXPECT_EQ(VideoDecoderPool::IdleCount(), 0u);
+  PAGVideoDecoder::SetMaxIdleSoftwareDecoderCount(2);
+  auto reusedCount = VideoDecoderPool::ReusedCount();
+  ReadVideoFrame(path, 0.2f);
+  EXPECT_EQ(VideoDecoderPool::ReusedCount(), reusedCount);
+  // The decoder released by the previous player is kept in the pool and reused here.
+  EXPECT_GT(VideoDecoderPool::IdleCount(), 0u);
+  auto pixels = ReadVideoFrame(path, 0.6f);
+  EXPECT_GT(VideoDecoderPool::ReusedCount(), reusedCount);
+  EXPECT_TRUE(pixels == basePixels);
+  PAGVideoDecoder::RegisterSoftwareDecoderFactory(factory);
+}
+#endif
 }  // namespace pag
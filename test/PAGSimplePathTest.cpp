@@ -18,7 +18,9 @@
 
 #include "framework/pag_test.h"
 #include "framework/utils/PAGTestUtils.h"
+#include "gpu/PathMaskCache.h"
 #include "nlohmann/json.hpp"
+#include "rendering/caches/RenderCache.h"
 
 namespace pag {
 using nlohmann::json;
@@ -39,4 +41,92 @@ PAG_TEST_F(PAGSimplePathTest, TestRect) {
   pagPlayer->flush();
   EXPECT_TRUE(Baseline::Compare(pagSurface, "PAGSimplePathTest/TestRect"));
 }
+
+static std::vector<uint8_t> ReadSurfacePixels(std::shared_ptr<PAGSurface> pagSurface) {
+  auto rowBytes = static_cast<size_t>(pagSurface->width()) * 4;
+  std::vector<uint8_t> pixels(rowBytes * pagSurface->height());
+  pagSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied, pixels.data(), rowBytes);
+  return pixels;
+}
+
+/**
+ * 用例描述: 开启后凸路径通过 GPU 三角化绘制，不再走 CPU 光栅化，与光栅化的结果仅在边缘有细微差异
+ */
+PAG_TEST_F(PAGSimplePathTest, TriangulatedPath) {
+  auto pagFile = PAGFile::Load("../resources/apitest/ellipse_to_path.pag");
+  auto pagSurface = PAGSurface::MakeOffscreen(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  pagPlayer->setProgress(0);
+  pagPlayer->flush();
+  // Disabled by default on render targets without MSAA.
+  EXPECT_EQ(pagPlayer->renderCache->triangulatedPathCount, 0);
+  EXPECT_GT(pagPlayer->renderCache->rasterizedPathCount, 0);
+  auto rasterizedPixels = ReadSurfacePixels(pagSurface);
+
+  EXPECT_FALSE(pagPlayer->pathTriangulationEnabled());
+  pagPlayer->setPathTriangulationEnabled(true);
+  pagSurface->clearAll();
+  pagPlayer->flush();
+  EXPECT_GT(pagPlayer->renderCache->triangulatedPathCount, 0);
+  EXPECT_EQ(pagPlayer->renderCache->rasterizedPathCount, 0);
+  auto triangulatedPixels = ReadSurfacePixels(pagSurface);
+  ASSERT_EQ(triangulatedPixels.size(), rasterizedPixels.size());
+  int maxDiff = 0;
+  size_t edgeCount = 0;
+  for (size_t i = 0; i < triangulatedPixels.size(); i++) {
+    auto diff = abs(triangulatedPixels[i] - rasterizedPixels[i]);
+    maxDiff = std::max(maxDiff, diff);
+    if (diff > 5) {
+      edgeCount++;
+    }
+  }
+  // The coverage ramps differ from the analytic coverage by less than a quarter, and only the
+  // pixels along the edges are different.
+  EXPECT_LE(maxDiff, 64);
+  EXPECT_LE(edgeCount, triangulatedPixels.size() / 100);
+}
+
+/**
+ * 用例描述: 测试路径遮罩缓存，平移后复用已光栅化的路径遮罩，且与不使用缓存光栅化的结果一致
+ */
+PAG_TEST_F(PAGSimplePathTest, PathMaskCache) {
+  auto pagFile = PAGFile::Load("../resources/apitest/test_repeat.pag");
+  auto pagSurface = PAGSurface::MakeOffscreen(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  // 关闭快照缓存，保证每次都重新绘制路径.
+  pagPlayer->setCacheEnabled(false);
+  pagPlayer->setMatrix(Matrix::I());
+  pagPlayer->setProgress(0);
+  pagPlayer->flush();
+  auto renderCache = pagPlayer->renderCache;
+  EXPECT_GT(renderCache->rasterizedPathCount, 0);
+  EXPECT_LE(renderCache->pathMaskCacheHits + renderCache->pathMaskCacheMisses,
+            renderCache->rasterizedPathCount);
+  // 非整像素的平移同样复用遮罩.
+  pagPlayer->setMatrix(Matrix::MakeTrans(10.3f, 20.6f));
+  pagPlayer->flush();
+  EXPECT_GT(renderCache->pathMaskCacheHits, 0);
+  EXPECT_EQ(renderCache->pathMaskCacheMisses, 0);
+  EXPECT_LE(renderCache->pathMaskCacheHits, renderCache->rasterizedPathCount);
+  auto cachedPixels = ReadSurfacePixels(pagSurface);
+
+  auto context = pagSurface->device->lockContext();
+  ASSERT_TRUE(context != nullptr);
+  context->pathMaskCache()->setMaxBytes(0);
+  pagSurface->device->unlock();
+  pagSurface->clearAll();
+  pagPlayer->flush();
+  EXPECT_EQ(renderCache->pathMaskCacheHits, 0);
+  auto uncachedPixels = ReadSurfacePixels(pagSurface);
+  ASSERT_EQ(cachedPixels.size(), uncachedPixels.size());
+  int maxDiff = 0;
+  for (size_t i = 0; i < cachedPixels.size(); i++) {
+    maxDiff = std::max(maxDiff, abs(cachedPixels[i] - uncachedPixels[i]));
+  }
+  EXPECT_LE(maxDiff, 1);
+}
 }  // namespace pag
@@ -23,6 +23,8 @@
 #include "framework/utils/PAGTestUtils.h"
 #include "nlohmann/json.hpp"
 #include "pag/file.h"
+#include "rendering/caches/GlyphAtlas.h"
+#include "rendering/caches/RenderCache.h"
 #include "rendering/renderers/TextRenderer.h"
 
 namespace pag {
@@ -394,4 +396,232 @@ PAG_TEST_F(PAGTextLayerTest, TrackMatteTextBounds) {
   }
 }
 
+/**
+ * 用例描述: PAGTextLayer 文本绘制时合并 DrawCall，DrawCall 数量不随字符数线性增长
+ */
+PAG_TEST_F(PAGTextLayerTest, DrawCallCount) {
+  ASSERT_NE(TestPAGFile, nullptr);
+  TestPAGFile->setCurrentTime(5 * 1000000);
+  int target = 0;
+  auto layer = GetLayer(TestPAGFile, LayerType::Text, target);
+  ASSERT_NE(layer, nullptr);
+  auto textLayer = std::static_pointer_cast<pag::PAGTextLayer>(layer);
+  auto oldText = textLayer->text();
+  textLayer->setText("A");
+  TestPAGPlayer->flush();
+  auto singleGlyphCount = TestPAGPlayer->drawCallCount();
+  EXPECT_GT(singleGlyphCount, 0);
+  std::string longText = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+  textLayer->setText(longText);
+  TestPAGPlayer->flush();
+  auto multiGlyphCount = TestPAGPlayer->drawCallCount();
+  EXPECT_LT(multiGlyphCount - singleGlyphCount, static_cast<int64_t>(longText.size() / 2));
+  textLayer->setText(oldText);
+  TestPAGPlayer->flush();
+}
+
+/**
+ * 用例描述: GlyphAtlas 字号分档与 Skyline 装箱
+ */
+PAG_TEST_F(PAGTextLayerTest, GlyphAtlas) {
+  EXPECT_FLOAT_EQ(GlyphAtlas::BucketFontSize(16.0f), 16.0f);
+  auto bucketSize = GlyphAtlas::BucketFontSize(16.5f);
+  EXPECT_GT(bucketSize, 16.5f);
+  // 字号在同一档位内变化时，不需要重新光栅化字形。
+  EXPECT_FLOAT_EQ(GlyphAtlas::BucketFontSize(17.0f), bucketSize);
+  SkylinePacker packer(64, 64);
+  tgfx::Point location = {};
+  EXPECT_TRUE(packer.addRect(40, 20, &location));
+  EXPECT_TRUE(location == tgfx::Point::Make(0, 0));
+  EXPECT_TRUE(packer.addRect(24, 10, &location));
+  EXPECT_TRUE(location == tgfx::Point::Make(40, 0));
+  EXPECT_TRUE(packer.addRect(24, 10, &location));
+  EXPECT_TRUE(location == tgfx::Point::Make(40, 10));
+  EXPECT_TRUE(packer.addRect(64, 44, &location));
+  EXPECT_TRUE(location == tgfx::Point::Make(0, 20));
+  EXPECT_FALSE(packer.addRect(1, 1, &location));
+  packer.reset();
+  EXPECT_TRUE(packer.addRect(64, 64, &location));
+}
+
+/**
+ * 用例描述: 多个 PAGPlayer 共享 GlyphAtlas 时，图集显存只统计一次
+ */
+PAG_TEST_F(PAGTextLayerTest, SharedGlyphAtlasMemory) {
+  auto pagFile = PAGFile::Load(DEFAULT_PAG_PATH);
+  ASSERT_NE(pagFile, nullptr);
+  auto pagSurface = PAGSurface::MakeOffscreen(pagFile->width(), pagFile->height());
+  ASSERT_NE(pagSurface, nullptr);
+  std::vector<std::shared_ptr<PAGPlayer>> players = {};
+  for (int i = 0; i < 2; i++) {
+    auto pagPlayer = std::make_shared<PAGPlayer>();
+    // 关闭快照缓存，文字每次都直接从 GlyphAtlas 绘制。
+    pagPlayer->setCacheEnabled(false);
+    pagPlayer->setSharedCacheEnabled(true);
+    pagPlayer->setSurface(pagSurface);
+    pagPlayer->setComposition(PAGFile::Load(DEFAULT_PAG_PATH));
+    pagPlayer->setProgress(0.5);
+    pagPlayer->flush();
+    pagPlayer->setSurface(nullptr);
+    players.push_back(pagPlayer);
+  }
+  auto firstCache = players[0]->renderCache;
+  auto secondCache = players[1]->renderCache;
+  ASSERT_NE(firstCache->glyphAtlas, nullptr);
+  EXPECT_EQ(firstCache->glyphAtlas, secondCache->glyphAtlas);
+  auto atlasMemory = firstCache->glyphAtlas->memoryUsage();
+  EXPECT_GT(atlasMemory, 0u);
+  EXPECT_EQ(firstCache->glyphAtlasMemory + secondCache->glyphAtlasMemory, atlasMemory);
+  // 第二个 PAGPlayer 绘制相同的文字时复用已有的字形，没有分配新的页面。
+  EXPECT_EQ(secondCache->glyphAtlasMemory, 0u);
+}
+
+/**
+ * 用例描述: 缩放动画中的文字按字号档位光栅化，字形数量不随帧数增长，停止缩放后改回精确字号
+ */
+PAG_TEST_F(PAGTextLayerTest, ScaleAnimatedGlyphs) {
+  auto pagFile = PAGFile::Load(DEFAULT_PAG_PATH);
+  ASSERT_NE(pagFile, nullptr);
+  auto pagSurface = PAGSurface::MakeOffscreen(pagFile->width(), pagFile->height());
+  ASSERT_NE(pagSurface, nullptr);
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  // 关闭快照缓存，文字每次都直接从 GlyphAtlas 绘制。
+  pagPlayer->setCacheEnabled(false);
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  pagFile->setCurrentTime(5 * 1000000);
+  int target = 0;
+  auto textLayer = GetLayer(pagFile, LayerType::Text, target);
+  ASSERT_NE(textLayer, nullptr);
+  pagPlayer->flush();
+  auto renderCache = pagPlayer->renderCache;
+  ASSERT_NE(renderCache->glyphAtlas, nullptr);
+  auto glyphCount = renderCache->glyphAtlas->glyphLocations.size();
+  EXPECT_GT(glyphCount, 0u);
+  for (int i = 1; i <= 40; i++) {
+    textLayer->setMatrix(Matrix::MakeScale(1.0f + 0.01f * static_cast<float>(i)));
+    pagPlayer->flush();
+  }
+  // 缩放因子从 1.01 变化到 1.4 时最多经过三个字号档位，加上初始的精确字号，最多四份字形。
+  EXPECT_LE(renderCache->glyphAtlas->glyphLocations.size(), glyphCount * 4);
+  bool bucketed = false;
+  for (auto& item : renderCache->textAtlases) {
+    bucketed = bucketed || item.second->bucketed();
+  }
+  EXPECT_TRUE(bucketed);
+  // 关闭自动清屏后每次 flush 都会重新绘制，即使内容没有变化。
+  pagPlayer->setAutoClear(false);
+  for (int i = 0; i < 20; i++) {
+    pagPlayer->flush();
+  }
+  for (auto& item : renderCache->textAtlases) {
+    EXPECT_FALSE(item.second->bucketed());
+  }
+}
+
+static bool HasDistanceFieldText(RenderCache* renderCache) {
+  for (auto& item : renderCache->textAtlases) {
+    if (item.second->distanceField()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Draws the first text layer of the default file at the specified scale. If previousScale is
+ * greater than zero, the layer is drawn at it in the frame before, which makes the text switch to
+ * the distance field mode.
+ */
+static std::vector<uint8_t> RenderScaledText(float scale, float previousScale,
+                                             bool* distanceField) {
+  auto pagFile = PAGFile::Load(DEFAULT_PAG_PATH);
+  auto pagSurface = PAGSurface::MakeOffscreen(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setDistanceFieldTextEnabled(previousScale > 0);
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  pagFile->setCurrentTime(5 * 1000000);
+  int target = 0;
+  auto textLayer = GetLayer(pagFile, LayerType::Text, target);
+  if (previousScale > 0) {
+    textLayer->setMatrix(Matrix::MakeScale(previousScale));
+    pagPlayer->flush();
+  }
+  textLayer->setMatrix(Matrix::MakeScale(scale));
+  pagPlayer->flush();
+  *distanceField = HasDistanceFieldText(pagPlayer->renderCache);
+  auto rowBytes = static_cast<size_t>(pagSurface->width()) * 4;
+  std::vector<uint8_t> pixels(rowBytes * pagSurface->height());
+  pagSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied, pixels.data(), rowBytes);
+  return pixels;
+}
+
+/**
+ * 用例描述: 距离场文字在不同缩放下与按字号光栅化的文字误差在容忍范围内，默认不开启距离场
+ */
+PAG_TEST_F(PAGTextLayerTest, DistanceFieldText) {
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  EXPECT_FALSE(pagPlayer->distanceFieldTextEnabled());
+  std::vector<float> scales = {0.5f, 1.0f, 2.0f, 3.0f};
+  for (auto scale : scales) {
+    bool distanceField = false;
+    auto expected = RenderScaledText(scale, 0, &distanceField);
+    EXPECT_FALSE(distanceField) << scale;
+    auto actual = RenderScaledText(scale, scale * 1.25f, &distanceField);
+    EXPECT_TRUE(distanceField) << scale;
+    ASSERT_EQ(expected.size(), actual.size());
+    size_t textPixels = 0;
+    size_t diffCount = 0;
+    for (size_t i = 0; i < expected.size(); i++) {
+      if (expected[i] != 0) {
+        textPixels++;
+      }
+      // 距离场的边缘稍软，只统计明显不同的像素。
+      if (abs(expected[i] - actual[i]) > 64) {
+        diffCount++;
+      }
+    }
+    EXPECT_GT(textPixels, 0u) << scale;
+    EXPECT_LE(diffCount, expected.size() / 200) << scale;
+  }
+}
+
+/**
+ * 用例描述: 缩放因子停止变化后，距离场文字改回按字号光栅化的字形
+ */
+PAG_TEST_F(PAGTextLayerTest, DistanceFieldTextSettles) {
+  ASSERT_NE(TestPAGFile, nullptr);
+  TestPAGFile->setCurrentTime(5 * 1000000);
+  int target = 0;
+  auto textLayer = GetLayer(TestPAGFile, LayerType::Text, target);
+  ASSERT_NE(textLayer, nullptr);
+  auto renderCache = TestPAGPlayer->renderCache;
+  auto oldMatrix = textLayer->matrix();
+  auto autoClear = TestPAGPlayer->autoClear();
+  // 关闭自动清屏后每次 flush 都会重新绘制，即使内容没有变化。
+  TestPAGPlayer->setAutoClear(false);
+  TestPAGPlayer->setDistanceFieldTextEnabled(true);
+  textLayer->setMatrix(Matrix::MakeScale(1.5f));
+  TestPAGPlayer->flush();
+  for (int i = 0; i < 5; i++) {
+    textLayer->setMatrix(Matrix::MakeScale(2.0f + 0.25f * static_cast<float>(i)));
+    TestPAGPlayer->flush();
+    EXPECT_TRUE(HasDistanceFieldText(renderCache));
+  }
+  for (int i = 0; i < 20; i++) {
+    TestPAGPlayer->flush();
+  }
+  EXPECT_FALSE(HasDistanceFieldText(renderCache));
+  textLayer->setMatrix(Matrix::MakeScale(2.5f));
+  TestPAGPlayer->flush();
+  EXPECT_TRUE(HasDistanceFieldText(renderCache));
+  TestPAGPlayer->setDistanceFieldTextEnabled(false);
+  TestPAGPlayer->flush();
+  EXPECT_FALSE(HasDistanceFieldText(renderCache));
+  TestPAGPlayer->setAutoClear(autoClear);
+  textLayer->setMatrix(oldMatrix);
+  TestPAGPlayer->flush();
+}
+
 }  // namespace pag
@@ -0,0 +1,109 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <thread>
+#include "base/utils/Task.h"
+#include "framework/pag_test.h"
+
+namespace pag {
+class CountingExecutor : public Executor {
+ public:
+  explicit CountingExecutor(std::atomic_int* counter) : counter(counter) {
+  }
+
+ private:
+  std::atomic_int* counter = nullptr;
+
+  void execute() override {
+    (*counter)++;
+  }
+};
+
+class ThreadExecutor : public PAGExecutor {
+ public:
+  ~ThreadExecutor() override {
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  void execute(std::function<void()> work, bool highPriority) override {
+    std::lock_guard<std::mutex> autoLock(locker);
+    highPriorityCount += highPriority ? 1 : 0;
+    threads.emplace_back(std::move(work));
+  }
+
+  int highPriorityCount = 0;
+
+ private:
+  std::mutex locker = {};
+  std::vector<std::thread> threads = {};
+};
+
+/**
+ * 用例描述: 测试任务的执行、等待和取消
+ */
+PAG_TEST(TaskTest, RunWaitAndCancel) {
+  std::atomic_int counter = {0};
+  std::vector<std::shared_ptr<Task>> tasks = {};
+  for (int i = 0; i < 100; i++) {
+    auto task = Task::Make(std::make_unique<CountingExecutor>(&counter));
+    task->run(i % 2 == 0 ? TaskPriority::High : TaskPriority::Low);
+    tasks.push_back(task);
+  }
+  int cancelCount = 0;
+  for (size_t i = 0; i < tasks.size(); i += 3) {
+    tasks[i]->cancel();
+    EXPECT_FALSE(tasks[i]->isRunning());
+    cancelCount++;
+  }
+  for (auto& task : tasks) {
+    task->wait();
+    EXPECT_FALSE(task->isRunning());
+  }
+  EXPECT_GE(counter.load(), 100 - cancelCount);
+  EXPECT_LE(counter.load(), 100);
+  tasks.clear();
+  counter = 0;
+  auto task = Task::Make(std::make_unique<CountingExecutor>(&counter));
+  task->run();
+  task->wait();
+  task->run(TaskPriority::Low);
+  task->wait();
+  EXPECT_EQ(counter.load(), 2);
+}
+
+/**
+ * 用例描述: 测试注册外部的 PAGExecutor 执行任务
+ */
+PAG_TEST(TaskTest, HostExecutor) {
+  auto executor = std::make_shared<ThreadExecutor>();
+  PAGExecutor::Register(executor);
+  std::atomic_int counter = {0};
+  auto highTask = Task::Make(std::make_unique<CountingExecutor>(&counter));
+  highTask->run(TaskPriority::High);
+  auto lowTask = Task::Make(std::make_unique<CountingExecutor>(&counter));
+  lowTask->run(TaskPriority::Low);
+  highTask->wait();
+  lowTask->wait();
+  PAGExecutor::Register(nullptr);
+  EXPECT_EQ(executor->highPriorityCount, 1);
+  EXPECT_EQ(counter.load(), 2);
+}
+}  // namespace pag
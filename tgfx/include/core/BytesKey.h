@@ -34,6 +34,13 @@ class BytesKey {
     return !values.empty();
   }
 
+  /**
+   * Returns the number of uint32 values written into the key.
+   */
+  size_t size() const {
+    return values.size();
+  }
+
   /**
    * Writes a uint32 value into the key.
    */
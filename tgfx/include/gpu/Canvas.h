@@ -183,6 +183,16 @@ class Canvas {
   virtual void drawAtlas(const Texture* atlas, const Matrix matrix[], const Rect tex[],
                          const Color colors[], size_t count) = 0;
 
+  /**
+   * Draws a set of sprites from a single channel signed distance field atlas, using current alpha,
+   * blend mode, clip and Matrix. The atlas stores 0.5 on the edges of the shapes, and distanceRange
+   * is the number of atlas pixels covered by the full [0, 1] range of the stored values. Unlike
+   * drawAtlas(), the sprites keep sharp edges when they are scaled up.
+   */
+  virtual void drawDistanceFieldAtlas(const Texture* atlas, const Matrix matrix[],
+                                      const Rect tex[], const Color colors[], size_t count,
+                                      float distanceRange) = 0;
+
   /**
    * Triggers the immediate execution of all pending draw operations.
    */
@@ -28,6 +28,8 @@ class ProgramCache;
 
 class GradientCache;
 
+class PathMaskCache;
+
 class ResourceCache;
 
 class Caps;
@@ -50,6 +52,13 @@ class Context {
     return _gradientCache;
   }
 
+  /**
+   * Returns the associated cache that keeps the mask textures of recently rasterized paths.
+   */
+  PathMaskCache* pathMaskCache() const {
+    return _pathMaskCache;
+  }
+
   /**
    * Returns the associated cache that manages the lifetime of all Program instances.
    */
@@ -79,14 +88,76 @@ class Context {
    */
   virtual const Caps* caps() const = 0;
 
+  /**
+   * Returns the total number of draw calls issued through this context since it was created.
+   */
+  size_t drawCallCount() const {
+    return _drawCallCount;
+  }
+
+  /**
+   * Records draw calls that were issued to the backend directly instead of through a Canvas, so
+   * that they are also included in drawCallCount().
+   */
+  void recordDrawCalls(size_t count = 1) {
+    _drawCallCount += count;
+  }
+
+  /**
+   * Returns true if convex paths are also filled by triangulating them on the GPU when the render
+   * target has no MSAA, in which case the edges are antialiased by coverage ramps. The ramps are
+   * slightly different from the antialiasing of the masks rasterized on the CPU, so it is disabled
+   * by default. Convex paths are always triangulated on render targets with MSAA.
+   */
+  bool pathTriangulationEnabled() const {
+    return _pathTriangulationEnabled;
+  }
+
+  /**
+   * Sets whether to triangulate convex paths on render targets without MSAA.
+   */
+  void setPathTriangulationEnabled(bool value) {
+    _pathTriangulationEnabled = value;
+  }
+
+  /**
+   * Returns the total number of paths filled by triangulating them on the GPU since the context was
+   * created.
+   */
+  size_t triangulatedPathCount() const {
+    return _triangulatedPathCount;
+  }
+
+  /**
+   * Returns the total number of paths filled by mask textures rasterized on the CPU since the
+   * context was created, including the ones served by the PathMaskCache.
+   */
+  size_t rasterizedPathCount() const {
+    return _rasterizedPathCount;
+  }
+
+  /**
+   * Returns the total number of pixel bytes uploaded from the CPU into textures since the context
+   * was created.
+   */
+  size_t uploadedTextureBytes() const {
+    return _uploadedTextureBytes;
+  }
+
  protected:
   explicit Context(Device* device);
 
  private:
   Device* _device = nullptr;
   GradientCache* _gradientCache = nullptr;
+  PathMaskCache* _pathMaskCache = nullptr;
   ProgramCache* _programCache = nullptr;
   ResourceCache* _resourceCache = nullptr;
+  size_t _drawCallCount = 0;
+  size_t _triangulatedPathCount = 0;
+  size_t _rasterizedPathCount = 0;
+  size_t _uploadedTextureBytes = 0;
+  bool _pathTriangulationEnabled = false;
 
   void releaseAll(bool releaseGPU);
   void onLocked();
@@ -95,6 +166,9 @@ class Context {
   friend class Device;
 
   friend class Resource;
+
+  friend class GLCanvas;
+  friend class GLTextureUploader;
 };
 
 }  // namespace tgfx
@@ -0,0 +1,82 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "core/ImageInfo.h"
+#include "gpu/Resource.h"
+
+namespace tgfx {
+/**
+ * ReadbackBuffer is a buffer in the GPU backend which receives the pixels of a Surface
+ * asynchronously (see Surface::readPixels(ReadbackBuffer*)). The copy is scheduled on the GPU
+ * command stream, so the caller can keep rendering while the GPU transfers the pixels, and fetch
+ * them later by calling readPixels().
+ */
+class ReadbackBuffer : public Resource {
+ public:
+  /**
+   * Creates a new ReadbackBuffer which can hold all pixels of a surface with the specified size.
+   * Returns nullptr if any of the parameters is not valid or the backend does not support
+   * asynchronous pixel reading.
+   */
+  static std::shared_ptr<ReadbackBuffer> Make(Context* context, int width, int height,
+                                              bool alphaOnly = false);
+
+  /**
+   * Returns the width of the readback buffer.
+   */
+  int width() const {
+    return _width;
+  }
+
+  /**
+   * Returns the height of the readback buffer.
+   */
+  int height() const {
+    return _height;
+  }
+
+  /**
+   * Returns true if pixels have been scheduled to copy into this buffer and they have not been
+   * fetched by readPixels() yet.
+   */
+  virtual bool isPending() const = 0;
+
+  /**
+   * Returns true if the GPU has finished copying pixels into this buffer, which means calling
+   * readPixels() will not block the calling thread.
+   */
+  virtual bool isReady() const = 0;
+
+  /**
+   * Copies the pending pixels to dstPixels with specified color type, alpha type and row bytes,
+   * waits for the GPU to finish the copy if necessary. Returns true if pixels are copied to
+   * dstPixels. The buffer can be reused for the next reading after this call.
+   */
+  virtual bool readPixels(const ImageInfo& dstInfo, void* dstPixels) = 0;
+
+ protected:
+  ReadbackBuffer(int width, int height) : _width(width), _height(height) {
+  }
+
+ private:
+  int _width = 0;
+  int _height = 0;
+};
+}  // namespace tgfx
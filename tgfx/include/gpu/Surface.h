@@ -20,6 +20,7 @@
 
 #include "core/ImageInfo.h"
 #include "gpu/Canvas.h"
+#include "gpu/ReadbackBuffer.h"
 #include "gpu/RenderTarget.h"
 #include "gpu/Semaphore.h"
 
@@ -160,6 +161,14 @@ class Surface {
    */
   bool readPixels(const ImageInfo& dstInfo, void* dstPixels, int srcX = 0, int srcY = 0) const;
 
+  /**
+   * Schedules copying all pixels of the Surface into the specified readback buffer and returns
+   * immediately without waiting for the GPU to finish rendering. The pixels can be fetched later by
+   * calling ReadbackBuffer::readPixels(). Any pending pixels in the buffer are discarded. Returns
+   * false if the size of the buffer does not match the Surface or the copy fails to schedule.
+   */
+  bool readPixels(ReadbackBuffer* readbackBuffer) const;
+
   /**
    * Evaluates the Surface to see if it overlaps or intersects with the specified point. The point
    * is in the coordinate space of the Surface. This method always checks against the actual pixels
@@ -171,6 +180,8 @@ class Surface {
   virtual bool onReadPixels(const ImageInfo& dstInfo, void* dstPixels, int srcX,
                             int srcY) const = 0;
 
+  virtual bool onReadPixels(ReadbackBuffer* readbackBuffer) const = 0;
+
  private:
   Context* context = nullptr;
   std::unique_ptr<SurfaceOptions> surfaceOptions = nullptr;
@@ -56,6 +56,14 @@ class YUVTexture : public Texture {
         _colorRange(colorRange) {
   }
 
+  /**
+   * Replaces the pixels of this texture with the specified I420 buffers, which must have the same
+   * size as this texture. The texture storage is reused rather than reallocated, which makes it
+   * much cheaper than creating a new texture for every video frame. Returns false if the pixel
+   * format of this texture is not I420.
+   */
+  virtual bool updateI420(uint8_t* pixelsPlane[3], const int lineSize[3]);
+
   /**
    * The pixel format of this yuv texture.
    */
@@ -18,7 +18,12 @@
 
 #include "core/Bitmap.h"
 #include "core/Image.h"
+#include "core/utils/PixelConverter.h"
 #include "skcms.h"
+#ifndef __EMSCRIPTEN__
+#include <thread>
+#include <vector>
+#endif
 
 namespace tgfx {
 
@@ -55,20 +60,29 @@ static const std::unordered_map<AlphaType, gfx::skcms_AlphaFormat> AlphaMapper{
     {AlphaType::Opaque, gfx::skcms_AlphaFormat::skcms_AlphaFormat_Opaque},
 };
 
-static void ConvertPixels(const ImageInfo& srcInfo, const void* srcPixels, const ImageInfo& dstInfo,
-                          void* dstPixels) {
-  if (srcInfo.colorType() == dstInfo.colorType() && srcInfo.alphaType() == dstInfo.alphaType()) {
-    CopyRectMemory(srcPixels, srcInfo.rowBytes(), dstPixels, dstInfo.rowBytes(),
-                   dstInfo.minRowBytes(), dstInfo.height());
+// The minimum number of pixels converted by each thread, smaller images are not worth the cost of
+// starting threads.
+static constexpr int MinPixelsPerThread = 512 * 512;
+static constexpr int MaxConvertThreads = 4;
+
+static void ConvertRows(const ImageInfo& srcInfo, const void* srcPixels, const ImageInfo& dstInfo,
+                        void* dstPixels, int rowCount) {
+  auto width = dstInfo.width();
+  auto proc = PixelConverter::GetProc(srcInfo.colorType(), srcInfo.alphaType(),
+                                      dstInfo.colorType(), dstInfo.alphaType());
+  if (proc != nullptr) {
+    for (int i = 0; i < rowCount; i++) {
+      proc(dstPixels, srcPixels, width);
+      dstPixels = AddOffset(dstPixels, dstInfo.rowBytes());
+      srcPixels = AddOffset(srcPixels, srcInfo.rowBytes());
+    }
     return;
   }
   auto srcFormat = ColorMapper.at(srcInfo.colorType());
   auto srcAlpha = AlphaMapper.at(srcInfo.alphaType());
   auto dstFormat = ColorMapper.at(dstInfo.colorType());
   auto dstAlpha = AlphaMapper.at(dstInfo.alphaType());
-  auto width = dstInfo.width();
-  auto height = dstInfo.height();
-  for (int i = 0; i < height; i++) {
+  for (int i = 0; i < rowCount; i++) {
     gfx::skcms_Transform(srcPixels, srcFormat, srcAlpha, nullptr, dstPixels, dstFormat, dstAlpha,
                          nullptr, width);
     dstPixels = AddOffset(dstPixels, dstInfo.rowBytes());
@@ -76,6 +90,49 @@ static void ConvertPixels(const ImageInfo& srcInfo, const void* srcPixels, const
   }
 }
 
+static int GetConvertThreadCount(const ImageInfo& info) {
+#ifdef __EMSCRIPTEN__
+  (void)info;
+  return 1;
+#else
+  auto threadCount = static_cast<int>(std::thread::hardware_concurrency());
+  threadCount = std::min(threadCount, MaxConvertThreads);
+  auto pixelCount = static_cast<int64_t>(info.width()) * info.height();
+  threadCount = std::min(threadCount, static_cast<int>(pixelCount / MinPixelsPerThread));
+  return std::max(threadCount, 1);
+#endif
+}
+
+static void ConvertPixels(const ImageInfo& srcInfo, const void* srcPixels, const ImageInfo& dstInfo,
+                          void* dstPixels) {
+  if (srcInfo.colorType() == dstInfo.colorType() && srcInfo.alphaType() == dstInfo.alphaType()) {
+    CopyRectMemory(srcPixels, srcInfo.rowBytes(), dstPixels, dstInfo.rowBytes(),
+                   dstInfo.minRowBytes(), dstInfo.height());
+    return;
+  }
+  auto height = dstInfo.height();
+  auto threadCount = GetConvertThreadCount(dstInfo);
+  if (threadCount <= 1) {
+    ConvertRows(srcInfo, srcPixels, dstInfo, dstPixels, height);
+    return;
+  }
+#ifndef __EMSCRIPTEN__
+  // Splits the rows into bands, the calling thread converts the first band by itself.
+  auto bandHeight = (height + threadCount - 1) / threadCount;
+  std::vector<std::thread> threads = {};
+  for (int startRow = bandHeight; startRow < height; startRow += bandHeight) {
+    auto rowCount = std::min(bandHeight, height - startRow);
+    auto src = AddOffset(srcPixels, srcInfo.rowBytes() * startRow);
+    auto dst = AddOffset(dstPixels, dstInfo.rowBytes() * startRow);
+    threads.emplace_back(ConvertRows, srcInfo, src, dstInfo, dst, rowCount);
+  }
+  ConvertRows(srcInfo, srcPixels, dstInfo, dstPixels, std::min(bandHeight, height));
+  for (auto& thread : threads) {
+    thread.join();
+  }
+#endif
+}
+
 Bitmap::Bitmap(const ImageInfo& info, const void* pixels) : _info(info), _pixels(pixels) {
   if (_info.isEmpty()) {
     _pixels = nullptr;
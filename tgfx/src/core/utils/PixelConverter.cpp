@@ -0,0 +1,487 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelConverter.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TGFX_USE_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// All the kernels below assume little-endian 32-bit pixels, which is true on every supported
+// platform: the byte order RGBA in memory is 0xAABBGGRR in a register.
+
+namespace tgfx {
+static inline uint8_t Div255(uint32_t value) {
+  // The exact result of round(value / 255) for value in [0, 255 * 255].
+  value += 128;
+  return static_cast<uint8_t>((value + (value >> 8)) >> 8);
+}
+
+static const float* UnpremulScales() {
+  static const auto Scales = [] {
+    static float scales[256] = {};
+    for (int i = 1; i < 256; i++) {
+      scales[i] = 255.0f / static_cast<float>(i);
+    }
+    return scales;
+  }();
+  return Scales;
+}
+
+static inline uint8_t Unpremul(uint8_t value, float scale) {
+  return static_cast<uint8_t>(std::min(static_cast<float>(value) * scale + 0.5f, 255.0f));
+}
+
+static void SwizzleRBScalar(uint8_t* dst, const uint8_t* src, int count) {
+  for (int i = 0; i < count; i++) {
+    auto r = src[0];
+    dst[0] = src[2];
+    dst[1] = src[1];
+    dst[2] = r;
+    dst[3] = src[3];
+    dst += 4;
+    src += 4;
+  }
+}
+
+template <bool SwapRB>
+static void PremulScalar(uint8_t* dst, const uint8_t* src, int count) {
+  for (int i = 0; i < count; i++) {
+    auto a = src[3];
+    auto r = Div255(src[0] * a);
+    auto g = Div255(src[1] * a);
+    auto b = Div255(src[2] * a);
+    dst[0] = SwapRB ? b : r;
+    dst[1] = g;
+    dst[2] = SwapRB ? r : b;
+    dst[3] = a;
+    dst += 4;
+    src += 4;
+  }
+}
+
+template <bool SwapRB>
+static void UnpremulScalar(uint8_t* dst, const uint8_t* src, int count) {
+  auto scales = UnpremulScales();
+  for (int i = 0; i < count; i++) {
+    auto a = src[3];
+    auto scale = scales[a];
+    auto r = Unpremul(src[0], scale);
+    auto g = Unpremul(src[1], scale);
+    auto b = Unpremul(src[2], scale);
+    dst[0] = SwapRB ? b : r;
+    dst[1] = g;
+    dst[2] = SwapRB ? r : b;
+    dst[3] = a;
+    dst += 4;
+    src += 4;
+  }
+}
+
+static void ExpandA8Scalar(uint8_t* dst, const uint8_t* src, int count) {
+  for (int i = 0; i < count; i++) {
+    dst[0] = dst[1] = dst[2] = 0;
+    dst[3] = src[i];
+    dst += 4;
+  }
+}
+
+static void ExtractA8Scalar(uint8_t* dst, const uint8_t* src, int count) {
+  for (int i = 0; i < count; i++) {
+    dst[i] = src[3];
+    src += 4;
+  }
+}
+
+#if defined(__AVX2__)
+
+static inline __m256i SwapRBLanes(__m256i pixels) {
+  static const auto Mask = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                            2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+  return _mm256_shuffle_epi8(pixels, Mask);
+}
+
+static inline __m256i Div255(__m256i value) {
+  value = _mm256_add_epi16(value, _mm256_set1_epi16(128));
+  return _mm256_srli_epi16(_mm256_add_epi16(value, _mm256_srli_epi16(value, 8)), 8);
+}
+
+static inline __m256i PremulLanes(__m256i pixels) {
+  static const auto AlphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+  auto zero = _mm256_setzero_si256();
+  auto lo = _mm256_unpacklo_epi8(pixels, zero);
+  auto hi = _mm256_unpackhi_epi8(pixels, zero);
+  auto alphaLo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(lo, 0xFF), 0xFF);
+  auto alphaHi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(hi, 0xFF), 0xFF);
+  lo = Div255(_mm256_mullo_epi16(lo, alphaLo));
+  hi = Div255(_mm256_mullo_epi16(hi, alphaHi));
+  auto colors = _mm256_andnot_si256(AlphaMask, _mm256_packus_epi16(lo, hi));
+  return _mm256_or_si256(colors, _mm256_and_si256(pixels, AlphaMask));
+}
+
+static void SwizzleRB(void* dst, const void* src, int count) {
+  auto dstPixels = static_cast<uint8_t*>(dst);
+  auto srcPixels = static_cast<const uint8_t*>(src);
+  for (; count >= 8; count -= 8) {
+    auto pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(srcPixels));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dstPixels), SwapRBLanes(pixels));
+    dstPixels += 32;
+    srcPixels += 32;
+  }
+  SwizzleRBScalar(dstPixels, srcPixels, count);
+}
+
+template <bool SwapRB>
+static void Premul(void* dst, const void* src, int count) {
+  auto dstPixels = static_cast<uint8_t*>(dst);
+  auto srcPixels = static_cast<const uint8_t*>(src);
+  for (; count >= 8; count -= 8) {
+    auto pixels = PremulLanes(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(srcPixels)));
+    if (SwapRB) {
+      pixels = SwapRBLanes(pixels);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dstPixels), pixels);
+    dstPixels += 32;
+    srcPixels += 32;
+  }
+  PremulScalar<SwapRB>(dstPixels, srcPixels, count);
+}
+
+template <bool SwapRB>
+static void Unpremul(void* dst, const void* src, int count) {
+  static const auto AlphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+  auto dstPixels = static_cast<uint8_t*>(dst);
+  auto srcPixels = static_cast<const uint8_t*>(src);
+  for (; count >= 8; count -= 8) {
+    auto pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(srcPixels));
+    auto alpha = _mm256_and_si256(pixels, AlphaMask);
+    // Opaque and fully transparent pixels are common in images and need no division.
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha, AlphaMask)) == -1) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dstPixels),
+                          SwapRB ? SwapRBLanes(pixels) : pixels);
+    } else if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha, _mm256_setzero_si256())) == -1) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dstPixels), _mm256_setzero_si256());
+    } else {
+      UnpremulScalar<SwapRB>(dstPixels, srcPixels, 8);
+    }
+    dstPixels += 32;
+    srcPixels += 32;
+  }
+  UnpremulScalar<SwapRB>(dstPixels, srcPixels, count);
+}
+
+static void ExpandA8(void* dst, const void* src, int count) {
+  auto dstPixels = static_cast<uint8_t*>(dst);
+  auto srcPixels = static_cast<const uint8_t*>(src);
+  for (; count >= 8; count -= 8) {
+    auto alpha = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(srcPixels));
+    auto pixels = _mm256_slli_epi32(_mm256_cvtepu8_epi32(alpha), 24);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dstPixels), pixels);
+    dstPixels += 32;
+    srcPixels += 8;
+  }
+  ExpandA8Scalar(dstPixels, srcPixels, count);
+}
+
+static void ExtractA8(void* dst, const void* src, int count) {
+  static const auto Mask = _mm256_setr_epi8(3, 7, 11, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                            -1, -1, 3, 7, 11, 15, -1, -1, -1, -1, -1, -1, -1, -1,
+                                            -1, -1, -1, -1);
+  auto dstPixels = static_cast<uint8_t*>(dst);
+  auto srcPixels = static_cast<const uint8_t*>(src);
+  for (; count >= 8; count -= 8) {
+    auto pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(srcPixels));
+    auto alpha = _mm256_shuffle_epi8(pixels, Mask);
+    auto lo = static_cast<uint32_t>(_mm256_extract_epi32(alpha, 0));
+    auto hi = static_cast<uint32_t>(_mm256_extract_epi32(alpha, 4));
+    memcpy(dstPixels, &lo, 4);
+    memcpy(dstPixels + 4, &hi, 4);
+    dstPixels += 8;
+    srcPixels += 32;
+  }
+  ExtractA8Scalar(dstPixels, srcPixels, count);
+}
+
+#elif defined(TGFX_USE_SSE2)
+
+static inline __m128i SwapRBLanes(__m128i pixels) {
+  static const auto AGMask = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+  auto ag = _mm_and_si128(pixels, AGMask);
+  auto rb = _mm_andnot_si128(AGMask, pixels);
+  return _mm_or_si128(ag, _mm_or_si128(_mm_srli_epi32(rb, 16), _mm_slli_epi32(rb, 16)));
+}
+
+static inline __m128i Div255(__m128i value) {
+  value = _mm_add_epi16(value, _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+}
+
+static inline __m128i PremulLanes(__m128i pixels) {
+  static const auto AlphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+  auto zero = _mm_setzero_si128();
+  auto lo = _mm_unpacklo_epi8(pixels, zero);
+  auto hi = _mm_unpackhi_epi8(pixels, zero);
+  auto alphaLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xFF), 0xFF);
+  auto alphaHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xFF), 0xFF);
+  lo = Div255(_mm_mullo_epi16(lo, alphaLo));
+  hi = Div255(_mm_mullo_epi16(hi, alphaHi));
+  auto colors = _mm_andnot_si128(AlphaMask, _mm_packus_epi16(lo, hi));
+  return _mm_or_si128(colors, _mm_and_si128(pixels, AlphaMask));
+}
+
+static void SwizzleRB(void* dst, const void* src, int count) {
+  auto dstPixels = static_cast<uint8_t*>(dst);
+  auto srcPixels = static_cast<const uint8_t*>(src);
+  for (; count >= 4; count -= 4) {
+    auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcPixels));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dstPixels), SwapRBLanes(pixels));
+    dstPixels += 16;
+    srcPixels += 16;
+  }
+  SwizzleRBScalar(dstPixels, srcPixels, count);
+}
+
+template <bool SwapRB>
+static void Premul(void* dst, const void* src, int count) {
+  auto dstPixels = static_cast<uint8_t*>(dst);
+  auto srcPixels = static_cast<const uint8_t*>(src);
+  for (; count >= 4; count -= 4) {
+    auto pixels = PremulLanes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(srcPixels)));
+    if (SwapRB) {
+      pixels = SwapRBLanes(pixels);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dstPixels), pixels);
+    dstPixels += 16;
+    srcPixels += 16;
+  }
+  PremulScalar<SwapRB>(dstPixels, srcPixels, count);
+}
+
+template <bool SwapRB>
+static void Unpremul(void* dst, const void* src, int count) {
+  static const auto AlphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+  auto dstPixels = static_cast<uint8_t*>(dst);
+  auto srcPixels = static_cast<const uint8_t*>(src);
+  for (; count >= 4; count -= 4) {
+    auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcPixels));
+    auto alpha = _mm_and_si128(pixels, AlphaMask);
+    // Opaque and fully transparent pixels are common in images and need no division.
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, AlphaMask)) == 0xFFFF) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dstPixels),
+                       SwapRB ? SwapRBLanes(pixels) : pixels);
+    } else if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, _mm_setzero_si128())) == 0xFFFF) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dstPixels), _mm_setzero_si128());
+    } else {
+      UnpremulScalar<SwapRB>(dstPixels, srcPixels, 4);
+    }
+    dstPixels += 16;
+    srcPixels += 16;
+  }
+  UnpremulScalar<SwapRB>(dstPixels, srcPixels, count);
+}
+
+static void ExpandA8(void* dst, const void* src, int count) {
+  auto dstPixels = static_cast<uint8_t*>(dst);
+  auto srcPixels = static_cast<const uint8_t*>(src);
+  auto zero = _mm_setzero_si128();
+  for (; count >= 16; count -= 16) {
+    auto alpha = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcPixels));
+    auto lo = _mm_unpacklo_epi8(zero, alpha);
+    auto hi = _mm_unpackhi_epi8(zero, alpha);
+    auto output = reinterpret_cast<__m128i*>(dstPixels);
+    _mm_storeu_si128(output, _mm_unpacklo_epi16(zero, lo));
+    _mm_storeu_si128(output + 1, _mm_unpackhi_epi16(zero, lo));
+    _mm_storeu_si128(output + 2, _mm_unpacklo_epi16(zero, hi));
+    _mm_storeu_si128(output + 3, _mm_unpackhi_epi16(zero, hi));
+    dstPixels += 64;
+    srcPixels += 16;
+  }
+  ExpandA8Scalar(dstPixels, srcPixels, count);
+}
+
+static void ExtractA8(void* dst, const void* src, int count) {
+  auto dstPixels = static_cast<uint8_t*>(dst);
+  auto srcPixels = static_cast<const uint8_t*>(src);
+  for (; count >= 16; count -= 16) {
+    auto input = reinterpret_cast<const __m128i*>(srcPixels);
+    auto a0 = _mm_srli_epi32(_mm_loadu_si128(input), 24);
+    auto a1 = _mm_srli_epi32(_mm_loadu_si128(input + 1), 24);
+    auto a2 = _mm_srli_epi32(_mm_loadu_si128(input + 2), 24);
+    auto a3 = _mm_srli_epi32(_mm_loadu_si128(input + 3), 24);
+    auto alpha = _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dstPixels), alpha);
+    dstPixels += 16;
+    srcPixels += 64;
+  }
+  ExtractA8Scalar(dstPixels, srcPixels, count);
+}
+
+#elif defined(__ARM_NEON)
+
+static inline uint8x16_t MulDiv255(uint8x16_t color, uint8x16_t alpha) {
+  auto lo = vmull_u8(vget_low_u8(color), vget_low_u8(alpha));
+  auto hi = vmull_u8(vget_high_u8(color), vget_high_u8(alpha));
+  // (x + ((x + 128) >> 8) + 128) >> 8 is the exact result of round(x / 255).
+  return vcombine_u8(vraddhn_u16(lo, vrshrq_n_u16(lo, 8)), vraddhn_u16(hi, vrshrq_n_u16(hi, 8)));
+}
+
+static void SwizzleRB(void* dst, const void* src, int count) {
+  auto dstPixels = static_cast<uint8_t*>(dst);
+  auto srcPixels = static_cast<const uint8_t*>(src);
+  for (; count >= 16; count -= 16) {
+    auto pixels = vld4q_u8(srcPixels);
+    std::swap(pixels.val[0], pixels.val[2]);
+    vst4q_u8(dstPixels, pixels);
+    dstPixels += 64;
+    srcPixels += 64;
+  }
+  SwizzleRBScalar(dstPixels, srcPixels, count);
+}
+
+template <bool SwapRB>
+static void Premul(void* dst, const void* src, int count) {
+  auto dstPixels = static_cast<uint8_t*>(dst);
+  auto srcPixels = static_cast<const uint8_t*>(src);
+  for (; count >= 16; count -= 16) {
+    auto pixels = vld4q_u8(srcPixels);
+    auto alpha = pixels.val[3];
+    auto r = MulDiv255(pixels.val[0], alpha);
+    auto g = MulDiv255(pixels.val[1], alpha);
+    auto b = MulDiv255(pixels.val[2], alpha);
+    pixels.val[0] = SwapRB ? b : r;
+    pixels.val[1] = g;
+    pixels.val[2] = SwapRB ? r : b;
+    vst4q_u8(dstPixels, pixels);
+    dstPixels += 64;
+    srcPixels += 64;
+  }
+  PremulScalar<SwapRB>(dstPixels, srcPixels, count);
+}
+
+template <bool SwapRB>
+static void Unpremul(void* dst, const void* src, int count) {
+  auto dstPixels = static_cast<uint8_t*>(dst);
+  auto srcPixels = static_cast<const uint8_t*>(src);
+#if defined(__aarch64__)
+  for (; count >= 16; count -= 16) {
+    auto pixels = vld4q_u8(srcPixels);
+    // Opaque and fully transparent pixels are common in images and need no division.
+    if (vminvq_u8(pixels.val[3]) == 255) {
+      if (SwapRB) {
+        std::swap(pixels.val[0], pixels.val[2]);
+      }
+      vst4q_u8(dstPixels, pixels);
+    } else if (vmaxvq_u8(pixels.val[3]) == 0) {
+      memset(dstPixels, 0, 64);
+    } else {
+      UnpremulScalar<SwapRB>(dstPixels, srcPixels, 16);
+    }
+    dstPixels += 64;
+    srcPixels += 64;
+  }
+#endif
+  UnpremulScalar<SwapRB>(dstPixels, srcPixels, count);
+}
+
+static void ExpandA8(void* dst, const void* src, int count) {
+  auto dstPixels = static_cast<uint8_t*>(dst);
+  auto srcPixels = static_cast<const uint8_t*>(src);
+  uint8x16x4_t pixels = {};
+  pixels.val[0] = pixels.val[1] = pixels.val[2] = vdupq_n_u8(0);
+  for (; count >= 16; count -= 16) {
+    pixels.val[3] = vld1q_u8(srcPixels);
+    vst4q_u8(dstPixels, pixels);
+    dstPixels += 64;
+    srcPixels += 16;
+  }
+  ExpandA8Scalar(dstPixels, srcPixels, count);
+}
+
+static void ExtractA8(void* dst, const void* src, int count) {
+  auto dstPixels = static_cast<uint8_t*>(dst);
+  auto srcPixels = static_cast<const uint8_t*>(src);
+  for (; count >= 16; count -= 16) {
+    vst1q_u8(dstPixels, vld4q_u8(srcPixels).val[3]);
+    dstPixels += 16;
+    srcPixels += 64;
+  }
+  ExtractA8Scalar(dstPixels, srcPixels, count);
+}
+
+#else
+
+static void SwizzleRB(void* dst, const void* src, int count) {
+  SwizzleRBScalar(static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src), count);
+}
+
+template <bool SwapRB>
+static void Premul(void* dst, const void* src, int count) {
+  PremulScalar<SwapRB>(static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src), count);
+}
+
+template <bool SwapRB>
+static void Unpremul(void* dst, const void* src, int count) {
+  UnpremulScalar<SwapRB>(static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src), count);
+}
+
+static void ExpandA8(void* dst, const void* src, int count) {
+  ExpandA8Scalar(static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src), count);
+}
+
+static void ExtractA8(void* dst, const void* src, int count) {
+  ExtractA8Scalar(static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src), count);
+}
+
+#endif
+
+PixelConvertProc PixelConverter::GetProc(ColorType srcColorType, AlphaType srcAlphaType,
+                                         ColorType dstColorType, AlphaType dstAlphaType) {
+  if (srcColorType == ColorType::Unknown || dstColorType == ColorType::Unknown ||
+      srcAlphaType == AlphaType::Unknown || dstAlphaType == AlphaType::Unknown) {
+    return nullptr;
+  }
+  auto swapRB = srcColorType != dstColorType;
+  if (srcAlphaType == AlphaType::Opaque || dstAlphaType == AlphaType::Opaque) {
+    // Opaque destinations force alpha to 255, and opaque sources ignore their stored alpha, so
+    // only the plain swizzle between two opaque 32-bit formats is handled here.
+    auto is32Bit = srcColorType != ColorType::ALPHA_8 && dstColorType != ColorType::ALPHA_8;
+    return srcAlphaType == dstAlphaType && is32Bit && swapRB ? SwizzleRB : nullptr;
+  }
+  if (srcColorType == ColorType::ALPHA_8) {
+    // The color channels are always zero, premultiplied or not.
+    return dstColorType == ColorType::ALPHA_8 ? nullptr : ExpandA8;
+  }
+  if (dstColorType == ColorType::ALPHA_8) {
+    return ExtractA8;
+  }
+  if (srcAlphaType == dstAlphaType) {
+    return swapRB ? SwizzleRB : nullptr;
+  }
+  if (srcAlphaType == AlphaType::Unpremultiplied) {
+    return swapRB ? Premul<true> : Premul<false>;
+  }
+  return swapRB ? Unpremul<true> : Unpremul<false>;
+}
+}  // namespace tgfx
@@ -0,0 +1,45 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "core/ImageInfo.h"
+
+namespace tgfx {
+/**
+ * Converts the specified number of pixels from src to dst.
+ */
+using PixelConvertProc = void (*)(void* dst, const void* src, int count);
+
+/**
+ * PixelConverter provides SIMD accelerated kernels for the most frequent pixel conversions, which
+ * are swizzling between RGBA and BGRA, premultiplying, unpremultiplying, expanding ALPHA_8 into
+ * 32-bit pixels and extracting alpha from them. The kernels use AVX2, SSE2 or NEON if they are
+ * available at compile time, and fall back to portable scalar code otherwise. Premultiplying rounds
+ * exactly as skcms does, unpremultiplying may differ from skcms by one in rare cases.
+ */
+class PixelConverter {
+ public:
+  /**
+   * Returns the kernel converting pixels between the specified formats, or nullptr if there is no
+   * dedicated kernel for them.
+   */
+  static PixelConvertProc GetProc(ColorType srcColorType, AlphaType srcAlphaType,
+                                  ColorType dstColorType, AlphaType dstAlphaType);
+};
+}  // namespace tgfx
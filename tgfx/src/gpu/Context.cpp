@@ -20,12 +20,14 @@
 #include "core/Performance.h"
 #include "core/utils/Log.h"
 #include "gpu/GradientCache.h"
+#include "gpu/PathMaskCache.h"
 #include "gpu/ProgramCache.h"
 #include "gpu/ResourceCache.h"
 
 namespace tgfx {
 Context::Context(Device* device) : _device(device) {
   _gradientCache = new GradientCache(this);
+  _pathMaskCache = new PathMaskCache(this);
   _programCache = new ProgramCache(this);
   _resourceCache = new ResourceCache(this);
 }
@@ -36,7 +38,9 @@ Context::~Context() {
   DEBUG_ASSERT(_resourceCache->empty());
   DEBUG_ASSERT(_programCache->empty());
   DEBUG_ASSERT(_gradientCache->empty())
+  DEBUG_ASSERT(_pathMaskCache->empty())
   delete _gradientCache;
+  delete _pathMaskCache;
   delete _programCache;
   delete _resourceCache;
 }
@@ -55,6 +59,7 @@ void Context::purgeResourcesNotUsedIn(int64_t usNotUsed) {
 
 void Context::releaseAll(bool releaseGPU) {
   _gradientCache->releaseAll();
+  _pathMaskCache->releaseAll();
   _programCache->releaseAll(releaseGPU);
   _resourceCache->releaseAll(releaseGPU);
 }
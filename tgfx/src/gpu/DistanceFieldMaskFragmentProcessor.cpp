@@ -0,0 +1,53 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DistanceFieldMaskFragmentProcessor.h"
+#include "core/utils/UniqueID.h"
+#include "opengl/GLDistanceFieldMaskFragmentProcessor.h"
+
+namespace tgfx {
+std::unique_ptr<DistanceFieldMaskFragmentProcessor> DistanceFieldMaskFragmentProcessor::Make(
+    const Texture* texture, float distanceScale) {
+  if (texture == nullptr || distanceScale <= 0) {
+    return nullptr;
+  }
+  return std::unique_ptr<DistanceFieldMaskFragmentProcessor>(
+      new DistanceFieldMaskFragmentProcessor(texture, distanceScale));
+}
+
+DistanceFieldMaskFragmentProcessor::DistanceFieldMaskFragmentProcessor(const Texture* texture,
+                                                                       float distanceScale)
+    : texture(texture), coordTransform(Matrix::I()), distanceScale(distanceScale) {
+  setTextureSamplerCnt(1);
+  if (texture->origin() == ImageOrigin::BottomLeft) {
+    coordTransform.matrix.postScale(1, -1);
+    coordTransform.matrix.postTranslate(0, 1);
+  }
+  addCoordTransform(&coordTransform);
+}
+
+void DistanceFieldMaskFragmentProcessor::onComputeProcessorKey(BytesKey* bytesKey) const {
+  static auto Type = UniqueID::Next();
+  bytesKey->write(Type);
+}
+
+std::unique_ptr<GLFragmentProcessor> DistanceFieldMaskFragmentProcessor::onCreateGLInstance()
+    const {
+  return std::make_unique<GLDistanceFieldMaskFragmentProcessor>();
+}
+}  // namespace tgfx
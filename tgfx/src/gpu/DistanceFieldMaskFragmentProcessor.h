@@ -0,0 +1,56 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FragmentProcessor.h"
+
+namespace tgfx {
+/**
+ * DistanceFieldMaskFragmentProcessor samples a single channel signed distance field texture with
+ * local coordinates and turns the distances into coverage. The texture stores 0.5 on the edges,
+ * and the distanceScale is the number of device pixels covered by the full [0, 1] range of the
+ * stored values, which keeps the anti-aliased edges one pixel wide at any scale.
+ */
+class DistanceFieldMaskFragmentProcessor : public FragmentProcessor {
+ public:
+  static std::unique_ptr<DistanceFieldMaskFragmentProcessor> Make(const Texture* texture,
+                                                                  float distanceScale);
+
+  std::string name() const override {
+    return "DistanceFieldMaskFragmentProcessor";
+  }
+
+ private:
+  DistanceFieldMaskFragmentProcessor(const Texture* texture, float distanceScale);
+
+  void onComputeProcessorKey(BytesKey* bytesKey) const override;
+
+  std::unique_ptr<GLFragmentProcessor> onCreateGLInstance() const override;
+
+  const TextureSampler* onTextureSampler(size_t) const override {
+    return texture->getSampler();
+  }
+
+  const Texture* texture;
+  CoordTransform coordTransform;
+  float distanceScale = 1.0f;
+
+  friend class GLDistanceFieldMaskFragmentProcessor;
+};
+}  // namespace tgfx
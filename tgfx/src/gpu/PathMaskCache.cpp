@@ -0,0 +1,144 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PathMaskCache.h"
+#include "core/Mask.h"
+
+namespace tgfx {
+static void WritePoints(BytesKey* bytesKey, const Point points[], int count) {
+  for (int i = 0; i < count; i++) {
+    bytesKey->write(points[i].x);
+    bytesKey->write(points[i].y);
+  }
+}
+
+/**
+ * Writes the whole content of the path into the key instead of a hash of it, so that two different
+ * paths never share a mask.
+ */
+static void WritePath(BytesKey* bytesKey, const Path& path) {
+  bytesKey->write(static_cast<uint32_t>(path.getFillType()));
+  path.decompose([&](PathVerb verb, const Point points[4], void*) {
+    bytesKey->write(static_cast<uint32_t>(verb));
+    switch (verb) {
+      case PathVerb::Move:
+        WritePoints(bytesKey, points, 1);
+        break;
+      case PathVerb::Line:
+        WritePoints(bytesKey, points + 1, 1);
+        break;
+      case PathVerb::Quad:
+        WritePoints(bytesKey, points + 1, 2);
+        break;
+      case PathVerb::Cubic:
+        WritePoints(bytesKey, points + 1, 3);
+        break;
+      default:
+        break;
+    }
+  });
+}
+
+std::shared_ptr<Texture> PathMaskCache::getMask(const Path& path, const Matrix& matrix,
+                                                Rect* maskBounds) {
+  if (_maxBytes == 0 || path.isInverseFillType()) {
+    return nullptr;
+  }
+  // The mask is rasterized relative to its own device bounds, the same as an uncached one, so its
+  // content doesn't depend on the translation, which is applied by drawing it at the translated
+  // bounds.
+  auto maskMatrix = matrix;
+  maskMatrix.setTranslateX(0);
+  maskMatrix.setTranslateY(0);
+  auto quad = maskMatrix.mapRect(path.getBounds());
+  auto width = ceilf(quad.width());
+  auto height = ceilf(quad.height());
+  auto bytes = static_cast<size_t>(width) * static_cast<size_t>(height);
+  // A single mask is not allowed to take more than a quarter of the cache.
+  if (quad.isEmpty() || bytes > _maxBytes / 4) {
+    return nullptr;
+  }
+  BytesKey bytesKey = {};
+  bytesKey.write(maskMatrix.getScaleX());
+  bytesKey.write(maskMatrix.getSkewX());
+  bytesKey.write(maskMatrix.getSkewY());
+  bytesKey.write(maskMatrix.getScaleY());
+  WritePath(&bytesKey, path);
+  auto iter = masks.find(bytesKey);
+  if (iter != masks.end()) {
+    _hitCount++;
+    auto& entry = iter->second;
+    keys.splice(keys.begin(), keys, entry.position);
+    *maskBounds = entry.bounds.makeOffset(matrix.getTranslateX(), matrix.getTranslateY());
+    return entry.texture;
+  }
+  _missCount++;
+  auto mask = Mask::Make(static_cast<int>(width), static_cast<int>(height));
+  if (mask == nullptr) {
+    return nullptr;
+  }
+  maskMatrix.postTranslate(-quad.x(), -quad.y());
+  maskMatrix.postScale(width / quad.width(), height / quad.height());
+  mask->setMatrix(maskMatrix);
+  mask->fillPath(path);
+  auto texture = mask->makeTexture(context);
+  if (texture == nullptr) {
+    return nullptr;
+  }
+  // The key is stored twice, once in the map and once in the LRU list.
+  bytes += bytesKey.size() * sizeof(uint32_t) * 2;
+  add(bytesKey, {texture, quad, bytes});
+  *maskBounds = quad.makeOffset(matrix.getTranslateX(), matrix.getTranslateY());
+  return texture;
+}
+
+void PathMaskCache::add(const BytesKey& bytesKey, MaskEntry entry) {
+  if (entry.bytes > _maxBytes) {
+    return;
+  }
+  purgeToFit(_maxBytes - entry.bytes);
+  totalBytes += entry.bytes;
+  keys.push_front(bytesKey);
+  entry.position = keys.begin();
+  masks[bytesKey] = std::move(entry);
+}
+
+void PathMaskCache::purgeToFit(size_t bytes) {
+  while (totalBytes > bytes && !keys.empty()) {
+    auto iter = masks.find(keys.back());
+    totalBytes -= iter->second.bytes;
+    masks.erase(iter);
+    keys.pop_back();
+  }
+}
+
+void PathMaskCache::setMaxBytes(size_t bytes) {
+  _maxBytes = bytes;
+  purgeToFit(_maxBytes);
+}
+
+void PathMaskCache::releaseAll() {
+  masks.clear();
+  keys.clear();
+  totalBytes = 0;
+}
+
+bool PathMaskCache::empty() const {
+  return masks.empty() && keys.empty();
+}
+}  // namespace tgfx
@@ -0,0 +1,106 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include "core/BytesKey.h"
+#include "core/Path.h"
+#include "gpu/Texture.h"
+
+namespace tgfx {
+class Context;
+
+/**
+ * PathMaskCache keeps the mask textures of recently rasterized paths, so that a path drawn again
+ * with the same scale and skew, e.g. a static shape under an animated translation, or the copies
+ * of a repeater, doesn't need to be rasterized and uploaded again. Like an uncached mask, the mask
+ * is rasterized relative to its own device bounds and drawn at the translated bounds, so the cached
+ * mask renders the same as an uncached one at any translation. The cached masks are evicted in
+ * least recently used order once their total size exceeds the limit.
+ */
+class PathMaskCache {
+ public:
+  /**
+   * The default value of maxBytes().
+   */
+  static constexpr size_t DefaultMaxBytes = 16 * 1024 * 1024;
+
+  explicit PathMaskCache(Context* context) : context(context) {
+  }
+
+  /**
+   * Returns the mask texture of the path transformed by the matrix, and sets the device bounds of
+   * the mask to maskBounds. Returns nullptr if the mask is too large to be cached, in which case
+   * the caller should rasterize the path on its own. The path must not be clipped by the render
+   * target, the mask always covers the whole path.
+   */
+  std::shared_ptr<Texture> getMask(const Path& path, const Matrix& matrix, Rect* maskBounds);
+
+  /**
+   * Returns the maximum number of bytes the cached masks can take, including their keys.
+   */
+  size_t maxBytes() const {
+    return _maxBytes;
+  }
+
+  /**
+   * Sets the maximum number of bytes the cached masks can take, 0 disables the cache.
+   */
+  void setMaxBytes(size_t bytes);
+
+  /**
+   * Returns the total number of getMask() calls served from the cache.
+   */
+  size_t hitCount() const {
+    return _hitCount;
+  }
+
+  /**
+   * Returns the total number of getMask() calls that rasterized a new mask.
+   */
+  size_t missCount() const {
+    return _missCount;
+  }
+
+  void releaseAll();
+
+  bool empty() const;
+
+ private:
+  struct MaskEntry {
+    std::shared_ptr<Texture> texture = nullptr;
+    Rect bounds = Rect::MakeEmpty();
+    size_t bytes = 0;
+    std::list<BytesKey>::iterator position = {};
+  };
+
+  Context* context = nullptr;
+  size_t _maxBytes = DefaultMaxBytes;
+  size_t totalBytes = 0;
+  size_t _hitCount = 0;
+  size_t _missCount = 0;
+  std::list<BytesKey> keys = {};
+  std::unordered_map<BytesKey, MaskEntry, BytesHasher> masks = {};
+
+  void add(const BytesKey& bytesKey, MaskEntry entry);
+
+  void purgeToFit(size_t bytes);
+};
+}  // namespace tgfx
@@ -28,6 +28,14 @@ bool Surface::readPixels(const ImageInfo& dstInfo, void* dstPixels, int srcX, in
   return onReadPixels(dstInfo, dstPixels, srcX, srcY);
 }
 
+bool Surface::readPixels(ReadbackBuffer* readbackBuffer) const {
+  if (readbackBuffer == nullptr || readbackBuffer->width() != width() ||
+      readbackBuffer->height() != height()) {
+    return false;
+  }
+  return onReadPixels(readbackBuffer);
+}
+
 bool Surface::hitTest(float x, float y) const {
   uint8_t pixel[4];
   auto info = ImageInfo::Make(1, 1, ColorType::RGBA_8888, AlphaType::Premultiplied);
@@ -20,12 +20,15 @@
 #include "GLFillRectOp.h"
 #include "GLRRectOp.h"
 #include "GLSurface.h"
+#include "GLTriangulatingPathOp.h"
 #include "core/Mask.h"
 #include "core/PathEffect.h"
 #include "core/TextBlob.h"
 #include "core/utils/MathExtra.h"
 #include "gpu/AlphaFragmentProcessor.h"
 #include "gpu/ColorShader.h"
+#include "gpu/DistanceFieldMaskFragmentProcessor.h"
+#include "gpu/PathMaskCache.h"
 #include "gpu/TextureFragmentProcessor.h"
 #include "gpu/TextureMaskFragmentProcessor.h"
 
@@ -172,7 +175,8 @@ void GLCanvas::fillPath(const Path& path, const Shader* shader) {
     return;
   }
   auto bounds = path.getBounds();
-  auto clippedLocalQuad = clipLocalQuad(bounds, nullptr);
+  auto clippedDeviceQuad = Rect::MakeEmpty();
+  auto clippedLocalQuad = clipLocalQuad(bounds, &clippedDeviceQuad);
   if (clippedLocalQuad.isEmpty()) {
     return;
   }
@@ -184,6 +188,22 @@ void GLCanvas::fillPath(const Path& path, const Shader* shader) {
     draw(bounds, bounds, std::move(op), shader->asFragmentProcessor(args));
     return;
   }
+  if (drawTriangulatedPath(path, shader)) {
+    getContext()->_triangulatedPathCount++;
+    return;
+  }
+  getContext()->_rasterizedPathCount++;
+  // The paths clipped by the render target only rasterize their visible parts, which are not
+  // cached.
+  if (clippedDeviceQuad == globalPaint.matrix.mapRect(bounds)) {
+    auto maskBounds = Rect::MakeEmpty();
+    auto cachedMask =
+        getContext()->pathMaskCache()->getMask(path, globalPaint.matrix, &maskBounds);
+    if (cachedMask) {
+      drawMask(maskBounds, cachedMask.get(), shader);
+      return;
+    }
+  }
   auto quad = globalPaint.matrix.mapRect(clippedLocalQuad);
   auto width = ceilf(quad.width());
   auto height = ceilf(quad.height());
@@ -201,6 +221,29 @@ void GLCanvas::fillPath(const Path& path, const Shader* shader) {
   drawMask(quad, maskTexture.get(), shader);
 }
 
+bool GLCanvas::drawTriangulatedPath(const Path& path, const Shader* shader) {
+  auto aaType = surface->getRenderTarget()->sampleCount() > 1 ? AAType::MSAA : AAType::Coverage;
+  if (aaType == AAType::Coverage && !getContext()->pathTriangulationEnabled()) {
+    return false;
+  }
+  auto invert = Matrix::I();
+  if (!globalPaint.matrix.invert(&invert)) {
+    return false;
+  }
+  auto op = GLTriangulatingPathOp::Make(path, globalPaint.matrix);
+  if (op == nullptr) {
+    return false;
+  }
+  auto deviceBounds = op->bounds();
+  auto args = FPArgs(getContext(), invert);
+  save();
+  resetMatrix();
+  draw(deviceBounds, deviceBounds, std::move(op), shader->asFragmentProcessor(args), nullptr,
+       aaType);
+  restore();
+  return true;
+}
+
 void GLCanvas::drawMask(Rect quad, const Texture* mask, const Shader* shader) {
   if (mask == nullptr || shader == nullptr) {
     return;
@@ -304,40 +347,101 @@ void GLCanvas::drawMaskGlyphs(TextBlob* textBlob, const Paint& paint) {
 
 void GLCanvas::drawAtlas(const Texture* atlas, const Matrix matrix[], const Rect tex[],
                          const Color colors[], size_t count) {
+  drawAtlas(atlas, matrix, tex, colors, count, 0);
+}
+
+void GLCanvas::drawDistanceFieldAtlas(const Texture* atlas, const Matrix matrix[],
+                                      const Rect tex[], const Color colors[], size_t count,
+                                      float distanceRange) {
+  if (distanceRange <= 0) {
+    return;
+  }
+  drawAtlas(atlas, matrix, tex, colors, count, distanceRange);
+}
+
+// The relative difference of the device scales allowed within one distance field batch, which
+// keeps the edges of the merged sprites within a few percent of one pixel wide.
+static constexpr float DISTANCE_SCALE_TOLERANCE = 0.05f;
+
+void GLCanvas::drawAtlas(const Texture* atlas, const Matrix matrix[], const Rect tex[],
+                         const Color colors[], size_t count, float distanceRange) {
   if (atlas == nullptr || count == 0) {
     return;
   }
-  // TODO(pengweilv): Merge draw call.
+  // Consecutive entries sharing the same color are merged into one op. Their quads are mapped by
+  // their own matrices on the CPU and carry atlas coordinates as local coordinates, which leaves
+  // all the uniforms of the merged draw identical.
   auto totalMatrix = getMatrix();
+  auto distanceField = distanceRange > 0;
+  float batchScale = 0;
+  std::vector<Rect> rects = {};
+  std::vector<Matrix> matrices = {};
+  std::vector<Rect> localCoords = {};
+  auto localBounds = Rect::MakeEmpty();
+  auto deviceBounds = Rect::MakeEmpty();
+  auto aaType = AAType::None;
+  const Color* batchColor = nullptr;
+  auto flushBatch = [&]() {
+    if (rects.empty()) {
+      return;
+    }
+    std::unique_ptr<FragmentProcessor> colorFP;
+    std::unique_ptr<FragmentProcessor> maskFP;
+    if (distanceField) {
+      if (batchColor) {
+        auto args = FPArgs(getContext(), Matrix::I());
+        colorFP = Shader::MakeColorShader(*batchColor)->asFragmentProcessor(args);
+      }
+      maskFP = DistanceFieldMaskFragmentProcessor::Make(atlas, distanceRange * batchScale);
+    } else if (batchColor) {
+      auto args = FPArgs(getContext(), Matrix::I());
+      colorFP = Shader::MakeColorShader(*batchColor)->asFragmentProcessor(args);
+      maskFP = TextureMaskFragmentProcessor::MakeUseLocalCoord(atlas, Matrix::I(), false);
+    } else {
+      colorFP = TextureFragmentProcessor::Make(atlas, nullptr, Matrix::I());
+    }
+    draw(localBounds, deviceBounds,
+         GLFillRectOp::Make(std::move(rects), std::move(matrices), std::move(localCoords)),
+         std::move(colorFP), std::move(maskFP), aaType);
+    rects = {};
+    matrices = {};
+    localCoords = {};
+    localBounds.setEmpty();
+    deviceBounds.setEmpty();
+  };
   for (size_t i = 0; i < count; ++i) {
     concat(matrix[i]);
     auto width = static_cast<float>(tex[i].width());
     auto height = static_cast<float>(tex[i].height());
     auto clippedDeviceQuad = Rect::MakeEmpty();
     auto clippedLocalQuad = clipLocalQuad(Rect::MakeWH(width, height), &clippedDeviceQuad);
+    auto entryAAType = getAAType(clippedDeviceQuad, false);
+    auto entryScale = distanceField ? getMatrix().getMaxScale() : 0.0f;
+    setMatrix(totalMatrix);
     if (clippedLocalQuad.isEmpty()) {
       continue;
     }
-    auto localMatrix = Matrix::I();
-    auto scale = atlas->getTextureCoord(clippedLocalQuad.width(), clippedLocalQuad.height());
-    localMatrix.postScale(scale.x, scale.y);
-    auto translate = atlas->getTextureCoord(tex[i].x() + clippedLocalQuad.x(),
-                                            tex[i].y() + clippedLocalQuad.y());
-    localMatrix.postTranslate(translate.x, translate.y);
-    auto args = FPArgs(getContext(),
-                       Matrix::MakeScale(clippedLocalQuad.width(), clippedLocalQuad.height()));
-    std::unique_ptr<FragmentProcessor> colorFP;
-    std::unique_ptr<FragmentProcessor> maskFP;
-    if (colors) {
-      colorFP = Shader::MakeColorShader(colors[i])->asFragmentProcessor(args);
-      maskFP = TextureMaskFragmentProcessor::MakeUseLocalCoord(atlas, localMatrix, false);
-    } else {
-      colorFP = TextureFragmentProcessor::Make(atlas, nullptr, localMatrix);
+    if (rects.size() == GLFillRectOp::MaxNumRects || entryAAType != aaType ||
+        (colors && batchColor && colors[i] != *batchColor) ||
+        fabsf(entryScale - batchScale) > batchScale * DISTANCE_SCALE_TOLERANCE) {
+      flushBatch();
     }
-    draw(clippedLocalQuad, clippedDeviceQuad, GLFillRectOp::Make(), std::move(colorFP),
-         std::move(maskFP), false);
-    setMatrix(totalMatrix);
-  }
+    if (rects.empty()) {
+      batchScale = entryScale;
+    }
+    batchColor = colors ? &colors[i] : nullptr;
+    aaType = entryAAType;
+    auto leftTop = atlas->getTextureCoord(tex[i].x() + clippedLocalQuad.left,
+                                          tex[i].y() + clippedLocalQuad.top);
+    auto rightBottom = atlas->getTextureCoord(tex[i].x() + clippedLocalQuad.right,
+                                              tex[i].y() + clippedLocalQuad.bottom);
+    rects.push_back(clippedLocalQuad);
+    matrices.push_back(matrix[i]);
+    localCoords.push_back(Rect::MakeLTRB(leftTop.x, leftTop.y, rightBottom.x, rightBottom.y));
+    localBounds.join(matrix[i].mapRect(clippedLocalQuad));
+    deviceBounds.join(clippedDeviceQuad);
+  }
+  flushBatch();
 }
 
 GLDrawer* GLCanvas::getDrawer() {
@@ -357,26 +461,36 @@ Matrix GLCanvas::getViewMatrix() {
   return matrix;
 }
 
+AAType GLCanvas::getAAType(const Rect& deviceQuad, bool aa) {
+  if (surface->getRenderTarget()->sampleCount() > 1) {
+    return AAType::MSAA;
+  }
+  if (aa && !IsPixelAligned(deviceQuad)) {
+    return AAType::Coverage;
+  }
+  auto& matrix = globalPaint.matrix;
+  auto rotation = std::round(RadiansToDegrees(atan2f(matrix.getSkewX(), matrix.getScaleX())));
+  if (static_cast<int>(rotation) % 90 != 0) {
+    return AAType::Coverage;
+  }
+  return AAType::None;
+}
+
 void GLCanvas::draw(const Rect& localQuad, const Rect& deviceQuad, std::unique_ptr<GLDrawOp> op,
                     std::unique_ptr<FragmentProcessor> color,
                     std::unique_ptr<FragmentProcessor> mask, bool aa) {
+  auto aaType = getAAType(deviceQuad, aa);
+  draw(localQuad, deviceQuad, std::move(op), std::move(color), std::move(mask), aaType);
+}
+
+void GLCanvas::draw(const Rect& localQuad, const Rect& deviceQuad, std::unique_ptr<GLDrawOp> op,
+                    std::unique_ptr<FragmentProcessor> color,
+                    std::unique_ptr<FragmentProcessor> mask, AAType aaType) {
   auto* drawer = getDrawer();
   if (drawer == nullptr) {
     return;
   }
   auto renderTarget = surface->getRenderTarget();
-  auto aaType = AAType::None;
-  if (renderTarget->sampleCount() > 1) {
-    aaType = AAType::MSAA;
-  } else if (aa && !IsPixelAligned(deviceQuad)) {
-    aaType = AAType::Coverage;
-  } else {
-    auto& matrix = globalPaint.matrix;
-    auto rotation = std::round(RadiansToDegrees(atan2f(matrix.getSkewX(), matrix.getScaleX())));
-    if (static_cast<int>(rotation) % 90 != 0) {
-      aaType = AAType::Coverage;
-    }
-  }
   DrawArgs args;
   if (color) {
     args.colors.push_back(std::move(color));
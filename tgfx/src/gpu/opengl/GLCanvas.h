@@ -36,6 +36,8 @@ class GLCanvas : public Canvas {
                   const Font& font, const Paint& paint) override;
   void drawAtlas(const Texture* atlas, const Matrix matrix[], const Rect tex[],
                  const Color colors[], size_t count) override;
+  void drawDistanceFieldAtlas(const Texture* atlas, const Matrix matrix[], const Rect tex[],
+                              const Color colors[], size_t count, float distanceRange) override;
 
  protected:
   void onSave() override {
@@ -71,10 +73,21 @@ class GLCanvas : public Canvas {
 
   void drawMaskGlyphs(TextBlob* textBlob, const Paint& paint);
 
+  void drawAtlas(const Texture* atlas, const Matrix matrix[], const Rect tex[],
+                 const Color colors[], size_t count, float distanceRange);
+
   void fillPath(const Path& path, const Shader* shader);
 
+  bool drawTriangulatedPath(const Path& path, const Shader* shader);
+
+  AAType getAAType(const Rect& deviceQuad, bool aa);
+
   void draw(const Rect& localQuad, const Rect& deviceQuad, std::unique_ptr<GLDrawOp> op,
             std::unique_ptr<FragmentProcessor> color,
             std::unique_ptr<FragmentProcessor> mask = nullptr, bool aa = false);
+
+  void draw(const Rect& localQuad, const Rect& deviceQuad, std::unique_ptr<GLDrawOp> op,
+            std::unique_ptr<FragmentProcessor> color, std::unique_ptr<FragmentProcessor> mask,
+            AAType aaType);
 };
 }  // namespace tgfx
@@ -227,6 +227,9 @@ void GLCaps::initGLSupport(const GLInfo& info) {
                           info.hasExtension("GL_NV_texture_barrier");
   textureSwizzleSupport = version >= GL_VER(3, 3) || info.hasExtension("GL_ARB_texture_swizzle");
   semaphoreSupport = version >= GL_VER(3, 2) || info.hasExtension("GL_ARB_sync");
+  pixelPackBufferSupport =
+      semaphoreSupport && (version >= GL_VER(3, 0) || info.hasExtension("GL_ARB_map_buffer_range"));
+  pixelUnpackBufferSupport = pixelPackBufferSupport;
 }
 
 void GLCaps::initGLESSupport(const GLInfo& info) {
@@ -258,6 +261,8 @@ void GLCaps::initGLESSupport(const GLInfo& info) {
     frameBufferFetchRequiresEnablePerSample = true;
   }
   semaphoreSupport = version >= GL_VER(3, 0) || info.hasExtension("GL_APPLE_sync");
+  pixelPackBufferSupport = version >= GL_VER(3, 0);
+  pixelUnpackBufferSupport = pixelPackBufferSupport;
 }
 
 void GLCaps::initWebGLSupport(const GLInfo& info) {
@@ -270,6 +275,10 @@ void GLCaps::initWebGLSupport(const GLInfo& info) {
   multisampleDisableSupport = false;  // no WebGL support
   textureBarrierSupport = false;
   semaphoreSupport = version >= GL_VER(2, 0);
+  // WebGL has no glMapBufferRange(), pixels in a buffer can only be fetched synchronously.
+  pixelPackBufferSupport = false;
+  // Staging pixels in a buffer needs glMapBufferRange() too.
+  pixelUnpackBufferSupport = false;
 }
 
 void GLCaps::initFormatMap(const GLInfo& info) {
@@ -127,6 +127,8 @@ class GLCaps : public Caps {
   int maxFragmentSamplers = kMaxSaneSamplers;
   bool textureSwizzleSupport = false;
   bool semaphoreSupport = false;
+  bool pixelPackBufferSupport = false;
+  bool pixelUnpackBufferSupport = false;
 
   explicit GLCaps(const GLInfo& info);
 
@@ -18,10 +18,14 @@
 
 #include "gpu/opengl/GLContext.h"
 #include "gpu/opengl/GLDevice.h"
+#include "gpu/opengl/GLTextureUploader.h"
 
 namespace tgfx {
 GLContext::GLContext(Device* device, const GLInterface* glInterface) : Context(device) {
   glState = std::make_unique<GLState>(glInterface);
   interface = GLInterface::HookWithState(glInterface, glState.get());
+  textureUploader = std::make_unique<GLTextureUploader>(this);
 }
+
+GLContext::~GLContext() = default;
 }  // namespace tgfx
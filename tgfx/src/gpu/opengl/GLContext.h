@@ -24,6 +24,7 @@
 
 namespace tgfx {
 class GLCaps;
+class GLTextureUploader;
 
 class GLContext : public Context {
  public:
@@ -33,6 +34,8 @@ class GLContext : public Context {
 
   GLContext(Device* device, const GLInterface* glInterface);
 
+  ~GLContext() override;
+
   Backend backend() const override {
     return Backend::OPENGL;
   }
@@ -44,8 +47,10 @@ class GLContext : public Context {
  private:
   std::unique_ptr<const GLInterface> interface = nullptr;
   std::unique_ptr<GLState> glState = nullptr;
+  std::unique_ptr<GLTextureUploader> textureUploader;
 
   friend class GLStateGuard;
   friend class GLDevice;
+  friend class GLTextureUploader;
 };
 }  // namespace tgfx
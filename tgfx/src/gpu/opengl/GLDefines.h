@@ -109,6 +109,8 @@ namespace tgfx {
 #define GL_VERTEX_ARRAY_BINDING 0x85B5
 #define GL_PIXEL_PACK_BUFFER 0x88EB
 #define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#define GL_PIXEL_PACK_BUFFER_BINDING 0x88ED
+#define GL_PIXEL_UNPACK_BUFFER_BINDING 0x88EF
 
 #define GL_PIXEL_UNPACK_TRANSFER_BUFFER_CHROMIUM 0x78EC
 #define GL_PIXEL_PACK_TRANSFER_BUFFER_CHROMIUM 0x78ED
@@ -901,6 +903,11 @@ namespace tgfx {
 
 #define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
 #define GL_TIMEOUT_IGNORED 0xFFFFFFFFFFFFFFFFull
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_TIMEOUT_EXPIRED 0x911B
+#define GL_CONDITION_SATISFIED 0x911C
+#define GL_WAIT_FAILED 0x911D
 
 #endif
 }  // namespace tgfx
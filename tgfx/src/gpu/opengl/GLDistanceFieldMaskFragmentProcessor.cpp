@@ -0,0 +1,47 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GLDistanceFieldMaskFragmentProcessor.h"
+#include "gpu/DistanceFieldMaskFragmentProcessor.h"
+
+namespace tgfx {
+void GLDistanceFieldMaskFragmentProcessor::emitCode(EmitArgs& args) {
+  auto* fragBuilder = args.fragBuilder;
+  auto* uniformHandler = args.uniformHandler;
+  std::string distanceScaleName;
+  distanceScaleUniform = uniformHandler->addUniform(ShaderFlags::Fragment, ShaderVar::Type::Float,
+                                                    "DistanceScale", &distanceScaleName);
+  fragBuilder->codeAppend("float distance = ");
+  fragBuilder->appendTextureLookup((*args.textureSamplers)[0], (*args.transformedCoords)[0].name());
+  fragBuilder->codeAppend(".a;");
+  fragBuilder->codeAppendf("float coverage = clamp((distance - 0.5) * %s + 0.5, 0.0, 1.0);",
+                           distanceScaleName.c_str());
+  fragBuilder->codeAppendf("%s = %s * coverage;", args.outputColor.c_str(),
+                           args.inputColor.c_str());
+}
+
+void GLDistanceFieldMaskFragmentProcessor::onSetData(const ProgramDataManager& programDataManager,
+                                                     const FragmentProcessor& fragmentProcessor) {
+  const auto& distanceFieldFP =
+      static_cast<const DistanceFieldMaskFragmentProcessor&>(fragmentProcessor);
+  if (distanceScalePrev != distanceFieldFP.distanceScale) {
+    distanceScalePrev = distanceFieldFP.distanceScale;
+    programDataManager.set1f(distanceScaleUniform, distanceScalePrev);
+  }
+}
+}  // namespace tgfx
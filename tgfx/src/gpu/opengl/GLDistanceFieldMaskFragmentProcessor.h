@@ -18,19 +18,19 @@
 
 #pragma once
 
-#include "VideoReader.h"
-#include "base/utils/Task.h"
+#include "gpu/GLFragmentProcessor.h"
 
-namespace pag {
-class VideoDecodingTask : public Executor {
+namespace tgfx {
+class GLDistanceFieldMaskFragmentProcessor : public GLFragmentProcessor {
  public:
-  static std::shared_ptr<Task> MakeAndRun(VideoReader* reader, int64_t targetTime);
+  void emitCode(EmitArgs& args) override;
 
  private:
-  VideoReader* reader = nullptr;
-  int64_t targetTime = 0;
+  void onSetData(const ProgramDataManager& programDataManager,
+                 const FragmentProcessor& fragmentProcessor) override;
 
-  VideoDecodingTask(VideoReader* reader, int64_t targetTime);
-  void execute() override;
+  UniformHandle distanceScaleUniform;
+
+  float distanceScalePrev = -1;
 };
-}  // namespace pag
+}  // namespace tgfx
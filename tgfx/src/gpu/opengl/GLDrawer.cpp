@@ -229,11 +229,15 @@ void GLDrawer::draw(DrawArgs args, std::unique_ptr<GLDrawOp> op) const {
   auto indexBuffer = op->getIndexBuffer(args);
   if (indexBuffer) {
     gl->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer->bufferID());
-    gl->drawElements(GL_TRIANGLES, static_cast<int>(indexBuffer->length()), GL_UNSIGNED_SHORT, 0);
+    auto indexCount = op->indexCount(indexBuffer.get());
+    gl->drawElements(GL_TRIANGLES, static_cast<int>(indexCount), GL_UNSIGNED_SHORT, 0);
     gl->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
   } else {
-    gl->drawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    auto vertexCount =
+        vertices.size() * sizeof(float) / static_cast<size_t>(program->vertexStride());
+    gl->drawArrays(op->primitiveType(), 0, static_cast<int>(vertexCount));
   }
+  args.context->recordDrawCalls();
   if (vertexArray > 0) {
     gl->bindVertexArray(0);
   }
@@ -49,6 +49,21 @@ class GLDrawOp {
   virtual std::vector<float> vertices(const DrawArgs& args) = 0;
 
   virtual std::shared_ptr<GLBuffer> getIndexBuffer(const DrawArgs& args) = 0;
+
+  /**
+   * Returns the number of indices to draw from the buffer returned by getIndexBuffer(). The whole
+   * buffer is drawn by default.
+   */
+  virtual size_t indexCount(const GLBuffer* indexBuffer) const {
+    return indexBuffer->length();
+  }
+
+  /**
+   * Returns the primitive type used to draw the vertices if getIndexBuffer() returns nullptr.
+   */
+  virtual unsigned primitiveType() const {
+    return GL_TRIANGLE_STRIP;
+  }
 };
 
 class GLDrawer : public Resource {
@@ -26,45 +26,104 @@ std::unique_ptr<GeometryProcessor> GLFillRectOp::getGeometryProcessor(const Draw
       args.renderTarget->width(), args.renderTarget->height(), args.viewMatrix, args.aa);
 }
 
+static void WriteQuad(std::vector<float>* vertices, const Matrix& matrix, const Rect& bounds,
+                      const Rect& localCoords, const float* coverage) {
+  Point quad[4] = {{bounds.left, bounds.top},
+                   {bounds.left, bounds.bottom},
+                   {bounds.right, bounds.top},
+                   {bounds.right, bounds.bottom}};
+  matrix.mapPoints(quad, 4);
+  Point local[4] = {{localCoords.left, localCoords.top},
+                    {localCoords.left, localCoords.bottom},
+                    {localCoords.right, localCoords.top},
+                    {localCoords.right, localCoords.bottom}};
+  // Keeps the same vertex order as the triangle strip of a single rect when coverage is absent.
+  static constexpr int StripOrder[] = {3, 2, 1, 0};
+  static constexpr int CoverageOrder[] = {0, 1, 2, 3};
+  auto order = coverage ? CoverageOrder : StripOrder;
+  for (int i = 0; i < 4; i++) {
+    auto index = order[i];
+    vertices->push_back(quad[index].x);
+    vertices->push_back(quad[index].y);
+    if (coverage) {
+      vertices->push_back(*coverage);
+    }
+    vertices->push_back(local[index].x);
+    vertices->push_back(local[index].y);
+  }
+}
+
 std::vector<float> GLFillRectOp::vertices(const DrawArgs& args) {
-  auto bounds = args.rectToDraw;
-  auto normalBounds = Rect::MakeLTRB(0, 0, 1, 1);
+  if (args.aa == AAType::Coverage) {
+    return coverageVertices(args);
+  }
   // Vertex coordinates are arranged in a 2D pixel coordinate system, and textures are arranged
   // according to a texture coordinate system (0 - 1).
-  if (args.aa != AAType::Coverage) {
-    return {
-        bounds.right, bounds.bottom, normalBounds.right, normalBounds.bottom,
-        bounds.right, bounds.top,    normalBounds.right, normalBounds.top,
-        bounds.left,  bounds.bottom, normalBounds.left,  normalBounds.bottom,
-        bounds.left,  bounds.top,    normalBounds.left,  normalBounds.top,
-    };
+  std::vector<float> vertices = {};
+  if (rects.empty()) {
+    vertices.reserve(16);
+    WriteQuad(&vertices, Matrix::I(), args.rectToDraw, Rect::MakeLTRB(0, 0, 1, 1), nullptr);
+    return vertices;
+  }
+  vertices.reserve(rects.size() * 16);
+  for (size_t i = 0; i < rects.size(); i++) {
+    WriteQuad(&vertices, matrices[i], rects[i], localCoords[i], nullptr);
   }
-  auto scale = sqrtf(args.viewMatrix.getScaleX() * args.viewMatrix.getScaleX() +
-                     args.viewMatrix.getSkewY() * args.viewMatrix.getSkewY());
-  // we want the new edge to be .5px away from the old line.
-  auto padding = 0.5f / scale;
-  auto insetBounds = bounds.makeInset(padding, padding);
-  auto outsetBounds = bounds.makeOutset(padding, padding);
+  return vertices;
+}
 
-  auto normalPadding = Point::Make(padding / bounds.width(), padding / bounds.height());
-  auto normalInset = normalBounds.makeInset(normalPadding.x, normalPadding.y);
-  auto normalOutset = normalBounds.makeOutset(normalPadding.x, normalPadding.y);
-  return {
-      insetBounds.left,   insetBounds.top,     1.0f, normalInset.left,   normalInset.top,
-      insetBounds.left,   insetBounds.bottom,  1.0f, normalInset.left,   normalInset.bottom,
-      insetBounds.right,  insetBounds.top,     1.0f, normalInset.right,  normalInset.top,
-      insetBounds.right,  insetBounds.bottom,  1.0f, normalInset.right,  normalInset.bottom,
-      outsetBounds.left,  outsetBounds.top,    0.0f, normalOutset.left,  normalOutset.top,
-      outsetBounds.left,  outsetBounds.bottom, 0.0f, normalOutset.left,  normalOutset.bottom,
-      outsetBounds.right, outsetBounds.top,    0.0f, normalOutset.right, normalOutset.top,
-      outsetBounds.right, outsetBounds.bottom, 0.0f, normalOutset.right, normalOutset.bottom,
-  };
+std::vector<float> GLFillRectOp::coverageVertices(const DrawArgs& args) const {
+  static const std::vector<Rect> DefaultLocalCoords = {Rect::MakeLTRB(0, 0, 1, 1)};
+  static const std::vector<Matrix> DefaultMatrices = {Matrix::I()};
+  std::vector<Rect> defaultRects = {args.rectToDraw};
+  auto& allRects = rects.empty() ? defaultRects : rects;
+  auto& allMatrices = rects.empty() ? DefaultMatrices : matrices;
+  auto& allLocalCoords = rects.empty() ? DefaultLocalCoords : localCoords;
+  std::vector<float> vertices = {};
+  vertices.reserve(allRects.size() * 40);
+  static constexpr float InsetCoverage = 1.0f;
+  static constexpr float OutsetCoverage = 0.0f;
+  for (size_t i = 0; i < allRects.size(); i++) {
+    auto& bounds = allRects[i];
+    auto& local = allLocalCoords[i];
+    auto matrix = args.viewMatrix;
+    matrix.preConcat(allMatrices[i]);
+    auto scale = sqrtf(matrix.getScaleX() * matrix.getScaleX() +
+                       matrix.getSkewY() * matrix.getSkewY());
+    // we want the new edge to be .5px away from the old line.
+    auto padding = 0.5f / scale;
+    auto insetBounds = bounds.makeInset(padding, padding);
+    auto outsetBounds = bounds.makeOutset(padding, padding);
+    auto localPadding = Point::Make(padding * local.width() / bounds.width(),
+                                    padding * local.height() / bounds.height());
+    auto localInset = local.makeInset(localPadding.x, localPadding.y);
+    auto localOutset = local.makeOutset(localPadding.x, localPadding.y);
+    WriteQuad(&vertices, allMatrices[i], insetBounds, localInset, &InsetCoverage);
+    WriteQuad(&vertices, allMatrices[i], outsetBounds, localOutset, &OutsetCoverage);
+  }
+  return vertices;
 }
 
 std::unique_ptr<GLFillRectOp> GLFillRectOp::Make() {
   return std::make_unique<GLFillRectOp>();
 }
 
+std::unique_ptr<GLFillRectOp> GLFillRectOp::Make(std::vector<Rect> rects,
+                                                 std::vector<Matrix> matrices,
+                                                 std::vector<Rect> localCoords) {
+  if (rects.empty() || rects.size() > MaxNumRects || rects.size() != matrices.size() ||
+      rects.size() != localCoords.size()) {
+    return nullptr;
+  }
+  return std::unique_ptr<GLFillRectOp>(
+      new GLFillRectOp(std::move(rects), std::move(matrices), std::move(localCoords)));
+}
+
+GLFillRectOp::GLFillRectOp(std::vector<Rect> rects, std::vector<Matrix> matrices,
+                           std::vector<Rect> localCoords)
+    : rects(std::move(rects)), matrices(std::move(matrices)), localCoords(std::move(localCoords)) {
+}
+
 static constexpr size_t kIndicesPerAAFillRect = 30;
 
 // clang-format off
@@ -75,12 +134,42 @@ static constexpr uint16_t gFillAARectIdx[] = {
   2, 3, 6, 3, 7, 6,
   1, 5, 3, 3, 5, 7,
 };
+static constexpr size_t kIndicesPerNonAAFillRect = 6;
+
+static constexpr uint16_t gFillNonAARectIdx[] = {
+  0, 1, 2, 2, 1, 3,
+};
 // clang-format on
 
+static std::vector<uint16_t> MakeIndices(const uint16_t pattern[], size_t patternSize,
+                                         uint16_t verticesPerRect) {
+  std::vector<uint16_t> indices(patternSize * GLFillRectOp::MaxNumRects);
+  for (size_t i = 0; i < GLFillRectOp::MaxNumRects; i++) {
+    auto baseVertex = static_cast<uint16_t>(i * verticesPerRect);
+    for (size_t j = 0; j < patternSize; j++) {
+      indices[i * patternSize + j] = static_cast<uint16_t>(baseVertex + pattern[j]);
+    }
+  }
+  return indices;
+}
+
 std::shared_ptr<GLBuffer> GLFillRectOp::getIndexBuffer(const DrawArgs& args) {
+  // The index buffers are keyed by the address of their source data, so the shared patterns must
+  // live for the whole process. Each pattern is uploaded once for MaxNumRects rects, and
+  // indexCount() draws only the part used by this op.
   if (args.aa == AAType::Coverage) {
-    return GLBuffer::Make(args.context, gFillAARectIdx, kIndicesPerAAFillRect);
+    static const auto AAIndices = MakeIndices(gFillAARectIdx, kIndicesPerAAFillRect, 8);
+    return GLBuffer::Make(args.context, &AAIndices[0], AAIndices.size());
+  }
+  if (rects.size() <= 1) {
+    return nullptr;
   }
-  return nullptr;
+  static const auto NonAAIndices = MakeIndices(gFillNonAARectIdx, kIndicesPerNonAAFillRect, 4);
+  return GLBuffer::Make(args.context, &NonAAIndices[0], NonAAIndices.size());
+}
+
+size_t GLFillRectOp::indexCount(const GLBuffer* indexBuffer) const {
+  auto indicesPerRect = indexBuffer->length() / MaxNumRects;
+  return std::max(rects.size(), static_cast<size_t>(1)) * indicesPerRect;
 }
 }  // namespace tgfx
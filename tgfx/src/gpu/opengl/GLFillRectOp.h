@@ -25,12 +25,39 @@
 namespace tgfx {
 class GLFillRectOp : public GLDrawOp {
  public:
+  /**
+   * The maximum number of rects that can be filled by a single op.
+   */
+  static constexpr size_t MaxNumRects = 2048;
+
   static std::unique_ptr<GLFillRectOp> Make();
 
+  /**
+   * Creates an op that fills all the rects in a single draw call. Each rect is mapped by the
+   * matching matrix before DrawArgs.viewMatrix is applied, and localCoords holds the local
+   * coordinates of its corners. The number of rects must not exceed MaxNumRects.
+   */
+  static std::unique_ptr<GLFillRectOp> Make(std::vector<Rect> rects, std::vector<Matrix> matrices,
+                                            std::vector<Rect> localCoords);
+
+  GLFillRectOp() = default;
+
   std::unique_ptr<GeometryProcessor> getGeometryProcessor(const DrawArgs& args) override;
 
   std::vector<float> vertices(const DrawArgs& args) override;
 
   std::shared_ptr<GLBuffer> getIndexBuffer(const DrawArgs& args) override;
+
+  size_t indexCount(const GLBuffer* indexBuffer) const override;
+
+ private:
+  GLFillRectOp(std::vector<Rect> rects, std::vector<Matrix> matrices,
+               std::vector<Rect> localCoords);
+
+  std::vector<float> coverageVertices(const DrawArgs& args) const;
+
+  std::vector<Rect> rects;
+  std::vector<Matrix> matrices;
+  std::vector<Rect> localCoords;
 };
 }  // namespace tgfx
@@ -160,6 +160,10 @@ using GLGetShaderPrecisionFormat = void GL_FUNCTION_TYPE(unsigned shadertype,
 using GLFenceSync = void* GL_FUNCTION_TYPE(unsigned condition, unsigned flags);
 using GLWaitSync = void GL_FUNCTION_TYPE(void* sync, unsigned flags, uint64_t timeout);
 using GLDeleteSync = void GL_FUNCTION_TYPE(void* sync);
+using GLClientWaitSync = unsigned GL_FUNCTION_TYPE(void* sync, unsigned flags, uint64_t timeout);
+using GLMapBufferRange = void* GL_FUNCTION_TYPE(unsigned target, GLintptr offset,
+                                                GLsizeiptr length, unsigned access);
+using GLUnmapBuffer = unsigned char GL_FUNCTION_TYPE(unsigned target);
 }  // extern "C"
 
 // This is a lighter-weight std::function, trying to reduce code size and compile time by only
@@ -241,6 +241,12 @@ std::unique_ptr<const GLInterface> GLInterface::MakeNativeInterface(const GLProc
   interface->fenceSync = reinterpret_cast<GLFenceSync*>(getter->getProcAddress("glFenceSync"));
   interface->waitSync = reinterpret_cast<GLWaitSync*>(getter->getProcAddress("glWaitSync"));
   interface->deleteSync = reinterpret_cast<GLDeleteSync*>(getter->getProcAddress("glDeleteSync"));
+  interface->clientWaitSync =
+      reinterpret_cast<GLClientWaitSync*>(getter->getProcAddress("glClientWaitSync"));
+  interface->mapBufferRange =
+      reinterpret_cast<GLMapBufferRange*>(getter->getProcAddress("glMapBufferRange"));
+  interface->unmapBuffer =
+      reinterpret_cast<GLUnmapBuffer*>(getter->getProcAddress("glUnmapBuffer"));
   switch (info.standard) {
     case GLStandard::None:
       break;
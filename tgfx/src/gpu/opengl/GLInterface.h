@@ -121,6 +121,9 @@ class GLInterface {
   GLFunction<GLFenceSync> fenceSync;
   GLFunction<GLWaitSync> waitSync;
   GLFunction<GLDeleteSync> deleteSync;
+  GLFunction<GLClientWaitSync> clientWaitSync;
+  GLFunction<GLMapBufferRange> mapBufferRange;
+  GLFunction<GLUnmapBuffer> unmapBuffer;
 
   std::shared_ptr<const GLCaps> caps = nullptr;
 
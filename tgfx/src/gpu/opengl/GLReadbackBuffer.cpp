@@ -0,0 +1,142 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GLReadbackBuffer.h"
+#include "GLContext.h"
+#include "GLState.h"
+#include "GLUtil.h"
+
+namespace tgfx {
+std::shared_ptr<ReadbackBuffer> ReadbackBuffer::Make(Context* context, int width, int height,
+                                                     bool alphaOnly) {
+  if (context == nullptr || width <= 0 || height <= 0) {
+    return nullptr;
+  }
+  auto gl = GLContext::Unwrap(context);
+  if (!gl->caps->pixelPackBufferSupport) {
+    return nullptr;
+  }
+  if (alphaOnly && !gl->caps->textureRedSupport) {
+    return nullptr;
+  }
+  auto pixelFormat = alphaOnly ? PixelFormat::ALPHA_8 : PixelFormat::RGBA_8888;
+  auto buffer = new GLReadbackBuffer(width, height, pixelFormat);
+  gl->genBuffers(1, &buffer->bufferID);
+  if (buffer->bufferID == 0) {
+    delete buffer;
+    return nullptr;
+  }
+  auto readbackBuffer = Resource::Wrap(context, buffer);
+  GLStateGuard stateGuard(context);
+  gl->bindBuffer(GL_PIXEL_PACK_BUFFER, buffer->bufferID);
+  auto byteSize = static_cast<GLsizeiptr>(buffer->rowBytes() * static_cast<size_t>(height));
+  gl->bufferData(GL_PIXEL_PACK_BUFFER, byteSize, nullptr, GL_STREAM_READ);
+  if (!CheckGLError(gl)) {
+    return nullptr;
+  }
+  return readbackBuffer;
+}
+
+size_t GLReadbackBuffer::rowBytes() const {
+  auto bytesPerPixel = pixelFormat == PixelFormat::ALPHA_8 ? 1 : 4;
+  // Each row is aligned to 4 bytes, which is the default GL_PACK_ALIGNMENT.
+  return (static_cast<size_t>(width()) * bytesPerPixel + 3) & ~static_cast<size_t>(3);
+}
+
+bool GLReadbackBuffer::readFrom(Context* context, const GLRenderTarget* renderTarget) {
+  auto frameBuffer = renderTarget->glFrameBuffer();
+  if (frameBuffer.format != pixelFormat) {
+    return false;
+  }
+  deleteSync();
+  auto gl = GLContext::Unwrap(context);
+  GLStateGuard stateGuard(context);
+  gl->bindFramebuffer(GL_FRAMEBUFFER, frameBuffer.id);
+  gl->bindBuffer(GL_PIXEL_PACK_BUFFER, bufferID);
+  gl->pixelStorei(GL_PACK_ALIGNMENT, 4);
+  if (gl->caps->packRowLengthSupport) {
+    gl->pixelStorei(GL_PACK_ROW_LENGTH, 0);
+  }
+  const auto& format = gl->caps->getTextureFormat(pixelFormat);
+  // With a buffer bound to GL_PIXEL_PACK_BUFFER, the last argument is an offset into the buffer,
+  // and glReadPixels() returns without waiting for the GPU.
+  gl->readPixels(0, 0, width(), height(), format.externalFormat, GL_UNSIGNED_BYTE, nullptr);
+  glSync = gl->fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  if (glSync == nullptr) {
+    return false;
+  }
+  // Submits the commands so that the fence can be signaled without any further flushes.
+  gl->flush();
+  origin = renderTarget->origin();
+  return true;
+}
+
+bool GLReadbackBuffer::isReady() const {
+  if (glSync == nullptr) {
+    return false;
+  }
+  auto gl = GLContext::Unwrap(getContext());
+  auto result = gl->clientWaitSync(glSync, 0, 0);
+  return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+
+bool GLReadbackBuffer::readPixels(const ImageInfo& dstInfo, void* dstPixels) {
+  if (glSync == nullptr || dstPixels == nullptr || dstInfo.isEmpty()) {
+    return false;
+  }
+  auto gl = GLContext::Unwrap(getContext());
+  auto result = gl->clientWaitSync(glSync, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+  deleteSync();
+  if (result == GL_WAIT_FAILED) {
+    return false;
+  }
+  GLStateGuard stateGuard(getContext());
+  gl->bindBuffer(GL_PIXEL_PACK_BUFFER, bufferID);
+  auto byteSize = rowBytes() * static_cast<size_t>(height());
+  auto pixels = gl->mapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(byteSize),
+                                   GL_MAP_READ_BIT);
+  if (pixels == nullptr) {
+    return false;
+  }
+  auto colorType = pixelFormat == PixelFormat::ALPHA_8 ? ColorType::ALPHA_8 : ColorType::RGBA_8888;
+  auto srcInfo =
+      ImageInfo::Make(width(), height(), colorType, AlphaType::Premultiplied, rowBytes());
+  CopyPixels(srcInfo, pixels, dstInfo, dstPixels, origin == ImageOrigin::BottomLeft);
+  gl->unmapBuffer(GL_PIXEL_PACK_BUFFER);
+  return true;
+}
+
+void GLReadbackBuffer::deleteSync() {
+  if (glSync != nullptr) {
+    GLContext::Unwrap(getContext())->deleteSync(glSync);
+    glSync = nullptr;
+  }
+}
+
+void GLReadbackBuffer::onRelease(Context* context) {
+  auto gl = GLContext::Unwrap(context);
+  if (glSync != nullptr) {
+    gl->deleteSync(glSync);
+    glSync = nullptr;
+  }
+  if (bufferID > 0) {
+    gl->deleteBuffers(1, &bufferID);
+    bufferID = 0;
+  }
+}
+}  // namespace tgfx
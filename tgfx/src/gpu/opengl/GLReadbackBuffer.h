@@ -0,0 +1,62 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "gpu/ReadbackBuffer.h"
+#include "gpu/opengl/GLRenderTarget.h"
+
+namespace tgfx {
+/**
+ * GLReadbackBuffer copies pixels of a render target into a GL_PIXEL_PACK_BUFFER and inserts a fence
+ * after the copy, the pixels are fetched by mapping the buffer once the fence is signaled.
+ */
+class GLReadbackBuffer : public ReadbackBuffer {
+ public:
+  bool isPending() const override {
+    return glSync != nullptr;
+  }
+
+  bool isReady() const override;
+
+  bool readPixels(const ImageInfo& dstInfo, void* dstPixels) override;
+
+ protected:
+  void onRelease(Context* context) override;
+
+ private:
+  PixelFormat pixelFormat = PixelFormat::RGBA_8888;
+  ImageOrigin origin = ImageOrigin::TopLeft;
+  unsigned bufferID = 0;
+  void* glSync = nullptr;
+
+  GLReadbackBuffer(int width, int height, PixelFormat pixelFormat)
+      : ReadbackBuffer(width, height), pixelFormat(pixelFormat) {
+  }
+
+  size_t rowBytes() const;
+
+  void deleteSync();
+
+  bool readFrom(Context* context, const GLRenderTarget* renderTarget);
+
+  friend class ReadbackBuffer;
+
+  friend class GLSurface;
+};
+}  // namespace tgfx
@@ -17,7 +17,6 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "gpu/opengl/GLRenderTarget.h"
-#include "core/Bitmap.h"
 #include "gpu/opengl/GLContext.h"
 #include "gpu/opengl/GLState.h"
 #include "gpu/opengl/GLUtil.h"
@@ -201,27 +200,6 @@ static bool CanReadDirectly(const GLInterface* gl, ImageOrigin origin, const Ima
   return true;
 }
 
-static void CopyPixels(const ImageInfo& srcInfo, const void* srcPixels, const ImageInfo& dstInfo,
-                       void* dstPixels, bool flipY) {
-  auto pixels = srcPixels;
-  uint8_t* tempPixels = nullptr;
-  if (flipY) {
-    tempPixels = new uint8_t[srcInfo.byteSize()];
-    auto rowCount = srcInfo.height();
-    auto rowBytes = srcInfo.rowBytes();
-    auto dst = tempPixels;
-    for (int i = 0; i < rowCount; i++) {
-      auto src = reinterpret_cast<const uint8_t*>(srcPixels) + (rowCount - i - 1) * rowBytes;
-      memcpy(dst, src, rowBytes);
-      dst += rowBytes;
-    }
-    pixels = tempPixels;
-  }
-  Bitmap bitmap(srcInfo, pixels);
-  bitmap.readPixels(dstInfo, dstPixels);
-  delete[] tempPixels;
-}
-
 bool GLRenderTarget::readPixels(Context* context, const ImageInfo& dstInfo, void* dstPixels,
                                 int srcX, int srcY) const {
   dstPixels = dstInfo.computeOffset(dstPixels, -srcX, -srcY);
@@ -437,6 +437,48 @@ class ElementBufferBinding : public GLAttribute {
   int buffer = 0;
 };
 
+class PixelPackBufferBinding : public GLAttribute {
+ public:
+  explicit PixelPackBufferBinding(const GLInterface* gl) {
+    gl->getIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &buffer);
+  }
+
+  GLAttributeType type() const override {
+    return GLAttributeType::PixelPackBufferBinding;
+  }
+
+  int priority() const override {
+    return PRIORITY_DEFAULT;
+  }
+
+  void apply(GLState* state) const override {
+    state->gl->bindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+  }
+
+  int buffer = 0;
+};
+
+class PixelUnpackBufferBinding : public GLAttribute {
+ public:
+  explicit PixelUnpackBufferBinding(const GLInterface* gl) {
+    gl->getIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &buffer);
+  }
+
+  GLAttributeType type() const override {
+    return GLAttributeType::PixelUnpackBufferBinding;
+  }
+
+  int priority() const override {
+    return PRIORITY_DEFAULT;
+  }
+
+  void apply(GLState* state) const override {
+    state->gl->bindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+  }
+
+  int buffer = 0;
+};
+
 class FrameBufferBinding : public GLAttribute {
  public:
   explicit FrameBufferBinding(const GLInterface* gl) {
@@ -899,6 +941,12 @@ void GLState::bindBuffer(unsigned target, unsigned buffer) {
         SAVE_DEFAULT(ElementBufferBinding)
       }
       break;
+    case GL_PIXEL_PACK_BUFFER:
+      SAVE_DEFAULT(PixelPackBufferBinding)
+      break;
+    case GL_PIXEL_UNPACK_BUFFER:
+      SAVE_DEFAULT(PixelUnpackBufferBinding)
+      break;
     default:
       UNSUPPORTED_STATE_WARNING()
       break;
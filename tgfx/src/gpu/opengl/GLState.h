@@ -46,6 +46,8 @@ enum class GLAttributeType {
   RenderBufferBinding,
   PackAlignment,
   PackRowLength,
+  PixelPackBufferBinding,
+  PixelUnpackBufferBinding,
   ScissorBox,
   TextureBinding,
   UnpackAlignment,
@@ -19,6 +19,7 @@
 #include "GLSurface.h"
 #include "GLCaps.h"
 #include "GLContext.h"
+#include "GLReadbackBuffer.h"
 #include "gpu/opengl/GLSemaphore.h"
 
 namespace tgfx {
@@ -138,4 +139,13 @@ bool GLSurface::onReadPixels(const ImageInfo& dstInfo, void* dstPixels, int srcX
   renderTarget->resolve(context);
   return renderTarget->readPixels(context, dstInfo, dstPixels, srcX, srcY);
 }
+
+bool GLSurface::onReadPixels(ReadbackBuffer* readbackBuffer) const {
+  if (canvas) {
+    canvas->flush();
+  }
+  auto context = getContext();
+  renderTarget->resolve(context);
+  return static_cast<GLReadbackBuffer*>(readbackBuffer)->readFrom(context, renderTarget.get());
+}
 }  // namespace tgfx
@@ -55,6 +55,8 @@ class GLSurface : public Surface {
  protected:
   bool onReadPixels(const ImageInfo& dstInfo, void* dstPixels, int srcX, int srcY) const override;
 
+  bool onReadPixels(ReadbackBuffer* readbackBuffer) const override;
+
  private:
   std::shared_ptr<GLRenderTarget> renderTarget = nullptr;
   std::shared_ptr<GLTexture> texture = nullptr;
@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "gpu/opengl/GLTexture.h"
+#include "GLTextureUploader.h"
 #include "GLUtil.h"
 #include "core/utils/UniqueID.h"
 
@@ -153,10 +154,10 @@ std::shared_ptr<Texture> Texture::Make(Context* context, int width, int height,
     gl->texParameteri(sampler.target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     gl->texParameteri(sampler.target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     gl->texParameteri(sampler.target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    if (pixels == nullptr) {
-      gl->texImage2D(sampler.target, 0, static_cast<int>(format.internalFormatTexImage), width,
-                     height, 0, format.externalFormat, GL_UNSIGNED_BYTE, nullptr);
-    }
+    // Only allocates the storage here, the pixels are streamed in the same way as a recycled
+    // texture below.
+    gl->texImage2D(sampler.target, 0, static_cast<int>(format.internalFormatTexImage), width,
+                   height, 0, format.externalFormat, GL_UNSIGNED_BYTE, nullptr);
     if (!CheckGLError(gl)) {
       gl->deleteTextures(1, &sampler.id);
       return nullptr;
@@ -169,7 +170,8 @@ std::shared_ptr<Texture> Texture::Make(Context* context, int width, int height,
   }
   if (pixels != nullptr) {
     int bytesPerPixel = alphaOnly ? 1 : 4;
-    SubmitGLTexture(gl, sampler, width, height, rowBytes, bytesPerPixel, pixels);
+    GLTextureUploader::Get(context)->writePixels(sampler, width, height, rowBytes, bytesPerPixel,
+                                                 pixels);
   }
   return texture;
 }
@@ -0,0 +1,173 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GLTextureUploader.h"
+#include "GLContext.h"
+#include "GLState.h"
+#include "gpu/Resource.h"
+
+namespace tgfx {
+#define UNPACK_BUFFER_COUNT 3
+// Larger pixels are uploaded directly rather than keeping huge staging buffers alive.
+#define MAX_UNPACK_BUFFER_SIZE (8 * 1024 * 1024)
+
+class GLUnpackBuffer : public Resource {
+ public:
+  static std::shared_ptr<GLUnpackBuffer> Make(Context* context, size_t byteSize) {
+    auto gl = GLContext::Unwrap(context);
+    auto buffer = new GLUnpackBuffer(byteSize);
+    gl->genBuffers(1, &buffer->bufferID);
+    if (buffer->bufferID == 0) {
+      delete buffer;
+      return nullptr;
+    }
+    auto unpackBuffer = Resource::Wrap(context, buffer);
+    gl->bindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->bufferID);
+    gl->bufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(byteSize), nullptr,
+                   GL_STREAM_DRAW);
+    gl->bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (!CheckGLError(gl)) {
+      return nullptr;
+    }
+    return unpackBuffer;
+  }
+
+  size_t byteSize = 0;
+  unsigned bufferID = 0;
+  void* glSync = nullptr;
+
+  /**
+   * Returns true if the GPU has finished pulling the pixels of the last upload from this buffer.
+   */
+  bool isReady() {
+    if (glSync == nullptr) {
+      return true;
+    }
+    auto gl = GLContext::Unwrap(getContext());
+    auto result = gl->clientWaitSync(glSync, 0, 0);
+    if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+      return false;
+    }
+    gl->deleteSync(glSync);
+    glSync = nullptr;
+    return true;
+  }
+
+  /**
+   * Copies the pixels into this buffer with the rows packed tightly.
+   */
+  bool stagePixels(const GLInterface* gl, const void* pixels, size_t rowBytes, size_t trimRowBytes,
+                   int height) {
+    auto stagedSize = trimRowBytes * static_cast<size_t>(height);
+    gl->bindBuffer(GL_PIXEL_UNPACK_BUFFER, bufferID);
+    // Invalidating the buffer saves the driver from preserving its old content.
+    auto data = gl->mapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(stagedSize),
+                                   GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    auto success = data != nullptr;
+    if (success) {
+      auto srcPixels = static_cast<const uint8_t*>(pixels);
+      auto dstPixels = static_cast<uint8_t*>(data);
+      if (rowBytes == trimRowBytes) {
+        memcpy(dstPixels, srcPixels, stagedSize);
+      } else {
+        for (int row = 0; row < height; ++row) {
+          memcpy(dstPixels + row * trimRowBytes, srcPixels + row * rowBytes, trimRowBytes);
+        }
+      }
+      // The content of the buffer may be lost while it is mapped, e.g. the display mode changed.
+      success = gl->unmapBuffer(GL_PIXEL_UNPACK_BUFFER) != 0;
+    }
+    gl->bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return success;
+  }
+
+ protected:
+  void onRelease(Context* context) override {
+    auto gl = GLContext::Unwrap(context);
+    if (glSync != nullptr) {
+      gl->deleteSync(glSync);
+      glSync = nullptr;
+    }
+    if (bufferID > 0) {
+      gl->deleteBuffers(1, &bufferID);
+      bufferID = 0;
+    }
+  }
+
+ private:
+  explicit GLUnpackBuffer(size_t byteSize) : byteSize(byteSize) {
+  }
+};
+
+GLTextureUploader* GLTextureUploader::Get(Context* context) {
+  return context ? static_cast<GLContext*>(context)->textureUploader.get() : nullptr;
+}
+
+void GLTextureUploader::writePixels(const GLSampler& sampler, int width, int height,
+                                    size_t rowBytes, int bytesPerPixel, void* pixels) {
+  if (pixels == nullptr || rowBytes == 0) {
+    return;
+  }
+  auto gl = GLContext::Unwrap(context);
+  auto trimRowBytes = static_cast<size_t>(width) * bytesPerPixel;
+  auto byteSize = trimRowBytes * static_cast<size_t>(height);
+  context->_uploadedTextureBytes += byteSize;
+  auto buffer = nextUnpackBuffer(byteSize);
+  if (buffer == nullptr || !buffer->stagePixels(gl, pixels, rowBytes, trimRowBytes, height)) {
+    UpdateGLTexture(gl, sampler, width, height, rowBytes, bytesPerPixel, pixels);
+    return;
+  }
+  const auto& format = gl->caps->getTextureFormat(sampler.format);
+  gl->bindTexture(sampler.target, sampler.id);
+  gl->bindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->bufferID);
+  gl->pixelStorei(GL_UNPACK_ALIGNMENT, bytesPerPixel);
+  if (gl->caps->unpackRowLengthSupport) {
+    gl->pixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  }
+  // With a buffer bound to GL_PIXEL_UNPACK_BUFFER, the last argument is an offset into the buffer,
+  // and glTexSubImage2D() returns without waiting for the GPU to pull the pixels.
+  gl->texSubImage2D(sampler.target, 0, 0, 0, width, height, format.externalFormat,
+                    GL_UNSIGNED_BYTE, nullptr);
+  gl->bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  gl->bindTexture(sampler.target, 0);
+  buffer->glSync = gl->fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+GLUnpackBuffer* GLTextureUploader::nextUnpackBuffer(size_t byteSize) {
+  auto gl = GLContext::Unwrap(context);
+  if (!gl->caps->pixelUnpackBufferSupport || byteSize > MAX_UNPACK_BUFFER_SIZE) {
+    return nullptr;
+  }
+  if (unpackBuffers.empty()) {
+    unpackBuffers.resize(UNPACK_BUFFER_COUNT);
+  }
+  auto& buffer = unpackBuffers[bufferIndex];
+  bufferIndex = (bufferIndex + 1) % unpackBuffers.size();
+  // The context of the buffer is cleared once the context has released all of its resources.
+  if (buffer != nullptr && (buffer->getContext() == nullptr || buffer->byteSize < byteSize)) {
+    buffer = nullptr;
+  }
+  if (buffer == nullptr) {
+    buffer = GLUnpackBuffer::Make(context, byteSize);
+  } else if (!buffer->isReady()) {
+    // Never waits for the GPU here, uploading the pixels directly is cheaper.
+    return nullptr;
+  }
+  return buffer.get();
+}
+}  // namespace tgfx
@@ -0,0 +1,57 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLUtil.h"
+
+namespace tgfx {
+class GLUnpackBuffer;
+
+/**
+ * GLTextureUploader streams pixels from the CPU into the textures of a GLContext. The textures are
+ * expected to be recycled by their format and size through ResourceCache::getRecycled(), so they
+ * are updated by texSubImage2D() rather than re-specified by texImage2D(). If the backend supports
+ * pixel unpack buffers, the pixels are staged through a ring of buffers first, which lets
+ * texSubImage2D() return before the GPU pulls the pixels. A buffer is written again only after the
+ * fence of its last upload is signaled, otherwise the pixels are uploaded directly.
+ */
+class GLTextureUploader {
+ public:
+  /**
+   * Returns the uploader of the specified context.
+   */
+  static GLTextureUploader* Get(Context* context);
+
+  explicit GLTextureUploader(Context* context) : context(context) {
+  }
+
+  /**
+   * Replaces the pixels of a texture whose storage has been allocated with the specified size.
+   */
+  void writePixels(const GLSampler& sampler, int width, int height, size_t rowBytes,
+                   int bytesPerPixel, void* pixels);
+
+ private:
+  Context* context = nullptr;
+  std::vector<std::shared_ptr<GLUnpackBuffer>> unpackBuffers = {};
+  size_t bufferIndex = 0;
+
+  GLUnpackBuffer* nextUnpackBuffer(size_t byteSize);
+};
+}  // namespace tgfx
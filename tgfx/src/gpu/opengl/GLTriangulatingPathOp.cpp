@@ -0,0 +1,309 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "GLTriangulatingPathOp.h"
+#include <algorithm>
+#include <limits>
+#include "core/utils/MathExtra.h"
+#include "gpu/QuadPerEdgeAAGeometryProcessor.h"
+
+namespace tgfx {
+// The maximum distance in pixels between a curve and the lines approximating it.
+static constexpr float FlattenTolerance = 0.25f;
+static constexpr int MaxCurveSegments = 64;
+// Keeps the coverage ramps at sharp corners within 0.5 / sqrt(MinMiterDenominator / 2) pixels.
+static constexpr float MinMiterDenominator = 0.125f;
+
+struct FlattenContext {
+  std::vector<Point> points = {};
+  bool rejected = false;
+
+  void addPoint(const Point& point) {
+    if (rejected) {
+      return;
+    }
+    if (!points.empty() && FloatNearlyEqual(points.back().x, point.x) &&
+        FloatNearlyEqual(points.back().y, point.y)) {
+      return;
+    }
+    if (points.size() == GLTriangulatingPathOp::MaxNumPoints) {
+      rejected = true;
+      return;
+    }
+    points.push_back(point);
+  }
+};
+
+static int CurveSegments(float secondDifference) {
+  // The distance between a curve and its chords is at most |B''| / (8 * n^2).
+  auto count = static_cast<int>(ceilf(sqrtf(secondDifference / (8.0f * FlattenTolerance))));
+  return std::min(std::max(count, 1), MaxCurveSegments);
+}
+
+static void FlattenQuad(const Point points[3], FlattenContext* context) {
+  auto ddx = points[0].x - 2 * points[1].x + points[2].x;
+  auto ddy = points[0].y - 2 * points[1].y + points[2].y;
+  auto count = CurveSegments(2 * Point::Length(ddx, ddy));
+  for (int i = 1; i <= count; i++) {
+    auto t = static_cast<float>(i) / static_cast<float>(count);
+    auto u = 1 - t;
+    auto a = u * u;
+    auto b = 2 * u * t;
+    auto c = t * t;
+    context->addPoint({a * points[0].x + b * points[1].x + c * points[2].x,
+                       a * points[0].y + b * points[1].y + c * points[2].y});
+  }
+}
+
+static void FlattenCubic(const Point points[4], FlattenContext* context) {
+  auto d1 = Point::Length(points[0].x - 2 * points[1].x + points[2].x,
+                          points[0].y - 2 * points[1].y + points[2].y);
+  auto d2 = Point::Length(points[1].x - 2 * points[2].x + points[3].x,
+                          points[1].y - 2 * points[2].y + points[3].y);
+  auto count = CurveSegments(6 * std::max(d1, d2));
+  for (int i = 1; i <= count; i++) {
+    auto t = static_cast<float>(i) / static_cast<float>(count);
+    auto u = 1 - t;
+    auto a = u * u * u;
+    auto b = 3 * u * u * t;
+    auto c = 3 * u * t * t;
+    auto d = t * t * t;
+    context->addPoint(
+        {a * points[0].x + b * points[1].x + c * points[2].x + d * points[3].x,
+         a * points[0].y + b * points[1].y + c * points[2].y + d * points[3].y});
+  }
+}
+
+static float Cross(const Point& a, const Point& b) {
+  return a.x * b.y - a.y * b.x;
+}
+
+static float Dot(const Point& a, const Point& b) {
+  return a.x * b.x + a.y * b.y;
+}
+
+/**
+ * Returns true if the points form a convex polygon with a visible area, and reorders them so that
+ * every corner turns in the positive direction.
+ */
+static bool MakeConvex(std::vector<Point>* points) {
+  auto& polygon = *points;
+  auto count = polygon.size();
+  if (count < 3) {
+    return false;
+  }
+  float area = 0;
+  for (size_t i = 0; i < count; i++) {
+    area += Cross(polygon[i], polygon[(i + 1) % count]);
+  }
+  if (fabsf(area) < 1.0f) {
+    return false;
+  }
+  if (area < 0) {
+    std::reverse(polygon.begin(), polygon.end());
+  }
+  float totalTurn = 0;
+  for (size_t i = 0; i < count; i++) {
+    auto& prev = polygon[(i + count - 1) % count];
+    auto& current = polygon[i];
+    auto& next = polygon[(i + 1) % count];
+    auto d1 = current - prev;
+    auto d2 = next - current;
+    auto cross = Cross(d1, d2);
+    if (cross < -FLOAT_NEARLY_ZERO * d1.length() * d2.length()) {
+      return false;
+    }
+    totalTurn += atan2f(cross, Dot(d1, d2));
+  }
+  // A convex polygon turns around exactly once, while a self-intersecting one turns more.
+  return totalTurn < 2 * M_PI_F + 0.01f;
+}
+
+std::unique_ptr<GLTriangulatingPathOp> GLTriangulatingPathOp::Make(const Path& path,
+                                                                   const Matrix& matrix) {
+  if (path.isInverseFillType()) {
+    return nullptr;
+  }
+  auto devicePath = path;
+  devicePath.transform(matrix);
+  FlattenContext context = {};
+  int numContours = 0;
+  devicePath.decompose([&](PathVerb verb, const Point points[4], void*) {
+    switch (verb) {
+      case PathVerb::Move:
+        numContours++;
+        if (numContours > 1) {
+          context.rejected = true;
+        }
+        context.addPoint(points[0]);
+        break;
+      case PathVerb::Line:
+        context.addPoint(points[1]);
+        break;
+      case PathVerb::Quad:
+        FlattenQuad(points, &context);
+        break;
+      case PathVerb::Cubic:
+        FlattenCubic(points, &context);
+        break;
+      default:
+        break;
+    }
+  });
+  auto& points = context.points;
+  if (context.rejected) {
+    return nullptr;
+  }
+  if (points.size() > 1 && FloatNearlyEqual(points.front().x, points.back().x) &&
+      FloatNearlyEqual(points.front().y, points.back().y)) {
+    points.pop_back();
+  }
+  if (!MakeConvex(&points)) {
+    return nullptr;
+  }
+  return std::unique_ptr<GLTriangulatingPathOp>(new GLTriangulatingPathOp(std::move(points)));
+}
+
+GLTriangulatingPathOp::GLTriangulatingPathOp(std::vector<Point> points)
+    : points(std::move(points)) {
+  _bounds.setBounds(&this->points[0], static_cast<int>(this->points.size()));
+  // The coverage ramps extend up to the maximum miter length beyond the edges.
+  auto outset = 0.5f / sqrtf(MinMiterDenominator / 2.0f);
+  _bounds.outset(outset, outset);
+}
+
+std::unique_ptr<GeometryProcessor> GLTriangulatingPathOp::getGeometryProcessor(
+    const DrawArgs& args) {
+  return QuadPerEdgeAAGeometryProcessor::Make(
+      args.renderTarget->width(), args.renderTarget->height(), args.viewMatrix, args.aa);
+}
+
+static void WriteVertex(std::vector<float>* vertices, const Point& point, const float* coverage) {
+  vertices->push_back(point.x);
+  vertices->push_back(point.y);
+  if (coverage) {
+    vertices->push_back(*coverage);
+  }
+  // The local coordinates are in device space, which is mapped back to the path space by the
+  // local matrix of the fragment processors.
+  vertices->push_back(point.x);
+  vertices->push_back(point.y);
+}
+
+std::vector<float> GLTriangulatingPathOp::vertices(const DrawArgs& args) {
+  if (args.aa == AAType::Coverage) {
+    return coverageVertices();
+  }
+  std::vector<float> vertices = {};
+  vertices.reserve((points.size() - 2) * 12);
+  for (size_t i = 1; i + 1 < points.size(); i++) {
+    WriteVertex(&vertices, points[0], nullptr);
+    WriteVertex(&vertices, points[i], nullptr);
+    WriteVertex(&vertices, points[i + 1], nullptr);
+  }
+  return vertices;
+}
+
+/**
+ * Returns the minimum width of the convex polygon across its edges, or a value not less than 1 if
+ * the polygon is at least 1px wide everywhere.
+ */
+static float MinWidth(const std::vector<Point>& points, const std::vector<Point>& normals,
+                      const Rect& bounds) {
+  // A convex polygon fits in a strip of its minimum width along its diameter, so the width is at
+  // least the area divided by the diameter, which skips the quadratic search for most shapes.
+  float area = 0;
+  for (size_t i = 0; i < points.size(); i++) {
+    area += Cross(points[i], points[(i + 1) % points.size()]);
+  }
+  auto diameter = Point::Length(bounds.width(), bounds.height());
+  if (area * 0.5f >= diameter) {
+    return 1.0f;
+  }
+  auto minWidth = std::numeric_limits<float>::max();
+  for (size_t i = 0; i < normals.size(); i++) {
+    auto& normal = normals[i];
+    auto edgeDistance = Dot(points[i], normal);
+    float width = 0;
+    for (auto& point : points) {
+      width = std::max(width, edgeDistance - Dot(point, normal));
+    }
+    minWidth = std::min(minWidth, width);
+  }
+  return minWidth;
+}
+
+std::vector<float> GLTriangulatingPathOp::coverageVertices() const {
+  auto count = points.size();
+  std::vector<Point> normals = {};
+  normals.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    auto edge = points[(i + 1) % count] - points[i];
+    auto length = edge.length();
+    // Points to the outside of the polygon, since every corner turns in the positive direction.
+    normals.push_back({edge.y / length, -edge.x / length});
+  }
+  // We want the new edges to be .5px away from the old ones on both sides. The inset edges of a
+  // shape thinner than 1px would cross each other, so the inset is limited to half of the minimum
+  // width of the shape, and the coverage of the inset edges drops to the width of the shape.
+  auto bounds = Rect::MakeEmpty();
+  bounds.setBounds(&points[0], static_cast<int>(count));
+  auto inset = std::min(0.5f, MinWidth(points, normals, bounds) * 0.5f);
+  std::vector<Point> insets = {};
+  std::vector<Point> outsets = {};
+  insets.reserve(count);
+  outsets.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    auto& n1 = normals[(i + count - 1) % count];
+    auto& n2 = normals[i];
+    auto scale = 1.0f / std::max(1.0f + Dot(n1, n2), MinMiterDenominator);
+    auto offset = Point::Make((n1.x + n2.x) * scale, (n1.y + n2.y) * scale);
+    insets.push_back({points[i].x - offset.x * inset, points[i].y - offset.y * inset});
+    outsets.push_back({points[i].x + offset.x * 0.5f, points[i].y + offset.y * 0.5f});
+  }
+  const float InsetCoverage = std::min(1.0f, inset * 2.0f);
+  static constexpr float OutsetCoverage = 0.0f;
+  std::vector<float> vertices = {};
+  vertices.reserve((count - 2 + count * 2) * 15);
+  for (size_t i = 1; i + 1 < count; i++) {
+    WriteVertex(&vertices, insets[0], &InsetCoverage);
+    WriteVertex(&vertices, insets[i], &InsetCoverage);
+    WriteVertex(&vertices, insets[i + 1], &InsetCoverage);
+  }
+  for (size_t i = 0; i < count; i++) {
+    auto next = (i + 1) % count;
+    WriteVertex(&vertices, outsets[i], &OutsetCoverage);
+    WriteVertex(&vertices, outsets[next], &OutsetCoverage);
+    WriteVertex(&vertices, insets[i], &InsetCoverage);
+    WriteVertex(&vertices, insets[i], &InsetCoverage);
+    WriteVertex(&vertices, outsets[next], &OutsetCoverage);
+    WriteVertex(&vertices, insets[next], &InsetCoverage);
+  }
+  return vertices;
+}
+
+std::shared_ptr<GLBuffer> GLTriangulatingPathOp::getIndexBuffer(const DrawArgs&) {
+  // The index buffers are keyed by the address of their source data, which doesn't fit the
+  // vertices generated for every draw, so the triangles are drawn as a plain list.
+  return nullptr;
+}
+
+unsigned GLTriangulatingPathOp::primitiveType() const {
+  return GL_TRIANGLES;
+}
+}  // namespace tgfx
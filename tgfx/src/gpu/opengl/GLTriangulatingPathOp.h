@@ -0,0 +1,68 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLDrawer.h"
+#include "core/Path.h"
+
+namespace tgfx {
+/**
+ * GLTriangulatingPathOp fills a path on the GPU with triangles instead of rasterizing a mask on the
+ * CPU. The path is flattened in device space and must form a single convex contour, the edges are
+ * antialiased by a half-pixel coverage ramp on both sides.
+ */
+class GLTriangulatingPathOp : public GLDrawOp {
+ public:
+  /**
+   * The maximum number of points the flattened path can have. Paths with more points are cheaper
+   * to rasterize on the CPU than to triangulate.
+   */
+  static constexpr size_t MaxNumPoints = 1024;
+
+  /**
+   * Creates an op that fills the path transformed by the matrix. The vertices are in device space,
+   * so the op must be drawn with an identity matrix. Returns nullptr if the path is not simple
+   * enough to be triangulated.
+   */
+  static std::unique_ptr<GLTriangulatingPathOp> Make(const Path& path, const Matrix& matrix);
+
+  /**
+   * Returns the device bounds of the op, including the coverage ramps.
+   */
+  Rect bounds() const {
+    return _bounds;
+  }
+
+  std::unique_ptr<GeometryProcessor> getGeometryProcessor(const DrawArgs& args) override;
+
+  std::vector<float> vertices(const DrawArgs& args) override;
+
+  std::shared_ptr<GLBuffer> getIndexBuffer(const DrawArgs& args) override;
+
+  unsigned primitiveType() const override;
+
+ private:
+  std::vector<Point> points = {};
+  Rect _bounds = Rect::MakeEmpty();
+
+  explicit GLTriangulatingPathOp(std::vector<Point> points);
+
+  std::vector<float> coverageVertices() const;
+};
+}  // namespace tgfx
@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "GLUtil.h"
+#include "core/Bitmap.h"
 
 namespace tgfx {
 GLVersion GetGLVersion(const char* versionString) {
@@ -147,6 +148,36 @@ void SubmitGLTexture(const GLInterface* gl, const GLSampler& sampler, int width,
   gl->bindTexture(sampler.target, 0);
 }
 
+void UpdateGLTexture(const GLInterface* gl, const GLSampler& sampler, int width, int height,
+                     size_t rowBytes, int bytesPerPixel, void* pixels) {
+  if (pixels == nullptr || rowBytes == 0) {
+    return;
+  }
+  const auto& format = gl->caps->getTextureFormat(sampler.format);
+  gl->bindTexture(sampler.target, sampler.id);
+  gl->pixelStorei(GL_UNPACK_ALIGNMENT, bytesPerPixel);
+  auto trimRowBytes = static_cast<size_t>(width) * bytesPerPixel;
+  if (gl->caps->unpackRowLengthSupport) {
+    // the number of pixels, not bytes
+    gl->pixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<int>(rowBytes / bytesPerPixel));
+    gl->texSubImage2D(sampler.target, 0, 0, 0, width, height, format.externalFormat,
+                      GL_UNSIGNED_BYTE, pixels);
+  } else if (trimRowBytes == rowBytes) {
+    gl->texSubImage2D(sampler.target, 0, 0, 0, width, height, format.externalFormat,
+                      GL_UNSIGNED_BYTE, pixels);
+  } else {
+    // Packs the rows tightly on the CPU, one upload call is much cheaper than one call per row.
+    auto data = std::make_unique<uint8_t[]>(trimRowBytes * height);
+    auto srcPixels = reinterpret_cast<uint8_t*>(pixels);
+    for (int row = 0; row < height; ++row) {
+      memcpy(data.get() + row * trimRowBytes, srcPixels + row * rowBytes, trimRowBytes);
+    }
+    gl->texSubImage2D(sampler.target, 0, 0, 0, width, height, format.externalFormat,
+                      GL_UNSIGNED_BYTE, data.get());
+  }
+  gl->bindTexture(sampler.target, 0);
+}
+
 unsigned CreateGLProgram(const GLInterface* gl, const std::string& vertex,
                          const std::string& fragment) {
   auto vertexShader = LoadGLShader(gl, GL_VERTEX_SHADER, vertex);
@@ -249,4 +280,25 @@ std::array<float, 9> ToGLTextureMatrix(const Matrix& matrix, int width, int heig
   }
   return ToGLMatrix(result);
 }
+
+void CopyPixels(const ImageInfo& srcInfo, const void* srcPixels, const ImageInfo& dstInfo,
+                void* dstPixels, bool flipY) {
+  auto pixels = srcPixels;
+  uint8_t* tempPixels = nullptr;
+  if (flipY) {
+    tempPixels = new uint8_t[srcInfo.byteSize()];
+    auto rowCount = srcInfo.height();
+    auto rowBytes = srcInfo.rowBytes();
+    auto dst = tempPixels;
+    for (int i = 0; i < rowCount; i++) {
+      auto src = reinterpret_cast<const uint8_t*>(srcPixels) + (rowCount - i - 1) * rowBytes;
+      memcpy(dst, src, rowBytes);
+      dst += rowBytes;
+    }
+    pixels = tempPixels;
+  }
+  Bitmap bitmap(srcInfo, pixels);
+  bitmap.readPixels(dstInfo, dstPixels);
+  delete[] tempPixels;
+}
 }  // namespace tgfx
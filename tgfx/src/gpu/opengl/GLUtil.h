@@ -21,6 +21,7 @@
 #include <array>
 #include <string>
 #include "GLInterface.h"
+#include "core/ImageInfo.h"
 #include "core/ImageOrigin.h"
 #include "core/Matrix.h"
 #include "gpu/opengl/GLContext.h"
@@ -54,6 +55,20 @@ void ActiveGLTexture(const GLInterface* gl, unsigned textureUnit, unsigned targe
 void SubmitGLTexture(const GLInterface* gl, const GLSampler& sampler, int width, int height,
                      size_t rowBytes, int bytesPerPixel, void* pixels);
 
+/**
+ * Replaces the pixels of a texture which has been allocated with the same size by
+ * SubmitGLTexture(). The texture storage is reused rather than reallocated.
+ */
+void UpdateGLTexture(const GLInterface* gl, const GLSampler& sampler, int width, int height,
+                     size_t rowBytes, int bytesPerPixel, void* pixels);
+
+/**
+ * Copies the pixels described by srcInfo to dstPixels with conversion, flips the rows vertically if
+ * flipY is true.
+ */
+void CopyPixels(const ImageInfo& srcInfo, const void* srcPixels, const ImageInfo& dstInfo,
+                void* dstPixels, bool flipY);
+
 std::array<float, 9> ToGLMatrix(const Matrix& matrix);
 std::array<float, 9> ToGLVertexMatrix(const Matrix& matrix, int width, int height,
                                       ImageOrigin origin);
@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "gpu/opengl/GLYUVTexture.h"
+#include "GLTextureUploader.h"
 #include "GLUtil.h"
 #include "core/utils/UniqueID.h"
 
@@ -61,6 +62,8 @@ class GLI420Texture : public GLYUVTexture {
     return YUVPixelFormat::I420;
   }
 
+  bool updateI420(uint8_t* pixelsPlane[3], const int lineSize[3]) override;
+
  protected:
   void computeRecycleKey(BytesKey* recycleKey) const override {
     ComputeRecycleKey(recycleKey, width(), height());
@@ -106,8 +109,9 @@ static std::vector<GLSampler> MakeTexturePlanes(const GLInterface* gl, const YUV
   return texturePlanes;
 }
 
-static void SubmitYUVTexture(const GLInterface* gl, const YUVConfig& yuvConfig,
-                             const GLSampler yuvTextures[]) {
+static void SubmitYUVTexture(Context* context, const YUVConfig& yuvConfig,
+                             const GLSampler yuvTextures[], bool allocated) {
+  auto gl = GLContext::Unwrap(context);
   static constexpr int factor[] = {0, 1, 1};
   for (int index = 0; index < yuvConfig.planeCount; index++) {
     const auto& sampler = yuvTextures[index];
@@ -116,16 +120,17 @@ static void SubmitYUVTexture(const GLInterface* gl, const YUVConfig& yuvConfig,
     auto rowBytes = yuvConfig.rowBytes[index];
     auto bytesPerPixel = yuvConfig.bytesPerPixel[index];
     auto pixels = yuvConfig.pixelsPlane[index];
-    SubmitGLTexture(gl, sampler, w, h, rowBytes, bytesPerPixel, pixels);
+    if (allocated) {
+      GLTextureUploader::Get(context)->writePixels(sampler, w, h, rowBytes, bytesPerPixel,
+                                                   pixels);
+    } else {
+      SubmitGLTexture(gl, sampler, w, h, rowBytes, bytesPerPixel, pixels);
+    }
   }
 }
 
-std::shared_ptr<YUVTexture> YUVTexture::MakeI420(Context* context, YUVColorSpace colorSpace,
-                                                 YUVColorRange colorRange, int width, int height,
-                                                 uint8_t* pixelsPlane[3], const int lineSize[3]) {
-  auto gl = GLContext::Unwrap(context);
-  GLStateGuard stateGuard(context);
-
+static YUVConfig MakeI420Config(YUVColorSpace colorSpace, YUVColorRange colorRange, int width,
+                                int height, uint8_t* pixelsPlane[3], const int lineSize[3]) {
   YUVConfig yuvConfig = YUVConfig(colorSpace, colorRange, width, height, I420_PLANE_COUNT);
   for (int i = 0; i < 3; i++) {
     yuvConfig.pixelsPlane[i] = pixelsPlane[i];
@@ -133,11 +138,36 @@ std::shared_ptr<YUVTexture> YUVTexture::MakeI420(Context* context, YUVColorSpace
     yuvConfig.formats[i] = PixelFormat::GRAY_8;
     yuvConfig.bytesPerPixel[i] = 1;
   }
+  return yuvConfig;
+}
+
+bool YUVTexture::updateI420(uint8_t**, const int*) {
+  return false;
+}
+
+bool GLI420Texture::updateI420(uint8_t* pixelsPlane[3], const int lineSize[3]) {
+  auto context = getContext();
+  GLStateGuard stateGuard(context);
+  auto yuvConfig =
+      MakeI420Config(colorSpace(), colorRange(), width(), height(), pixelsPlane, lineSize);
+  SubmitYUVTexture(context, yuvConfig, &samplers[0], true);
+  return true;
+}
+
+std::shared_ptr<YUVTexture> YUVTexture::MakeI420(Context* context, YUVColorSpace colorSpace,
+                                                 YUVColorRange colorRange, int width, int height,
+                                                 uint8_t* pixelsPlane[3], const int lineSize[3]) {
+  auto gl = GLContext::Unwrap(context);
+  GLStateGuard stateGuard(context);
+
+  auto yuvConfig = MakeI420Config(colorSpace, colorRange, width, height, pixelsPlane, lineSize);
 
   BytesKey recycleKey = {};
   GLI420Texture::ComputeRecycleKey(&recycleKey, width, height);
   auto texture =
       std::static_pointer_cast<GLYUVTexture>(context->resourceCache()->getRecycled(recycleKey));
+  // The storage of a recycled texture has been allocated with the same size.
+  auto allocated = texture != nullptr;
   if (texture == nullptr) {
     auto texturePlanes = MakeTexturePlanes(gl, yuvConfig);
     if (texturePlanes.empty()) {
@@ -148,7 +178,7 @@ std::shared_ptr<YUVTexture> YUVTexture::MakeI420(Context* context, YUVColorSpace
                                                   yuvConfig.width, yuvConfig.height)));
     texture->samplers = texturePlanes;
   }
-  SubmitYUVTexture(gl, yuvConfig, &texture->samplers[0]);
+  SubmitYUVTexture(context, yuvConfig, &texture->samplers[0], allocated);
   return texture;
 }
 
@@ -172,6 +202,8 @@ std::shared_ptr<YUVTexture> YUVTexture::MakeNV12(Context* context, YUVColorSpace
   GLNV12Texture::ComputeRecycleKey(&recycleKey, width, height);
   auto texture =
       std::static_pointer_cast<GLYUVTexture>(context->resourceCache()->getRecycled(recycleKey));
+  // The storage of a recycled texture has been allocated with the same size.
+  auto allocated = texture != nullptr;
   if (texture == nullptr) {
     auto texturePlanes = MakeTexturePlanes(gl, yuvConfig);
     if (texturePlanes.empty()) {
@@ -182,7 +214,7 @@ std::shared_ptr<YUVTexture> YUVTexture::MakeNV12(Context* context, YUVColorSpace
                                                   yuvConfig.width, yuvConfig.height)));
     texture->samplers = texturePlanes;
   }
-  SubmitYUVTexture(gl, yuvConfig, &texture->samplers[0]);
+  SubmitYUVTexture(context, yuvConfig, &texture->samplers[0], allocated);
   return texture;
 }
 